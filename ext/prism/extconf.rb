@@ -16,6 +16,26 @@ if ARGV.delete("--help")
               Enable minimal build.
               You may also set the PRISM_BUILD_MINIMAL environment variable.
 
+          --enable-compact-node-list
+              Enable 32-bit node list sizes and capacities.
+              You may also set the PRISM_COMPACT_NODE_LIST environment variable.
+
+          --enable-exclude-diagnostic-messages
+              Exclude the text of diagnostic messages.
+              You may also set the PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES environment variable.
+
+          --enable-node-stats
+              Enable the Prism.node_stats API.
+              You may also set the PRISM_NODE_STATS environment variable.
+
+          --enable-stats
+              Enable the Prism.parser_stats API.
+              You may also set the PRISM_STATS environment variable.
+
+          --enable-stats-lex-time
+              Also time each token lexed for the Prism.parser_stats API.
+              You may also set the PRISM_STATS_LEX_TIME environment variable.
+
           --help
               Display this message.
 
@@ -27,6 +47,21 @@ if ARGV.delete("--help")
           PRISM_BUILD_MINIMAL
               Equivalent to `--enable-build-minimal` when set, even if nil or blank.
 
+          PRISM_COMPACT_NODE_LIST
+              Equivalent to `--enable-compact-node-list` when set, even if nil or blank.
+
+          PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES
+              Equivalent to `--enable-exclude-diagnostic-messages` when set, even if nil or blank.
+
+          PRISM_NODE_STATS
+              Equivalent to `--enable-node-stats` when set, even if nil or blank.
+
+          PRISM_STATS
+              Equivalent to `--enable-stats` when set, even if nil or blank.
+
+          PRISM_STATS_LEX_TIME
+              Equivalent to `--enable-stats-lex-time` when set, even if nil or blank.
+
   TEXT
   exit!(0)
 end
@@ -104,6 +139,47 @@ if enable_config("build-minimal", ENV["PRISM_BUILD_MINIMAL"] || false)
   append_cflags("-DPRISM_BUILD_MINIMAL")
 end
 
+# If `--enable-compact-node-list` is passed to this script or the
+# `PRISM_COMPACT_NODE_LIST` environment variable is defined, we'll build with
+# the `PRISM_COMPACT_NODE_LIST` macro defined. This stores the size and capacity
+# of node lists as 32-bit integers.
+if enable_config("compact-node-list", ENV["PRISM_COMPACT_NODE_LIST"] || false)
+  append_cflags("-DPRISM_COMPACT_NODE_LIST")
+end
+
+# If `--enable-exclude-diagnostic-messages` is passed to this script or the
+# `PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES` environment variable is defined, we'll
+# build with the `PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES` macro defined. Diagnostics
+# then carry their name in place of their message, as in the smallest wasm
+# profile.
+if enable_config("exclude-diagnostic-messages", ENV["PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES"] || false)
+  append_cflags("-DPRISM_EXCLUDE_DIAGNOSTIC_MESSAGES")
+end
+
+# If `--enable-node-stats` is passed to this script or the `PRISM_NODE_STATS`
+# environment variable is defined, we'll build with the `PRISM_NODE_STATS`
+# macro defined. This exposes Prism.node_stats, which reports the memory used
+# by each type of node in a parsed tree.
+if enable_config("node-stats", ENV["PRISM_NODE_STATS"] || false)
+  append_cflags("-DPRISM_NODE_STATS")
+end
+
+# If `--enable-stats` is passed to this script or the `PRISM_STATS` environment
+# variable is defined, we'll build with the `PRISM_STATS` macro defined. This
+# exposes Prism.parser_stats, which reports the counters and timings gathered
+# by the parser while parsing.
+if enable_config("stats", ENV["PRISM_STATS"] || false)
+  append_cflags("-DPRISM_STATS")
+
+  # If `--enable-stats-lex-time` is passed to this script or the
+  # `PRISM_STATS_LEX_TIME` environment variable is defined, we'll also time
+  # every token that is lexed. This is off by default because it costs two clock
+  # reads per token.
+  if enable_config("stats-lex-time", ENV["PRISM_STATS_LEX_TIME"] || false)
+    append_cflags("-DPRISM_STATS_LEX_TIME")
+  end
+end
+
 # By default, all symbols are hidden in the shared library.
 append_cflags("-fvisibility=hidden")
 
@@ -26,21 +26,30 @@ VALUE rb_cPrismParseResult;
 VALUE rb_cPrismLexResult;
 VALUE rb_cPrismParseLexResult;
 VALUE rb_cPrismStringQuery;
+VALUE rb_cPrismSharedConstantPool;
+VALUE rb_cPrismIncrementalParser;
 VALUE rb_cPrismScope;
 VALUE rb_cPrismCurrentVersionError;
 
 VALUE rb_cPrismDebugEncoding;
 
+ID rb_id_option_attach_comments;
 ID rb_id_option_command_line;
+ID rb_id_option_constant_pool;
+ID rb_id_option_discard_comments;
 ID rb_id_option_encoding;
+ID rb_id_option_error_limit;
 ID rb_id_option_filepath;
 ID rb_id_option_freeze;
 ID rb_id_option_frozen_string_literal;
 ID rb_id_option_line;
 ID rb_id_option_main_script;
+ID rb_id_option_mark_newlines;
 ID rb_id_option_partial_script;
 ID rb_id_option_raise_error;
 ID rb_id_option_scopes;
+ID rb_id_option_source_strings;
+ID rb_id_option_syntax_check;
 ID rb_id_option_version;
 
 ID rb_id_source_for;
@@ -54,6 +63,11 @@ ID rb_id_raise_error_plain;
 ID rb_id_raise_error_style;
 ID rb_id_raise_error_color;
 
+static int prism_encindex_utf_16le;
+static int prism_encindex_utf_16be;
+static int prism_encindex_utf_32le;
+static int prism_encindex_utf_32be;
+
 /******************************************************************************/
 /* Result struct for working with functions that may need to raise errors.    */
 /******************************************************************************/
@@ -104,6 +118,127 @@ check_string(VALUE value) {
     return RSTRING_PTR(value);
 }
 
+/******************************************************************************/
+/* Shared constant pools                                                      */
+/******************************************************************************/
+
+/**
+ * The data that backs an instance of Prism::SharedConstantPool.
+ */
+typedef struct {
+    /** The pool that parsers use as the base of their constant pools. */
+    pm_shared_constant_pool_t *pool;
+
+    /** The frozen array of symbols for the constants, indexed by id - 1. */
+    VALUE symbols;
+
+    /** Whether or not every constant in the pool is ASCII-only. */
+    bool ascii_only;
+} shared_constant_pool_t;
+
+static void
+shared_constant_pool_mark(void *ptr) {
+    rb_gc_mark(((shared_constant_pool_t *) ptr)->symbols);
+}
+
+static void
+shared_constant_pool_free(void *ptr) {
+    shared_constant_pool_t *data = (shared_constant_pool_t *) ptr;
+    if (data->pool != NULL) pm_shared_constant_pool_free(data->pool);
+    xfree(data);
+}
+
+static size_t
+shared_constant_pool_memsize(const void *ptr) {
+    (void) ptr;
+    return sizeof(shared_constant_pool_t);
+}
+
+static const rb_data_type_t shared_constant_pool_type = {
+    "Prism::SharedConstantPool",
+    { shared_constant_pool_mark, shared_constant_pool_free, shared_constant_pool_memsize, },
+    0, 0,
+#ifdef HAVE_RB_EXT_RACTOR_SAFE
+    RUBY_TYPED_FREE_IMMEDIATELY | RUBY_TYPED_FROZEN_SHAREABLE
+#else
+    RUBY_TYPED_FREE_IMMEDIATELY
+#endif
+};
+
+static VALUE
+shared_constant_pool_alloc(VALUE klass) {
+    shared_constant_pool_t *data;
+    VALUE self = TypedData_Make_Struct(klass, shared_constant_pool_t, &shared_constant_pool_type, data);
+    data->symbols = Qnil;
+    return self;
+}
+
+/**
+ * Return the pool backing the given Prism::SharedConstantPool instance, raising
+ * if the value is not one.
+ */
+static const pm_shared_constant_pool_t *
+shared_constant_pool_get(VALUE value) {
+    shared_constant_pool_t *data;
+    TypedData_Get_Struct(value, shared_constant_pool_t, &shared_constant_pool_type, data);
+
+    if (data->pool == NULL) rb_raise(rb_eArgError, "uninitialized shared constant pool");
+    return data->pool;
+}
+
+/**
+ * call-seq:
+ *   compile(symbols) -> nil
+ *
+ * Build the pool that backs this instance from the given unique symbols.
+ */
+static VALUE
+shared_constant_pool_compile(VALUE self, VALUE symbols) {
+    shared_constant_pool_t *data;
+    TypedData_Get_Struct(self, shared_constant_pool_t, &shared_constant_pool_type, data);
+
+    if (data->pool != NULL) rb_raise(rb_eRuntimeError, "shared constant pool already compiled");
+    Check_Type(symbols, T_ARRAY);
+
+    long length = RARRAY_LEN(symbols);
+    for (long index = 0; index < length; index++) {
+        VALUE symbol = RARRAY_AREF(symbols, index);
+        if (!SYMBOL_P(symbol)) rb_raise(rb_eTypeError, "wrong argument type %"PRIsVALUE" (expected Symbol)", rb_obj_class(symbol));
+    }
+
+    pm_shared_constant_pool_t *pool = pm_shared_constant_pool_new();
+    bool ascii_only = true;
+
+    for (long index = 0; index < length; index++) {
+        VALUE name = rb_sym2str(RARRAY_AREF(symbols, index));
+        pm_shared_constant_pool_insert(pool, (const uint8_t *) RSTRING_PTR(name), RSTRING_LEN(name));
+        if (ascii_only && !rb_enc_str_asciionly_p(name)) ascii_only = false;
+    }
+
+    data->pool = pool;
+    data->symbols = rb_ary_freeze(rb_ary_dup(symbols));
+    data->ascii_only = ascii_only;
+    pm_shared_constant_pool_data_set(pool, data);
+
+    return Qnil;
+}
+
+/**
+ * Return the symbols for the constants of the shared constant pool that the
+ * given parser was created with, or nil if it was not created with one or the
+ * symbols would not match the ones interned for source in the given encoding.
+ */
+VALUE
+pm_shared_constant_pool_symbols(const pm_parser_t *parser, rb_encoding *encoding) {
+    const pm_shared_constant_pool_t *pool = pm_parser_shared_constant_pool(parser);
+    if (pool == NULL) return Qnil;
+
+    const shared_constant_pool_t *data = (const shared_constant_pool_t *) pm_shared_constant_pool_data(pool);
+    if (data == NULL || (!data->ascii_only && encoding != rb_utf8_encoding())) return Qnil;
+
+    return data->symbols;
+}
+
 /******************************************************************************/
 /* Building C options from Ruby options                                       */
 /******************************************************************************/
@@ -245,6 +380,8 @@ build_options_i(VALUE key, VALUE value, VALUE argument) {
         }
     } else if (key_id == rb_id_option_scopes) {
         if (!NIL_P(value)) build_options_scopes(options, value);
+    } else if (key_id == rb_id_option_constant_pool) {
+        if (!NIL_P(value)) pm_options_shared_constant_pool_set(options, shared_constant_pool_get(value));
     } else if (key_id == rb_id_option_command_line) {
         if (!NIL_P(value)) {
             const char *string = check_string(value);
@@ -270,6 +407,21 @@ build_options_i(VALUE key, VALUE value, VALUE argument) {
         if (!NIL_P(value)) pm_options_partial_script_set(options, RTEST(value));
     } else if (key_id == rb_id_option_freeze) {
         if (!NIL_P(value)) pm_options_freeze_set(options, RTEST(value));
+    } else if (key_id == rb_id_option_attach_comments) {
+        if (!NIL_P(value)) pm_options_attach_comments_set(options, RTEST(value));
+    } else if (key_id == rb_id_option_mark_newlines) {
+        if (!NIL_P(value)) pm_options_mark_newlines_set(options, RTEST(value));
+    } else if (key_id == rb_id_option_source_strings) {
+        if (!NIL_P(value)) pm_options_source_strings_set(options, RTEST(value));
+    } else if (key_id == rb_id_option_discard_comments) {
+        if (!NIL_P(value)) pm_options_discard_comments_set(options, RTEST(value));
+    } else if (key_id == rb_id_option_error_limit) {
+        if (!NIL_P(value)) {
+            if (NUM2LL(value) < 0) rb_raise(rb_eArgError, "invalid error_limit: %" PRIsVALUE, value);
+            pm_options_error_limit_set(options, NUM2UINT(value));
+        }
+    } else if (key_id == rb_id_option_syntax_check) {
+        if (!NIL_P(value)) pm_options_syntax_check_set(options, RTEST(value));
     } else if (key_id == rb_id_option_raise_error) {
         if (!NIL_P(value)) {
             if (value == Qtrue) {
@@ -576,6 +728,60 @@ dump_file(int argc, VALUE *argv, VALUE self) {
     return result_get(result);
 }
 
+/**
+ * Dump the errors found while parsing the given input to a string.
+ */
+static result_t
+dump_errors_input(const uint8_t *input, size_t input_length, const pm_options_t *options) {
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, input, input_length, options);
+    pm_parse(parser);
+
+    result_t result;
+    pm_buffer_t *buffer = pm_buffer_new();
+
+    if (buffer) {
+        pm_serialize_compact_errors(parser, buffer);
+        result = result_ok(rb_str_new(pm_buffer_value(buffer), pm_buffer_length(buffer)));
+        pm_buffer_free(buffer);
+
+        if (pm_options_freeze(options)) rb_obj_freeze(result.value);
+    } else {
+        result = result_err(rb_exc_new_cstr(rb_eNoMemError, "failed to allocate memory"));
+    }
+
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+
+    return result;
+}
+
+/**
+ * :markup: markdown
+ * call-seq:
+ *   dump_errors(source, **options) -> String
+ *
+ * Parse the given string and dump only the errors that were found to a string,
+ * as a count followed by a compact record of the type, level, line, column,
+ * and length of each error (see docs/serialization.md). Comments are discarded
+ * and the tree is never finished, so this is cheaper than parsing when only the
+ * errors are needed, especially with the `error_limit` option. For supported
+ * options, see Prism.parse.
+ */
+static VALUE
+dump_errors(int argc, VALUE *argv, VALUE self) {
+    pm_options_t *options = pm_options_new();
+    VALUE string = string_options(argc, argv, options);
+
+    pm_options_discard_comments_set(options, true);
+    pm_options_syntax_check_set(options, true);
+
+    result_t result = dump_errors_input((const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options);
+    pm_options_free(options);
+
+    return result_get(result);
+}
+
 #endif
 
 /******************************************************************************/
@@ -801,11 +1007,44 @@ parser_warnings(const pm_parser_t *parser, rb_encoding *encoding, VALUE source,
     return warnings;
 }
 
+/**
+ * Compute where each comment attaches in the given tree and return it as a flat
+ * array of node id, target, and kind triples in the same order as the comments,
+ * or nil if the attach_comments option was not given.
+ */
+static VALUE
+parser_comment_attachments(const pm_parser_t *parser, const pm_node_t *node, const pm_options_t *options, bool freeze) {
+    size_t size = pm_parser_comments_size(parser);
+    if (!pm_options_attach_comments(options) || size == 0) return Qnil;
+
+    size_t length = size * sizeof(pm_comment_attachment_t);
+    pm_comment_attachment_t *attachments = xmalloc(length);
+    pm_parser_comments_attach(parser, node, attachments);
+
+    VALUE comment_attachments = rb_ary_new_capa((long) (size * 3));
+    for (size_t index = 0; index < size; index++) {
+        const pm_comment_attachment_t *attachment = &attachments[index];
+        rb_ary_push(comment_attachments, ULONG2NUM(attachment->node_id));
+        rb_ary_push(comment_attachments, ULONG2NUM(attachment->target));
+        rb_ary_push(comment_attachments, INT2FIX(attachment->kind));
+    }
+
+#ifdef xfree_sized
+    xfree_sized(attachments, length);
+#else
+    xfree(attachments);
+#endif
+
+    if (freeze) rb_obj_freeze(comment_attachments);
+    return comment_attachments;
+}
+
 /**
  * Create a new parse result from the given parser, value, encoding, and source.
+ * If comment attachments were computed, they are passed as an extra argument.
  */
 static VALUE
-parse_result_create(VALUE class, const pm_parser_t *parser, VALUE value, rb_encoding *encoding, VALUE source, bool freeze) {
+parse_result_create(VALUE class, const pm_parser_t *parser, VALUE value, rb_encoding *encoding, VALUE source, VALUE comment_attachments, bool freeze) {
     VALUE result_argv[] = {
         value,
         parser_comments(parser, source, freeze),
@@ -814,10 +1053,11 @@ parse_result_create(VALUE class, const pm_parser_t *parser, VALUE value, rb_enco
         parser_errors(parser, encoding, source, freeze),
         parser_warnings(parser, encoding, source, freeze),
         pm_parser_continuable(parser) ? Qtrue : Qfalse,
-        source
+        source,
+        comment_attachments
     };
 
-    return rb_class_new_instance_freeze(8, result_argv, class, freeze);
+    return rb_class_new_instance_freeze(NIL_P(comment_attachments) ? 8 : 9, result_argv, class, freeze);
 }
 
 /******************************************************************************/
@@ -905,7 +1145,7 @@ parse_lex_input(const uint8_t *input, size_t input_length, const pm_options_t *o
     pm_parser_encoding_changed_callback_set(parser, parse_lex_encoding_changed_callback);
 
     VALUE source_string = rb_str_new((const char *) input, input_length);
-    VALUE offsets = rb_ary_new_capa(pm_parser_line_offsets(parser)->size);
+    VALUE offsets = rb_str_new(NULL, 0);
     VALUE source = rb_funcall(rb_cPrismSource, rb_id_source_for, 3, source_string, LONG2NUM(pm_parser_start_line(parser)), offsets);
 
     parse_lex_data_t parse_lex_data = {
@@ -928,9 +1168,7 @@ parse_lex_input(const uint8_t *input, size_t input_length, const pm_options_t *o
         rb_enc_associate(source_string, encoding);
 
         const pm_line_offset_list_t *line_offsets = pm_parser_line_offsets(parser);
-        for (size_t index = 0; index < line_offsets->size; index++) {
-            rb_ary_store(offsets, (long) index, ULONG2NUM(line_offsets->offsets[index]));
-        }
+        rb_str_cat(offsets, (const char *) line_offsets->offsets, (long) (line_offsets->size * sizeof(uint32_t)));
 
         if (pm_options_freeze(options)) {
             rb_obj_freeze(source_string);
@@ -944,9 +1182,9 @@ parse_lex_input(const uint8_t *input, size_t input_length, const pm_options_t *o
             rb_ary_push(value, pm_ast_new(parser, node, parse_lex_data.encoding, source, pm_options_freeze(options)));
             rb_ary_push(value, parse_lex_data.tokens);
             if (pm_options_freeze(options)) rb_obj_freeze(value);
-            result = result_ok(parse_result_create(rb_cPrismParseLexResult, parser, value, parse_lex_data.encoding, source, pm_options_freeze(options)));
+            result = result_ok(parse_result_create(rb_cPrismParseLexResult, parser, value, parse_lex_data.encoding, source, Qnil, pm_options_freeze(options)));
         } else {
-            result = result_ok(parse_result_create(rb_cPrismLexResult, parser, parse_lex_data.tokens, parse_lex_data.encoding, source, pm_options_freeze(options)));
+            result = result_ok(parse_result_create(rb_cPrismLexResult, parser, parse_lex_data.tokens, parse_lex_data.encoding, source, Qnil, pm_options_freeze(options)));
         }
     }
 
@@ -1018,7 +1256,8 @@ parse_input(const uint8_t *input, size_t input_length, const pm_options_t *optio
         bool freeze = pm_options_freeze(options);
         VALUE source = pm_source_new(parser, encoding, freeze);
         VALUE value = pm_ast_new(parser, node, encoding, source, freeze);
-        result = result_ok(parse_result_create(rb_cPrismParseResult, parser, value, encoding, source, freeze));
+        VALUE comment_attachments = parser_comment_attachments(parser, node, options, freeze);
+        result = result_ok(parse_result_create(rb_cPrismParseResult, parser, value, encoding, source, comment_attachments, freeze));
 
         if (freeze) {
             rb_obj_freeze(source);
@@ -1042,8 +1281,21 @@ parse_input(const uint8_t *input, size_t input_length, const pm_options_t *optio
  * * `command_line` - either nil or a string of the various options that were
  *       set on the command line. Valid values are combinations of "a", "l",
  *       "n", "p", and "x".
+ * * `constant_pool` - a Prism::SharedConstantPool whose names are looked up
+ *       before the parse's own constants, so that the symbols it holds are
+ *       reused instead of being interned again. This should be a shared
+ *       constant pool or nil.
+ * * `discard_comments` - whether or not to skip keeping the comments, so that
+ *       the result has none. Magic comments are still found and applied. This
+ *       has no effect when `attach_comments` is set. This should be a boolean
+ *       or nil.
  * * `encoding` - the encoding of the source being parsed. This should be an
  *       encoding or nil.
+ * * `error_limit` - the number of errors after which to stop parsing, closing
+ *       everything that is still open as if the source ended there and
+ *       returning only that many errors. This is meant for checking syntax,
+ *       since the tree that is returned is cut short. This should be a
+ *       positive integer, or 0 or nil for no limit.
  * * `filepath` - the filepath of the source being parsed. This should be a
  *       string or nil.
  * * `freeze` - whether or not to deeply freeze the AST. This should be a
@@ -1057,6 +1309,9 @@ parse_input(const uint8_t *input, size_t input_length, const pm_options_t *optio
  *       or not shebangs are parsed for additional flags and whether or not the
  *       parser will attempt to find a matching shebang if the first one does
  *       not contain the word "ruby".
+ * * `mark_newlines` - whether or not Node#newline? should be set on the first
+ *       node of each line that would fire a `:line` tracepoint event, loosely
+ *       emulating the behavior of CRuby. This should be a boolean or nil.
  * * `partial_script` - when the file being parsed is considered a "partial"
  *       script, jumps will not be marked as errors if they are not contained
  *       within loops/blocks. This is used in the case that you're parsing a
@@ -1080,6 +1335,16 @@ parse_input(const uint8_t *input, size_t input_length, const pm_options_t *optio
  * * `scopes` - the locals that are in scope surrounding the code that is being
  *       parsed. This should be an array of arrays of symbols or nil. Scopes are
  *       ordered from the outermost scope to the innermost one.
+ * * `source_strings` - whether or not string contents that appear verbatim in
+ *       the source are serialized as an offset and length into the source
+ *       instead of as a copy of their bytes. Only affects Prism::dump, and the
+ *       result must then be loaded with the same source. This should be a
+ *       boolean or nil.
+ * * `syntax_check` - whether or not the source is only being parsed to check
+ *       its syntax, in which case each statement is released once it has been
+ *       checked. Every error and warning is still reported, though not
+ *       always in the same order, but the returned tree is missing statements.
+ *       This should be a boolean or nil.
  * * `version` - the version of Ruby syntax that prism should used to parse Ruby
  *       code. By default prism assumes you want to parse with the latest
  *       version of Ruby syntax (which you can trigger with `nil` or
@@ -1140,6 +1405,194 @@ parse_file(int argc, VALUE *argv, VALUE self) {
     return result_get(result);
 }
 
+/******************************************************************************/
+/* Incremental parsing                                                        */
+/******************************************************************************/
+
+/**
+ * The data that backs an instance of Prism::IncrementalParser.
+ */
+typedef struct {
+    /** The options that every parse is made with. */
+    pm_options_t *options;
+
+    /** The keywords that the options were built from. */
+    VALUE keywords;
+
+    /** The filepath that the options point into, or nil. */
+    VALUE filepath;
+
+    /** The frozen source that was parsed last, which the tree points into. */
+    VALUE source;
+
+    /** The arena that holds the tree. */
+    pm_arena_t *arena;
+
+    /** The parser that parsed the source. */
+    pm_parser_t *parser;
+
+    /** The tree that was returned by the last parse. */
+    pm_node_t *node;
+} incremental_parser_t;
+
+static void
+incremental_parser_mark(void *ptr) {
+    incremental_parser_t *data = (incremental_parser_t *) ptr;
+
+    // The options and the tree point into these strings, so they are marked
+    // without allowing them to move.
+    rb_gc_mark(data->keywords);
+    rb_gc_mark(data->filepath);
+    rb_gc_mark(data->source);
+}
+
+static void
+incremental_parser_free(void *ptr) {
+    incremental_parser_t *data = (incremental_parser_t *) ptr;
+    if (data->parser != NULL) pm_parser_free(data->parser);
+    if (data->arena != NULL) pm_arena_free(data->arena);
+    if (data->options != NULL) pm_options_free(data->options);
+    xfree(data);
+}
+
+static size_t
+incremental_parser_memsize(const void *ptr) {
+    (void) ptr;
+    return sizeof(incremental_parser_t);
+}
+
+static const rb_data_type_t incremental_parser_type = {
+    "Prism::IncrementalParser",
+    { incremental_parser_mark, incremental_parser_free, incremental_parser_memsize, },
+    0, 0,
+    RUBY_TYPED_FREE_IMMEDIATELY
+};
+
+static VALUE
+incremental_parser_alloc(VALUE klass) {
+    incremental_parser_t *data;
+    VALUE self = TypedData_Make_Struct(klass, incremental_parser_t, &incremental_parser_type, data);
+    data->keywords = Qnil;
+    data->filepath = Qnil;
+    data->source = Qnil;
+    return self;
+}
+
+/**
+ * Return the data backing the given Prism::IncrementalParser instance, raising
+ * if it has not parsed anything yet.
+ */
+static incremental_parser_t *
+incremental_parser_get(VALUE self) {
+    incremental_parser_t *data;
+    TypedData_Get_Struct(self, incremental_parser_t, &incremental_parser_type, data);
+
+    if (data->parser == NULL) rb_raise(rb_eArgError, "uninitialized incremental parser");
+    return data;
+}
+
+/**
+ * call-seq:
+ *   setup(source, options) -> nil
+ *
+ * Parse the given frozen source with the given options for the first time.
+ */
+static VALUE
+incremental_parser_setup(VALUE self, VALUE source, VALUE keywords) {
+    incremental_parser_t *data;
+    TypedData_Get_Struct(self, incremental_parser_t, &incremental_parser_type, data);
+
+    if (data->parser != NULL) rb_raise(rb_eRuntimeError, "incremental parser already set up");
+    Check_Type(source, T_STRING);
+    Check_Type(keywords, T_HASH);
+
+    VALUE filepath = rb_hash_lookup(keywords, ID2SYM(rb_id_option_filepath));
+    if (RB_TYPE_P(filepath, T_STRING)) filepath = rb_str_new_frozen(filepath);
+
+    pm_options_t *options = pm_options_new();
+    extract_options(options, filepath, keywords);
+
+    data->options = options;
+    data->keywords = keywords;
+    data->filepath = filepath;
+    data->source = rb_str_new_frozen(source);
+
+    data->arena = pm_arena_new();
+    data->parser = pm_parser_new(data->arena, (const uint8_t *) RSTRING_PTR(data->source), RSTRING_LEN(data->source), options);
+    data->node = pm_parse(data->parser);
+
+    return Qnil;
+}
+
+/**
+ * call-seq:
+ *   update(source, edits) -> Range
+ *
+ * Parse the given source again, which is the previous source with the given
+ * edits applied, and return the range of bytes that were parsed.
+ */
+static VALUE
+incremental_parser_update(VALUE self, VALUE source, VALUE edits) {
+    incremental_parser_t *data = incremental_parser_get(self);
+    Check_Type(source, T_STRING);
+    Check_Type(edits, T_ARRAY);
+
+    long length = RARRAY_LEN(edits);
+    VALUE buffer;
+    pm_edit_t *values = ALLOCV_N(pm_edit_t, buffer, length);
+
+    for (long index = 0; index < length; index++) {
+        VALUE edit = RARRAY_AREF(edits, index);
+        Check_Type(edit, T_ARRAY);
+        if (RARRAY_LEN(edit) != 3) rb_raise(rb_eArgError, "wrong edit length (given %ld, expected 3)", RARRAY_LEN(edit));
+
+        values[index] = (pm_edit_t) {
+            .start = NUM2UINT(RARRAY_AREF(edit, 0)),
+            .old_length = NUM2UINT(RARRAY_AREF(edit, 1)),
+            .new_length = NUM2UINT(RARRAY_AREF(edit, 2))
+        };
+    }
+
+    // The previous source has to stay alive until the reparse is done, since
+    // the parts of the tree that are kept are moved over from it.
+    VALUE frozen = rb_str_new_frozen(source);
+    data->node = pm_reparse(&data->parser, data->arena, data->node, (const uint8_t *) RSTRING_PTR(frozen), RSTRING_LEN(frozen), values, (size_t) length, data->options);
+    data->source = frozen;
+    ALLOCV_END(buffer);
+
+    const pm_location_t *location = pm_parser_reparsed_loc(data->parser);
+    return rb_range_new(UINT2NUM(location->start), UINT2NUM(location->start + location->length), true);
+}
+
+/**
+ * call-seq:
+ *   result -> ParseResult
+ *
+ * Return a ParseResult for the tree from the last parse.
+ */
+static VALUE
+incremental_parser_result(VALUE self) {
+    incremental_parser_t *data = incremental_parser_get(self);
+    pm_parser_t *parser = data->parser;
+
+    result_t result = check_raise_error_option(parser, data->options, NULL);
+    if (result.type == RESULT_OK) {
+        rb_encoding *encoding = rb_enc_find(pm_parser_encoding_name(parser));
+
+        bool freeze = pm_options_freeze(data->options);
+        VALUE source = pm_source_new(parser, encoding, freeze);
+        VALUE value = pm_ast_new(parser, data->node, encoding, source, freeze);
+        VALUE comment_attachments = parser_comment_attachments(parser, data->node, data->options, freeze);
+        result = result_ok(parse_result_create(rb_cPrismParseResult, parser, value, encoding, source, comment_attachments, freeze));
+
+        if (freeze) {
+            rb_obj_freeze(source);
+        }
+    }
+
+    return result_get(result);
+}
+
 /**
  * Parse the given input and return nothing.
  */
@@ -1163,13 +1616,15 @@ profile_input(const uint8_t *input, size_t input_length, const pm_options_t *opt
  *   profile(source, **options) -> nil
  *
  * Parse the given string and return nothing. This method is meant to allow
- * profilers to avoid the overhead of reifying the AST to Ruby. For supported
- * options, see Prism.parse.
+ * profilers to avoid the overhead of reifying the AST to Ruby, so comments are
+ * discarded as with the `discard_comments` option. For supported options, see
+ * Prism.parse.
  */
 static VALUE
 profile(int argc, VALUE *argv, VALUE self) {
     pm_options_t *options = pm_options_new();
     VALUE string = string_options(argc, argv, options);
+    pm_options_discard_comments_set(options, true);
 
     result_t result = profile_input((const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options, NULL);
     pm_options_free(options);
@@ -1184,8 +1639,9 @@ profile(int argc, VALUE *argv, VALUE self) {
  *   profile_file(filepath, **options) -> nil
  *
  * Parse the given file and return nothing. This method is meant to allow
- * profilers to avoid the overhead of reifying the AST to Ruby. For supported
- * options, see Prism.parse.
+ * profilers to avoid the overhead of reifying the AST to Ruby, so comments are
+ * discarded as with the `discard_comments` option. For supported options, see
+ * Prism.parse.
  */
 static VALUE
 profile_file(int argc, VALUE *argv, VALUE self) {
@@ -1193,6 +1649,7 @@ profile_file(int argc, VALUE *argv, VALUE self) {
 
     VALUE encoded_filepath;
     pm_source_t *src = file_options(argc, argv, options, &encoded_filepath);
+    pm_options_discard_comments_set(options, true);
 
     result_t result = profile_input(pm_source_source(src), pm_source_length(src), options, rb_enc_get(encoded_filepath));
     pm_source_free(src);
@@ -1202,6 +1659,119 @@ profile_file(int argc, VALUE *argv, VALUE self) {
     return Qnil;
 }
 
+#ifdef PRISM_NODE_STATS
+
+/**
+ * :markup: markdown
+ * call-seq:
+ *   node_stats(source, **options) -> Hash
+ *
+ * Parse the given string and return a hash of statistics about the memory used
+ * by the resulting tree, keyed by node type. Each value is a hash with the
+ * `count`, `bytes`, `list_bytes`, and `compact_bytes` keys. This method is only
+ * available when prism is compiled with `PRISM_NODE_STATS`. For supported
+ * options, see Prism.parse.
+ */
+static VALUE
+node_stats(int argc, VALUE *argv, VALUE self) {
+    pm_options_t *options = pm_options_new();
+    VALUE string = string_options(argc, argv, options);
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, (const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options);
+
+    pm_node_stats_t stats = { 0 };
+    pm_node_stats(pm_parse(parser), &stats);
+
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+    pm_options_free(options);
+
+    VALUE result = rb_hash_new();
+    for (size_t type = 0; type < PM_SCOPE_NODE; type++) {
+        const pm_node_stats_entry_t *entry = &stats.entries[type];
+        if (entry->count == 0) continue;
+
+        VALUE value = rb_hash_new();
+        rb_hash_aset(value, ID2SYM(rb_intern("count")), SIZET2NUM(entry->count));
+        rb_hash_aset(value, ID2SYM(rb_intern("bytes")), SIZET2NUM(entry->bytes));
+        rb_hash_aset(value, ID2SYM(rb_intern("list_bytes")), SIZET2NUM(entry->list_bytes));
+        rb_hash_aset(value, ID2SYM(rb_intern("compact_bytes")), SIZET2NUM(entry->compact_bytes));
+
+        rb_hash_aset(result, ID2SYM(rb_intern(pm_node_type((pm_node_type_t) type))), value);
+    }
+
+    return result;
+}
+
+#endif
+
+#ifdef PRISM_STATS
+
+/**
+ * :markup: markdown
+ * call-seq:
+ *   parser_stats(source, **options) -> Hash
+ *
+ * Parse the given string and return a hash of the counters and timings that
+ * the parser gathered while parsing it. The `tokens` key holds a hash of the
+ * number of tokens lexed keyed by token type, the `lex_time` and `parse_time`
+ * keys hold nanoseconds (`lex_time` is only gathered when prism is also
+ * compiled with `PRISM_STATS_LEX_TIME`), and the remaining keys hold the
+ * counters described by `pm_parser_stats_t`. This method is only available when prism is compiled
+ * with `PRISM_STATS`. For supported options, see Prism.parse.
+ */
+static VALUE
+parser_stats(int argc, VALUE *argv, VALUE self) {
+    pm_options_t *options = pm_options_new();
+    VALUE string = string_options(argc, argv, options);
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, (const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options);
+    pm_parse(parser);
+
+    pm_parser_stats_t stats;
+    pm_parser_stats(parser, &stats);
+
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+    pm_options_free(options);
+
+    VALUE tokens = rb_hash_new();
+    for (size_t type = 0; type < PM_TOKEN_MAXIMUM; type++) {
+        if (stats.tokens[type] == 0) continue;
+        rb_hash_aset(tokens, ID2SYM(rb_intern(pm_token_type((pm_token_type_t) type))), SIZET2NUM(stats.tokens[type]));
+    }
+
+    VALUE result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("tokens")), tokens);
+    rb_hash_aset(result, ID2SYM(rb_intern("lex_time")), ULL2NUM(stats.lex_time));
+    rb_hash_aset(result, ID2SYM(rb_intern("parse_time")), ULL2NUM(stats.parse_time));
+
+#define PARSER_STATS_SET(field) rb_hash_aset(result, ID2SYM(rb_intern(#field)), SIZET2NUM(stats.field))
+    PARSER_STATS_SET(lex_mode_pushes);
+    PARSER_STATS_SET(heredocs);
+    PARSER_STATS_SET(ast_arena_blocks);
+    PARSER_STATS_SET(ast_arena_bytes);
+    PARSER_STATS_SET(metadata_arena_blocks);
+    PARSER_STATS_SET(metadata_arena_bytes);
+    PARSER_STATS_SET(constant_inserts);
+    PARSER_STATS_SET(constant_collisions);
+    PARSER_STATS_SET(constant_resizes);
+    PARSER_STATS_SET(strpbrk_calls);
+    PARSER_STATS_SET(strpbrk_accelerated);
+    PARSER_STATS_SET(regexp_validations);
+    PARSER_STATS_SET(errors);
+    PARSER_STATS_SET(warnings);
+    PARSER_STATS_SET(error_recovery_nodes);
+    PARSER_STATS_SET(recoveries);
+#undef PARSER_STATS_SET
+
+    return result;
+}
+
+#endif
+
 static int
 parse_stream_eof(void *stream) {
     if (rb_funcall((VALUE) stream, rb_intern("eof?"), 0)) {
@@ -1298,7 +1868,8 @@ parse_stream(int argc, VALUE *argv, VALUE self) {
 
         VALUE source = pm_source_new(parser, encoding, pm_options_freeze(options));
         VALUE value = pm_ast_new(parser, node, encoding, source, pm_options_freeze(options));
-        result = result_ok(parse_result_create(rb_cPrismParseResult, parser, value, encoding, source, pm_options_freeze(options)));
+        VALUE comment_attachments = parser_comment_attachments(parser, node, options, pm_options_freeze(options));
+        result = result_ok(parse_result_create(rb_cPrismParseResult, parser, value, encoding, source, comment_attachments, pm_options_freeze(options)));
     }
 
     pm_source_free(src);
@@ -1454,13 +2025,17 @@ parse_input_success_p(const uint8_t *input, size_t input_length, const pm_option
  * call-seq:
  *   parse_success?(source, **options) -> bool
  *
- * Parse the given string and return true if it parses without errors. For
- * supported options, see Prism.parse.
+ * Parse the given string and return true if it parses without errors. Comments
+ * are discarded as with the `discard_comments` option, and only the syntax is
+ * checked as with the `syntax_check` option. For supported options, see
+ * Prism.parse.
  */
 static VALUE
 parse_success_p(int argc, VALUE *argv, VALUE self) {
     pm_options_t *options = pm_options_new();
     VALUE string = string_options(argc, argv, options);
+    pm_options_discard_comments_set(options, true);
+    pm_options_syntax_check_set(options, true);
 
     result_t result = parse_input_success_p((const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options, NULL);
     pm_options_free(options);
@@ -1486,8 +2061,10 @@ parse_failure_p(int argc, VALUE *argv, VALUE self) {
  * call-seq:
  *   parse_file_success?(filepath, **options) -> bool
  *
- * Parse the given file and return true if it parses without errors. For
- * supported options, see Prism.parse.
+ * Parse the given file and return true if it parses without errors. Comments
+ * are discarded as with the `discard_comments` option, and only the syntax is
+ * checked as with the `syntax_check` option. For supported options, see
+ * Prism.parse.
  */
 static VALUE
 parse_file_success_p(int argc, VALUE *argv, VALUE self) {
@@ -1495,6 +2072,8 @@ parse_file_success_p(int argc, VALUE *argv, VALUE self) {
 
     VALUE encoded_filepath;
     pm_source_t *src = file_options(argc, argv, options, &encoded_filepath);
+    pm_options_discard_comments_set(options, true);
+    pm_options_syntax_check_set(options, true);
 
     result_t result = parse_input_success_p(pm_source_source(src), pm_source_length(src), options, rb_enc_get(encoded_filepath));
     pm_source_free(src);
@@ -1517,25 +2096,671 @@ parse_file_failure_p(int argc, VALUE *argv, VALUE self) {
 }
 
 /******************************************************************************/
-/* String query methods                                                       */
+/* Scanning Ruby code for patterns                                            */
 /******************************************************************************/
 
 /**
- * Process the result of a call to a string query method and return an
- * appropriate value.
+ * The nodes that were found by pm_pattern_scan, along with whether each of them
+ * still needs to be checked by the Ruby matcher.
  */
-static VALUE
-string_query(pm_string_query_t result) {
-    switch (result) {
-        case PM_STRING_QUERY_ERROR:
-            rb_raise(rb_eArgError, "Invalid or non ascii-compatible encoding");
-            return Qfalse;
-        case PM_STRING_QUERY_FALSE:
-            return Qfalse;
-        case PM_STRING_QUERY_TRUE:
-            return Qtrue;
-    }
-    return Qfalse;
+typedef struct {
+    const pm_node_t **nodes;
+    bool *maybes;
+    size_t size;
+    size_t capacity;
+} scan_matches_t;
+
+/**
+ * The callback for pm_pattern_scan that collects each of the matching nodes.
+ */
+static void
+scan_matches_push(const pm_node_t *node, pm_pattern_match_t match, void *data) {
+    scan_matches_t *matches = (scan_matches_t *) data;
+
+    if (matches->size == matches->capacity) {
+        size_t capacity = matches->capacity == 0 ? 16 : matches->capacity * 2;
+
+        matches->nodes = xrealloc(matches->nodes, sizeof(const pm_node_t *) * capacity);
+        matches->maybes = xrealloc(matches->maybes, sizeof(bool) * capacity);
+        matches->capacity = capacity;
+    }
+
+    matches->nodes[matches->size] = node;
+    matches->maybes[matches->size] = (match == PM_PATTERN_MATCH_MAYBE);
+    matches->size++;
+}
+
+/**
+ * Free the memory held by the given matches.
+ */
+static void
+scan_matches_free(scan_matches_t *matches) {
+    if (matches->capacity == 0) return;
+
+#ifdef xfree_sized
+    xfree_sized(matches->nodes, sizeof(const pm_node_t *) * matches->capacity);
+    xfree_sized(matches->maybes, sizeof(bool) * matches->capacity);
+#else
+    xfree(matches->nodes);
+    xfree(matches->maybes);
+#endif
+}
+
+/**
+ * Compile the given Prism::Pattern into a Ruby matcher. This is wrapped with
+ * rb_protect so that the native pattern can be freed if it raises.
+ */
+static VALUE
+scan_pattern_compile(VALUE pattern) {
+    return rb_funcall(pattern, rb_intern("compile"), 0);
+}
+
+/**
+ * :markup: markdown
+ * call-seq:
+ *   scan(source, pattern, **options) -> Array
+ *
+ * Parse the given string and return the nodes within it that match the given
+ * pattern, in the same order as Prism::Pattern#scan. The pattern can be either
+ * a Prism::Pattern or a query string that would be given to one.
+ *
+ * The pattern is compiled and matched natively, so only the nodes that match
+ * (and the nodes beneath them) are created as Ruby objects. Parts of the
+ * pattern that cannot be decided natively (regular expressions, constants that
+ * are not node classes, and fields that are not nodes, names, or strings) are
+ * checked with the Ruby matcher instead. For supported options, see
+ * Prism.parse.
+ */
+static VALUE
+scan(int argc, VALUE *argv, VALUE self) {
+    VALUE string;
+    VALUE pattern;
+    VALUE keywords;
+    rb_scan_args(argc, argv, "2:", &string, &pattern, &keywords);
+
+    check_string(string);
+
+    VALUE rb_cPrismPattern = rb_const_get_at(rb_cPrism, rb_intern("Pattern"));
+    if (RB_TYPE_P(pattern, T_STRING)) {
+        pattern = rb_class_new_instance(1, &pattern, rb_cPrismPattern);
+    } else if (!rb_obj_is_kind_of(pattern, rb_cPrismPattern)) {
+        rb_raise(rb_eTypeError, "wrong argument type %"PRIsVALUE" (expected String or Prism::Pattern)", rb_obj_class(pattern));
+    }
+
+    VALUE query = rb_funcall(pattern, rb_intern("query"), 0);
+    check_string(query);
+
+    pm_options_t *options = pm_options_new();
+    extract_options(options, Qnil, keywords);
+
+    // If the pattern cannot be compiled natively, then the Ruby matcher will
+    // raise the appropriate compilation error.
+    pm_pattern_t *compiled = pm_pattern_new((const uint8_t *) RSTRING_PTR(query), RSTRING_LEN(query));
+    if (compiled == NULL) {
+        pm_options_free(options);
+        scan_pattern_compile(pattern);
+        rb_raise(rb_eArgError, "unsupported pattern: %"PRIsVALUE, query);
+    }
+
+    // If the pattern refers to constants that are not node classes, compile
+    // the Ruby matcher up front so that unknown constants raise even if
+    // nothing ends up needing to be checked.
+    VALUE matcher = Qnil;
+    if (!pm_pattern_complete(compiled)) {
+        int state = 0;
+        matcher = rb_protect(scan_pattern_compile, pattern, &state);
+
+        if (state != 0) {
+            pm_pattern_free(compiled);
+            pm_options_free(options);
+            rb_jump_tag(state);
+        }
+    }
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, (const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options);
+    pm_node_t *node = pm_parse(parser);
+
+    result_t result = check_raise_error_option(parser, options, NULL);
+    VALUE candidates = Qnil;
+    VALUE maybes = Qnil;
+
+    if (result.type == RESULT_OK) {
+        scan_matches_t matches = { 0 };
+        pm_pattern_scan(compiled, parser, node, scan_matches_push, &matches);
+
+        if (matches.size > 0) {
+            rb_encoding *encoding = rb_enc_find(pm_parser_encoding_name(parser));
+            bool freeze = pm_options_freeze(options);
+
+            VALUE source = pm_source_new(parser, encoding, freeze);
+            candidates = pm_ast_nodes_new(parser, matches.nodes, matches.size, encoding, source, freeze);
+
+            maybes = rb_ary_new_capa((long) matches.size);
+            for (size_t index = 0; index < matches.size; index++) {
+                rb_ary_push(maybes, matches.maybes[index] ? Qtrue : Qfalse);
+            }
+        }
+
+        scan_matches_free(&matches);
+    }
+
+    bool freeze = pm_options_freeze(options);
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+    pm_pattern_free(compiled);
+    pm_options_free(options);
+    result_get(result);
+
+    VALUE value = rb_ary_new();
+    if (!NIL_P(candidates)) {
+        for (long index = 0; index < RARRAY_LEN(candidates); index++) {
+            VALUE candidate = RARRAY_AREF(candidates, index);
+
+            if (RTEST(RARRAY_AREF(maybes, index))) {
+                if (NIL_P(matcher)) matcher = scan_pattern_compile(pattern);
+                if (!RTEST(rb_funcall(matcher, rb_intern("call"), 1, candidate))) continue;
+            }
+
+            rb_ary_push(value, candidate);
+        }
+    }
+
+    if (freeze) rb_obj_freeze(value);
+    return value;
+}
+
+/******************************************************************************/
+/* Dispatching events for nodes of certain types                              */
+/******************************************************************************/
+
+/**
+ * The nodes of the subscribed types that were found while walking the tree, in
+ * pre-order, along with the enter and leave events for them. Each event is the
+ * index of the node shifted left once, with the low bit set for leave events.
+ */
+typedef struct {
+    const bool *types;
+    const pm_node_t **nodes;
+    size_t nodes_size;
+    size_t nodes_capacity;
+    size_t *events;
+    size_t events_size;
+    size_t events_capacity;
+} parse_events_t;
+
+/**
+ * Append an event for the node at the given index.
+ */
+static void
+parse_events_push(parse_events_t *events, size_t index, bool leave) {
+    if (events->events_size == events->events_capacity) {
+        events->events_capacity = events->events_capacity == 0 ? 32 : events->events_capacity * 2;
+        events->events = xrealloc(events->events, sizeof(size_t) * events->events_capacity);
+    }
+
+    events->events[events->events_size++] = (index << 1) | (leave ? 1 : 0);
+}
+
+/**
+ * The visitor callback that records the enter and leave events for each node of
+ * a subscribed type. It walks the children itself so that it knows when each
+ * node is left.
+ */
+static bool
+parse_events_visit(const pm_node_t *node, void *data) {
+    parse_events_t *events = (parse_events_t *) data;
+    bool subscribed = events->types[PM_NODE_TYPE(node)];
+    size_t index = events->nodes_size;
+
+    if (subscribed) {
+        if (events->nodes_size == events->nodes_capacity) {
+            events->nodes_capacity = events->nodes_capacity == 0 ? 16 : events->nodes_capacity * 2;
+            events->nodes = xrealloc(events->nodes, sizeof(const pm_node_t *) * events->nodes_capacity);
+        }
+
+        events->nodes[events->nodes_size++] = node;
+        parse_events_push(events, index, false);
+    }
+
+    pm_visit_child_nodes(node, parse_events_visit, data);
+    if (subscribed) parse_events_push(events, index, true);
+
+    return false;
+}
+
+/**
+ * Free the memory held by the given events.
+ */
+static void
+parse_events_free(parse_events_t *events) {
+    if (events->nodes_capacity > 0) {
+#ifdef xfree_sized
+        xfree_sized(events->nodes, sizeof(const pm_node_t *) * events->nodes_capacity);
+#else
+        xfree(events->nodes);
+#endif
+    }
+
+    if (events->events_capacity > 0) {
+#ifdef xfree_sized
+        xfree_sized(events->events, sizeof(size_t) * events->events_capacity);
+#else
+        xfree(events->events);
+#endif
+    }
+}
+
+/**
+ * :markup: markdown
+ * call-seq:
+ *   parse_events(source, types, **options) -> Array
+ *
+ * Parse the given string and walk the resulting tree in pre-order, returning a
+ * flat array of node and boolean pairs for each node whose type is in the given
+ * array of node class names (like `:CallNode`). The boolean is true when the
+ * node is entered and false when it is left. Only those nodes (and the nodes
+ * beneath them) are created as Ruby objects. This is what powers
+ * Prism::Dispatcher#dispatch_source. For supported options, see Prism.parse.
+ */
+static VALUE
+parse_events(int argc, VALUE *argv, VALUE self) {
+    VALUE string;
+    VALUE types;
+    VALUE keywords;
+    rb_scan_args(argc, argv, "2:", &string, &types, &keywords);
+
+    check_string(string);
+    Check_Type(types, T_ARRAY);
+
+    bool subscribed[PM_SCOPE_NODE + 1] = { 0 };
+    for (long index = 0; index < RARRAY_LEN(types); index++) {
+        VALUE name = RARRAY_AREF(types, index);
+        Check_Type(name, T_SYMBOL);
+
+        VALUE name_string = rb_sym2str(name);
+        pm_node_type_t type = pm_node_type_find((const uint8_t *) RSTRING_PTR(name_string), RSTRING_LEN(name_string));
+        if (type == 0) rb_raise(rb_eArgError, "unknown node type: %"PRIsVALUE, name);
+
+        subscribed[type] = true;
+    }
+
+    pm_options_t *options = pm_options_new();
+    extract_options(options, Qnil, keywords);
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, (const uint8_t *) RSTRING_PTR(string), RSTRING_LEN(string), options);
+    pm_node_t *node = pm_parse(parser);
+
+    result_t result = check_raise_error_option(parser, options, NULL);
+    bool freeze = pm_options_freeze(options);
+    VALUE value = rb_ary_new();
+
+    if (result.type == RESULT_OK) {
+        parse_events_t events = { .types = subscribed };
+        pm_visit_node(node, parse_events_visit, &events);
+
+        if (events.nodes_size > 0) {
+            rb_encoding *encoding = rb_enc_find(pm_parser_encoding_name(parser));
+            VALUE source = pm_source_new(parser, encoding, freeze);
+            VALUE nodes = pm_ast_nodes_new(parser, events.nodes, events.nodes_size, encoding, source, freeze);
+
+            for (size_t index = 0; index < events.events_size; index++) {
+                size_t event = events.events[index];
+                rb_ary_push(value, RARRAY_AREF(nodes, (long) (event >> 1)));
+                rb_ary_push(value, (event & 1) ? Qfalse : Qtrue);
+            }
+        }
+
+        parse_events_free(&events);
+    }
+
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+    pm_options_free(options);
+    result_get(result);
+
+    if (freeze) rb_obj_freeze(value);
+    return value;
+}
+
+/******************************************************************************/
+/* Source methods                                                             */
+/******************************************************************************/
+
+/**
+ * The units that can be counted by the source methods.
+ */
+typedef enum {
+    /** Count characters in the encoding of the source. */
+    SOURCE_UNIT_CHARACTER,
+
+    /** Count UTF-16 code units, for sources that are encoded as UTF-8. */
+    SOURCE_UNIT_UTF_16,
+
+    /** The units cannot be counted natively. */
+    SOURCE_UNIT_UNSUPPORTED
+} source_unit_t;
+
+/**
+ * Determine the units to count in the given source for the given target
+ * encoding. A nil encoding means characters in the encoding of the source.
+ * Counting UTF-16 or UTF-32 code units without transcoding is only possible if
+ * the source is encoded as UTF-8, in which case UTF-32 code units are the same
+ * as characters and UTF-16 code units are one per character except for the
+ * characters outside the basic multilingual plane, which are two.
+ */
+static source_unit_t
+source_unit(VALUE source, VALUE encoding) {
+    if (!rb_enc_asciicompat(rb_enc_get(source))) return SOURCE_UNIT_UNSUPPORTED;
+    if (NIL_P(encoding)) return SOURCE_UNIT_CHARACTER;
+    if (rb_enc_get_index(source) != rb_utf8_encindex()) return SOURCE_UNIT_UNSUPPORTED;
+
+    int index = rb_to_encoding_index(encoding);
+    if (index == prism_encindex_utf_16le || index == prism_encindex_utf_16be) return SOURCE_UNIT_UTF_16;
+    if (index == prism_encindex_utf_32le || index == prism_encindex_utf_32be) return SOURCE_UNIT_CHARACTER;
+    return SOURCE_UNIT_UNSUPPORTED;
+}
+
+/**
+ * Add the number of units between start and end to the given count. Returns
+ * false if the range contains an invalid or incomplete character, since the
+ * number of replacement characters that transcoding produces for those is left
+ * to Ruby.
+ */
+static bool
+source_count(const char *start, const char *end, rb_encoding *encoding, source_unit_t unit, size_t *count) {
+    size_t result = *count;
+
+    while (start < end) {
+        if (((unsigned char) *start) < 0x80) {
+            start++;
+            result++;
+            continue;
+        }
+
+        int length = rb_enc_precise_mbclen(start, end, encoding);
+        if (!MBCLEN_CHARFOUND_P(length)) return false;
+
+        length = MBCLEN_CHARFOUND_LEN(length);
+        start += length;
+        result += (unit == SOURCE_UNIT_UTF_16 && length == 4) ? 2 : 1;
+    }
+
+    *count = result;
+    return true;
+}
+
+/**
+ * Returns the uint32_t line offsets packed into the given string, along with
+ * the number of offsets. The values are read in place, so this raises an
+ * ArgumentError unless the string holds a whole number of aligned values.
+ */
+static const uint32_t *
+source_offsets(VALUE offsets, size_t *size) {
+    Check_Type(offsets, T_STRING);
+
+    const char *pointer = RSTRING_PTR(offsets);
+    size_t length = (size_t) RSTRING_LEN(offsets);
+
+    if ((length % sizeof(uint32_t)) != 0 || (((uintptr_t) pointer) % sizeof(uint32_t)) != 0) {
+        rb_raise(rb_eArgError, "invalid packed offsets");
+    }
+
+    *size = length / sizeof(uint32_t);
+    return (const uint32_t *) pointer;
+}
+
+/**
+ * Returns the index of the line that contains the given byte offset, or -1 if
+ * the byte offset precedes the first line.
+ */
+static long
+source_find_line(const uint32_t *offsets, size_t size, long byte_offset) {
+    if (size == 0 || byte_offset < (long) offsets[0]) return -1;
+
+    const pm_line_offset_list_t list = { .size = size, .capacity = size, .offsets = (uint32_t *) offsets };
+    uint32_t cursor = byte_offset > (long) UINT32_MAX ? UINT32_MAX : (uint32_t) byte_offset;
+
+    return (long) pm_line_offset_list_line_column(&list, cursor, 0).line;
+}
+
+/**
+ * call-seq:
+ *   Source::find_line(offsets, byte_offset) -> Integer
+ *
+ * Binary search through the packed line offsets to find the index of the line
+ * that contains the given byte offset.
+ *
+ * :nodoc:
+ */
+static VALUE
+source_find_line_m(VALUE self, VALUE offsets, VALUE byte_offset) {
+    size_t size;
+    const uint32_t *values = source_offsets(offsets, &size);
+    return LONG2NUM(source_find_line(values, size, NUM2LONG(byte_offset)));
+}
+
+/**
+ * call-seq:
+ *   Source::line_column(offsets, byte_offset) -> Integer or nil
+ *
+ * Binary search through the packed line offsets to find both the index of the
+ * line that contains the given byte offset and the column in bytes, packed into
+ * a single Integer as (index << 32) | column. Returns nil if the byte offset
+ * precedes the first line.
+ *
+ * :nodoc:
+ */
+static VALUE
+source_line_column_m(VALUE self, VALUE offsets, VALUE byte_offset) {
+    size_t size;
+    const uint32_t *values = source_offsets(offsets, &size);
+
+    long value = NUM2LONG(byte_offset);
+    long index = source_find_line(values, size, value);
+    if (index < 0) return Qnil;
+
+    return ULL2NUM((((unsigned long long) index) << 32) | ((unsigned long long) (value - (long) values[index])));
+}
+
+/**
+ * call-seq:
+ *   Source::line_offset(offsets, index) -> Integer or nil
+ *
+ * Returns the byte offset of the start of the line at the given index in the
+ * packed line offsets, with the same semantics as Array#[].
+ *
+ * :nodoc:
+ */
+static VALUE
+source_line_offset_m(VALUE self, VALUE offsets, VALUE index) {
+    size_t size;
+    const uint32_t *values = source_offsets(offsets, &size);
+
+    long value = NUM2LONG(index);
+    if (value < 0) value += (long) size;
+    if (value < 0 || ((size_t) value) >= size) return Qnil;
+
+    return ULONG2NUM(values[value]);
+}
+
+/**
+ * call-seq:
+ *   Source::code_units_table(source, offsets, encoding) -> String or nil
+ *
+ * Returns a packed string of uint32_t values holding the offset in code units
+ * of the start of every line, or nil if they cannot be counted natively. A nil
+ * encoding counts characters in the encoding of the source.
+ *
+ * :nodoc:
+ */
+static VALUE
+source_code_units_table_m(VALUE self, VALUE source, VALUE offsets, VALUE encoding) {
+    Check_Type(source, T_STRING);
+    source_unit_t unit = source_unit(source, encoding);
+    if (unit == SOURCE_UNIT_UNSUPPORTED) return Qnil;
+
+    size_t size;
+    const uint32_t *values = source_offsets(offsets, &size);
+
+    VALUE table = rb_str_new(NULL, (long) (size * sizeof(uint32_t)));
+    uint32_t *entries = (uint32_t *) RSTRING_PTR(table);
+
+    const char *start = RSTRING_PTR(source);
+    size_t length = (size_t) RSTRING_LEN(source);
+    rb_encoding *source_encoding = rb_enc_get(source);
+
+    size_t previous = 0;
+    size_t count = 0;
+
+    for (size_t index = 0; index < size; index++) {
+        size_t offset = values[index];
+        if (offset < previous || offset > length) return Qnil;
+        if (!source_count(start + previous, start + offset, source_encoding, unit, &count)) return Qnil;
+
+        entries[index] = (uint32_t) count;
+        previous = offset;
+    }
+
+    return table;
+}
+
+/**
+ * call-seq:
+ *   Source::code_units_offset(source, offsets, table, byte_offset, encoding) -> Integer or nil
+ *
+ * Returns the offset in code units of the given byte offset, or nil if it
+ * cannot be counted natively. If a table from Source::code_units_table is
+ * given, this only counts from the start of the line that contains the byte
+ * offset. Otherwise it counts from the start of the source.
+ *
+ * :nodoc:
+ */
+static VALUE
+source_code_units_offset_m(VALUE self, VALUE source, VALUE offsets, VALUE table, VALUE byte_offset, VALUE encoding) {
+    Check_Type(source, T_STRING);
+    source_unit_t unit = source_unit(source, encoding);
+    if (unit == SOURCE_UNIT_UNSUPPORTED) return Qnil;
+
+    long value = NUM2LONG(byte_offset);
+    if (value < 0 || value > RSTRING_LEN(source)) return Qnil;
+
+    size_t start = 0;
+    size_t count = 0;
+
+    if (!NIL_P(table)) {
+        size_t size;
+        const uint32_t *values = source_offsets(offsets, &size);
+
+        size_t entries_size;
+        const uint32_t *entries = source_offsets(table, &entries_size);
+        if (entries_size != size) return Qnil;
+
+        long index = source_find_line(values, size, value);
+        if (index < 0) return Qnil;
+
+        start = values[index];
+        count = entries[index];
+        if (start > (size_t) value) return Qnil;
+    }
+
+    const char *pointer = RSTRING_PTR(source);
+    if (!source_count(pointer + start, pointer + value, rb_enc_get(source), unit, &count)) return Qnil;
+
+    return SIZET2NUM(count);
+}
+
+/**
+ * call-seq:
+ *   Source::character_offsets(source) -> Array
+ *
+ * Returns an array that maps every byte offset in the given source, including
+ * the offset of its end, to the corresponding character offset. Every byte of a
+ * multibyte character maps to the offset of that character, and invalid bytes
+ * count as characters in the same way as they do for String#each_char.
+ *
+ * :nodoc:
+ */
+static VALUE
+source_character_offsets_m(VALUE self, VALUE source) {
+    Check_Type(source, T_STRING);
+
+    long length = RSTRING_LEN(source);
+    VALUE offsets = rb_ary_new_capa(length + 1);
+
+    const char *cursor = RSTRING_PTR(source);
+    const char *end = cursor + length;
+    rb_encoding *encoding = rb_enc_get(source);
+    long character = 0;
+
+    while (cursor < end) {
+        int width = rb_enc_mbclen(cursor, end, encoding);
+        for (int index = 0; index < width; index++) rb_ary_push(offsets, LONG2FIX(character));
+
+        cursor += width;
+        character++;
+    }
+
+    rb_ary_push(offsets, LONG2FIX(character));
+    return offsets;
+}
+
+/**
+ * call-seq:
+ *   Source::newline_count(source) -> Integer
+ *
+ * Returns the number of line feeds in the given source, counted the same way as
+ * when the parser sizes the line offsets of a large source.
+ */
+static VALUE
+source_newline_count_m(VALUE self, VALUE source) {
+    Check_Type(source, T_STRING);
+    return SIZET2NUM(pm_newline_count((const uint8_t *) RSTRING_PTR(source), (size_t) RSTRING_LEN(source)));
+}
+
+/**
+ * call-seq:
+ *   Source::line_offsets(source) -> String
+ *
+ * Returns the packed line offsets of the given source without parsing it, as
+ * a string of uint32_t values holding the byte offset of the start of every
+ * line.
+ */
+static VALUE
+source_line_offsets_m(VALUE self, VALUE source) {
+    Check_Type(source, T_STRING);
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_line_offset_list_t list;
+    pm_line_offset_list_build(arena, &list, (const uint8_t *) RSTRING_PTR(source), (size_t) RSTRING_LEN(source));
+
+    VALUE offsets = rb_str_new((const char *) list.offsets, (long) (list.size * sizeof(uint32_t)));
+    pm_arena_free(arena);
+
+    return offsets;
+}
+
+/******************************************************************************/
+/* String query methods                                                       */
+/******************************************************************************/
+
+/**
+ * Process the result of a call to a string query method and return an
+ * appropriate value.
+ */
+static VALUE
+string_query(pm_string_query_t result) {
+    switch (result) {
+        case PM_STRING_QUERY_ERROR:
+            rb_raise(rb_eArgError, "Invalid or non ascii-compatible encoding");
+            return Qfalse;
+        case PM_STRING_QUERY_FALSE:
+            return Qfalse;
+        case PM_STRING_QUERY_TRUE:
+            return Qtrue;
+    }
+    return Qfalse;
 }
 
 /**
@@ -1625,21 +2850,30 @@ Init_prism(void) {
     rb_cPrismParseLexResult = rb_define_class_under(rb_cPrism, "ParseLexResult", rb_cPrismResult);
     rb_cPrismStringQuery = rb_define_class_under(rb_cPrism, "StringQuery", rb_cObject);
     rb_cPrismScope = rb_define_class_under(rb_cPrism, "Scope", rb_cObject);
+    rb_cPrismSharedConstantPool = rb_define_class_under(rb_cPrism, "SharedConstantPool", rb_cObject);
+    rb_cPrismIncrementalParser = rb_define_class_under(rb_cPrism, "IncrementalParser", rb_cObject);
 
     rb_cPrismCurrentVersionError = rb_const_get(rb_cPrism, rb_intern("CurrentVersionError"));
 
     /* Intern all of the IDs eagerly that we support so that we do not have to
      * do it every time we parse. */
+    rb_id_option_attach_comments = rb_intern_const("attach_comments");
     rb_id_option_command_line = rb_intern_const("command_line");
+    rb_id_option_constant_pool = rb_intern_const("constant_pool");
+    rb_id_option_discard_comments = rb_intern_const("discard_comments");
     rb_id_option_encoding = rb_intern_const("encoding");
+    rb_id_option_error_limit = rb_intern_const("error_limit");
     rb_id_option_filepath = rb_intern_const("filepath");
     rb_id_option_freeze = rb_intern_const("freeze");
     rb_id_option_frozen_string_literal = rb_intern_const("frozen_string_literal");
     rb_id_option_line = rb_intern_const("line");
     rb_id_option_main_script = rb_intern_const("main_script");
+    rb_id_option_mark_newlines = rb_intern_const("mark_newlines");
     rb_id_option_partial_script = rb_intern_const("partial_script");
     rb_id_option_raise_error = rb_intern_const("raise_error");
     rb_id_option_scopes = rb_intern_const("scopes");
+    rb_id_option_source_strings = rb_intern_const("source_strings");
+    rb_id_option_syntax_check = rb_intern_const("syntax_check");
     rb_id_option_version = rb_intern_const("version");
 
     rb_id_source_for = rb_intern("for");
@@ -1653,6 +2887,11 @@ Init_prism(void) {
     rb_id_raise_error_style = rb_intern_const("style");
     rb_id_raise_error_color = rb_intern_const("color");
 
+    prism_encindex_utf_16le = rb_enc_find_index("UTF-16LE");
+    prism_encindex_utf_16be = rb_enc_find_index("UTF-16BE");
+    prism_encindex_utf_32le = rb_enc_find_index("UTF-32LE");
+    prism_encindex_utf_32be = rb_enc_find_index("UTF-32BE");
+
     /**
      * The version of the prism library.
      */
@@ -1673,15 +2912,46 @@ Init_prism(void) {
     rb_define_singleton_method(rb_cPrism, "parse_failure?", parse_failure_p, -1);
     rb_define_singleton_method(rb_cPrism, "parse_file_success?", parse_file_success_p, -1);
     rb_define_singleton_method(rb_cPrism, "parse_file_failure?", parse_file_failure_p, -1);
+    rb_define_singleton_method(rb_cPrism, "scan", scan, -1);
+    rb_define_singleton_method(rb_cPrism, "parse_events", parse_events, -1);
 
 #ifndef PRISM_EXCLUDE_SERIALIZATION
     rb_define_singleton_method(rb_cPrism, "dump", dump, -1);
     rb_define_singleton_method(rb_cPrism, "dump_file", dump_file, -1);
+    rb_define_singleton_method(rb_cPrism, "dump_errors", dump_errors, -1);
+#endif
+
+#ifdef PRISM_NODE_STATS
+    rb_define_singleton_method(rb_cPrism, "node_stats", node_stats, -1);
+#endif
+
+#ifdef PRISM_STATS
+    rb_define_singleton_method(rb_cPrism, "parser_stats", parser_stats, -1);
 #endif
 
+    rb_define_singleton_method(rb_cPrismSource, "find_line", source_find_line_m, 2);
+    rb_define_singleton_method(rb_cPrismSource, "line_column", source_line_column_m, 2);
+    rb_define_singleton_method(rb_cPrismSource, "line_offset", source_line_offset_m, 2);
+    rb_define_singleton_method(rb_cPrismSource, "code_units_table", source_code_units_table_m, 3);
+    rb_define_singleton_method(rb_cPrismSource, "code_units_offset", source_code_units_offset_m, 5);
+    rb_define_singleton_method(rb_cPrismSource, "character_offsets", source_character_offsets_m, 1);
+
+    // These are only used to test the line offset scans against the parser.
+    VALUE source_singleton = rb_singleton_class(rb_cPrismSource);
+    rb_define_private_method(source_singleton, "newline_count", source_newline_count_m, 1);
+    rb_define_private_method(source_singleton, "line_offsets", source_line_offsets_m, 1);
+
     rb_define_singleton_method(rb_cPrismStringQuery, "local?", string_query_local_p, 1);
     rb_define_singleton_method(rb_cPrismStringQuery, "constant?", string_query_constant_p, 1);
     rb_define_singleton_method(rb_cPrismStringQuery, "method_name?", string_query_method_name_p, 1);
 
+    rb_define_alloc_func(rb_cPrismSharedConstantPool, shared_constant_pool_alloc);
+    rb_define_private_method(rb_cPrismSharedConstantPool, "compile", shared_constant_pool_compile, 1);
+
+    rb_define_alloc_func(rb_cPrismIncrementalParser, incremental_parser_alloc);
+    rb_define_method(rb_cPrismIncrementalParser, "result", incremental_parser_result, 0);
+    rb_define_private_method(rb_cPrismIncrementalParser, "setup", incremental_parser_setup, 2);
+    rb_define_private_method(rb_cPrismIncrementalParser, "update", incremental_parser_update, 2);
+
     Init_prism_api_node();
 }
@@ -8,10 +8,12 @@
 #include <ruby/version.h>
 #include "prism.h"
 
-VALUE pm_source_new(const pm_parser_t *parser, rb_encoding *encoding, bool freeze);
+VALUE pm_source_new(pm_parser_t *parser, rb_encoding *encoding, bool freeze);
 VALUE pm_token_new(const pm_parser_t *parser, const pm_token_t *token, rb_encoding *encoding, VALUE source, bool freeze);
 VALUE pm_ast_new(const pm_parser_t *parser, const pm_node_t *node, rb_encoding *encoding, VALUE source, bool freeze);
 VALUE pm_integer_new(const pm_integer_t *integer);
+VALUE pm_shared_constant_pool_symbols(const pm_parser_t *parser, rb_encoding *encoding);
+VALUE pm_ast_nodes_new(const pm_parser_t *parser, const pm_node_t **nodes, size_t size, rb_encoding *encoding, VALUE source, bool freeze);
 
 void Init_prism_api_node(void);
 RUBY_FUNC_EXPORTED void Init_prism(void);
@@ -0,0 +1,140 @@
+#include <prism.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PRISM_STATS
+#error "the complexity fuzzer must be compiled with PRISM_STATS"
+#endif
+
+/*
+ * Inputs are repeated until they are at least this many bytes long before they
+ * are measured, so that the fixed cost of setting up a parser does not drown
+ * out the cost of the input itself.
+ */
+#define COMPLEXITY_MINIMUM_SIZE 1024
+
+/* Inputs longer than this are skipped to keep each execution fast. */
+#define COMPLEXITY_MAXIMUM_SIZE 4096
+
+/* How many times the smaller input is repeated to make the larger one. */
+#define COMPLEXITY_SCALE 8
+
+/*
+ * How many times higher the cost per byte of the larger input may be than that
+ * of the smaller input before the input is reported.
+ */
+#define COMPLEXITY_THRESHOLD 4
+
+/*
+ * The parse time in nanoseconds below which the larger input is not checked
+ * for superlinear time, since measurements that small are mostly noise.
+ */
+#define COMPLEXITY_MINIMUM_TIME 1000000
+
+/* How many times each input is parsed, taking the fastest time. */
+#define COMPLEXITY_RUNS 3
+
+/*
+ * The measurements taken from parsing an input. Everything but the time is
+ * deterministic, so superlinear growth in those is reported regardless of how
+ * long the parse took. Diagnostics and error recovery nodes are deliberately
+ * left out: repeating a valid input can make it invalid (a second __END__, a
+ * duplicated definition) so those counts jump without any extra work being
+ * done, and slow error recovery still shows up in the time.
+ */
+typedef struct {
+    size_t tokens;
+    size_t lex_mode_pushes;
+    size_t constant_collisions;
+    size_t strpbrk_calls;
+    size_t arena_bytes;
+    uint64_t time;
+} complexity_cost_t;
+
+static uint8_t *
+complexity_repeat(const uint8_t *input, size_t size, size_t count) {
+    uint8_t *repeated = malloc(size * count);
+    if (repeated == NULL) abort();
+
+    for (size_t index = 0; index < count; index++) {
+        memcpy(repeated + index * size, input, size);
+    }
+
+    return repeated;
+}
+
+static complexity_cost_t
+complexity_measure(const uint8_t *input, size_t size) {
+    complexity_cost_t cost = { .time = UINT64_MAX };
+
+    for (int run = 0; run < COMPLEXITY_RUNS; run++) {
+        pm_arena_t *arena = pm_arena_new();
+        pm_parser_t *parser = pm_parser_new(arena, input, size, NULL);
+        pm_parse(parser);
+
+        pm_parser_stats_t stats;
+        pm_parser_stats(parser, &stats);
+
+        pm_parser_free(parser);
+        pm_arena_free(arena);
+
+        size_t tokens = 0;
+        for (size_t type = 0; type < PM_TOKEN_MAXIMUM; type++) tokens += stats.tokens[type];
+
+        cost.tokens = tokens;
+        cost.lex_mode_pushes = stats.lex_mode_pushes;
+        cost.constant_collisions = stats.constant_collisions;
+        cost.strpbrk_calls = stats.strpbrk_calls;
+        cost.arena_bytes = stats.ast_arena_bytes + stats.metadata_arena_bytes;
+        if (stats.parse_time < cost.time) cost.time = stats.parse_time;
+    }
+
+    return cost;
+}
+
+/*
+ * Report the input if the larger measurement grew by more than the threshold
+ * times what the scale alone accounts for. One is added to the smaller
+ * measurement so that counters that start at zero do not report spuriously.
+ */
+static void
+complexity_check(const char *name, double small, double large, double small_size, double large_size) {
+    if ((large / large_size) > COMPLEXITY_THRESHOLD * ((small + 1) / small_size)) {
+        fprintf(stderr, "superlinear %s: %.0f over %.0f bytes grew to %.0f over %.0f bytes\n", name, small, small_size, large, large_size);
+        abort();
+    }
+}
+
+void
+harness(const uint8_t *input, size_t size) {
+    if (size == 0 || size > COMPLEXITY_MAXIMUM_SIZE) return;
+
+    size_t small_count = (COMPLEXITY_MINIMUM_SIZE + size - 1) / size;
+    size_t small_size = size * small_count;
+    size_t large_size = small_size * COMPLEXITY_SCALE;
+
+    uint8_t *small_input = complexity_repeat(input, size, small_count);
+    uint8_t *large_input = complexity_repeat(small_input, small_size, COMPLEXITY_SCALE);
+
+    complexity_cost_t small = complexity_measure(small_input, small_size);
+    complexity_cost_t large = complexity_measure(large_input, large_size);
+
+    free(small_input);
+    free(large_input);
+
+    double small_bytes = (double) small_size;
+    double large_bytes = (double) large_size;
+
+    complexity_check("tokens", (double) small.tokens, (double) large.tokens, small_bytes, large_bytes);
+    complexity_check("lex mode pushes", (double) small.lex_mode_pushes, (double) large.lex_mode_pushes, small_bytes, large_bytes);
+    complexity_check("constant collisions", (double) small.constant_collisions, (double) large.constant_collisions, small_bytes, large_bytes);
+    complexity_check("strpbrk calls", (double) small.strpbrk_calls, (double) large.strpbrk_calls, small_bytes, large_bytes);
+    complexity_check("arena bytes", (double) small.arena_bytes, (double) large.arena_bytes, small_bytes, large_bytes);
+
+    if (large.time >= COMPLEXITY_MINIMUM_TIME) {
+        complexity_check("parse time", (double) small.time, (double) large.time, small_bytes, large_bytes);
+    }
+}
@@ -0,0 +1,7 @@
+#!/bin/bash
+
+OUTPUT_DIR=$1
+
+screen -S complexity_fuzzer -m /bin/bash -c "afl-fuzz -x ./fuzz/dict -c ./build/fuzz.complexity.cmplog -i ./fuzz/corpus/parse -M main_complexity -o $OUTPUT_DIR ./build/fuzz.complexity || read -n 1"
+
+exec /bin/bash
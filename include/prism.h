@@ -19,7 +19,9 @@ extern "C" {
 #include "prism/node.h"
 #include "prism/options.h"
 #include "prism/parser.h"
+#include "prism/pattern.h"
 #include "prism/prettyprint.h"
+#include "prism/reparse.h"
 #include "prism/serialize.h"
 #include "prism/source.h"
 #include "prism/stream.h"
@@ -13,6 +13,7 @@
 #include "prism/ast.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 /** This is the type of a comment that we've found while parsing. */
 typedef enum {
@@ -23,6 +24,39 @@ typedef enum {
 /** An opaque pointer to a comment found while parsing. */
 typedef struct pm_comment_t pm_comment_t;
 
+/** How a comment is attached to its target in the syntax tree. */
+typedef enum {
+    /** The comment comes before its target. */
+    PM_COMMENT_ATTACHMENT_LEADING = 0,
+
+    /** The comment comes after its target. */
+    PM_COMMENT_ATTACHMENT_TRAILING = 1
+} pm_comment_attachment_kind_t;
+
+/**
+ * Where a comment is attached in the syntax tree, as computed by
+ * pm_parser_comments_attach. The rules are the same as those used by
+ * ParseResult#attach_comments! in the Ruby library.
+ */
+typedef struct {
+    /**
+     * The id of the node that the comment is attached to, or of the node that
+     * owns the location that the comment is attached to.
+     */
+    uint32_t node_id;
+
+    /**
+     * 0 if the comment is attached to the node itself. Otherwise the comment is
+     * attached to a location field of the node, and this is one more than the
+     * index of that location in the node's comment targets (the array returned
+     * by Node#comment_targets in Ruby).
+     */
+    uint32_t target;
+
+    /** Whether this is a leading or a trailing comment. */
+    pm_comment_attachment_kind_t kind;
+} pm_comment_attachment_t;
+
 /**
  * Returns the location associated with the given comment.
  *
@@ -16,4 +16,15 @@
 #   define PRISM_HAS_SWAR
 #endif
 
+/**
+ * SSE2 is part of the x86-64 baseline, so scanners that only need SSE2
+ * intrinsics can use them even when SSSE3 is not enabled at compile time.
+ * Unlike the macros above, this can be defined together with PRISM_HAS_SSSE3
+ * or PRISM_HAS_SWAR, so check it after PRISM_HAS_NEON and before
+ * PRISM_HAS_SWAR.
+ */
+#if (defined(__x86_64__) && defined(__SSE2__)) || (defined(_MSC_VER) && defined(_M_X64))
+#   define PRISM_HAS_SSE2
+#endif
+
 #endif
@@ -46,6 +46,17 @@ typedef struct pm_constant_t pm_constant_t;
  */
 typedef struct pm_constant_pool_t pm_constant_pool_t;
 
+/**
+ * A constant pool that can be shared between parsers (see
+ * pm_options_shared_constant_pool_set). Parsers look up constants in the shared
+ * pool before their own, so the constants in it have the same ids (1 through
+ * the size of the shared pool) in every parse that uses it. Parsers only ever
+ * read from the shared pool, so it can be used by many parsers at once,
+ * including from multiple threads, as long as it is not modified or freed while
+ * any of them is alive.
+ */
+typedef struct pm_shared_constant_pool_t pm_shared_constant_pool_t;
+
 /**
  * Return a raw pointer to the start of a constant.
  *
@@ -78,4 +89,67 @@ PRISM_EXPORTED_FUNCTION void pm_constant_id_list_init(pm_constant_id_list_t *lis
  */
 PRISM_EXPORTED_FUNCTION void pm_constant_id_list_append(pm_arena_t *arena, pm_constant_id_list_t *list, pm_constant_id_t id) PRISM_NONNULL(1, 2);
 
+/**
+ * Allocate a new, empty shared constant pool. If the pool cannot be allocated,
+ * this function aborts the process.
+ *
+ * @returns A new shared constant pool. It should be freed using
+ *     pm_shared_constant_pool_free.
+ */
+PRISM_EXPORTED_FUNCTION PRISM_NODISCARD pm_shared_constant_pool_t * pm_shared_constant_pool_new(void);
+
+/**
+ * Insert a constant into a shared constant pool. The contents are copied into
+ * memory owned by the pool.
+ *
+ * @param pool The pool to insert into.
+ * @param start A pointer to the start of the constant.
+ * @param length The length of the constant.
+ * @returns The id of the constant, which is the existing id if the constant was
+ *     already in the pool.
+ */
+PRISM_EXPORTED_FUNCTION pm_constant_id_t pm_shared_constant_pool_insert(pm_shared_constant_pool_t *pool, const uint8_t *start, size_t length) PRISM_NONNULL(1);
+
+/**
+ * Return the number of constants in a shared constant pool.
+ *
+ * @param pool The pool to get the size of.
+ * @returns The number of constants in the pool.
+ */
+PRISM_EXPORTED_FUNCTION size_t pm_shared_constant_pool_size(const pm_shared_constant_pool_t *pool) PRISM_NONNULL(1);
+
+/**
+ * Return the constant with the given id in a shared constant pool.
+ *
+ * @param pool The pool to look up from.
+ * @param constant_id The id of the constant (1-based).
+ * @returns A pointer to the constant.
+ */
+PRISM_EXPORTED_FUNCTION const pm_constant_t * pm_shared_constant_pool_constant(const pm_shared_constant_pool_t *pool, pm_constant_id_t constant_id) PRISM_NONNULL(1);
+
+/**
+ * Attach arbitrary data to a shared constant pool, for example a cache of the
+ * objects that a consumer creates for its constants. The pool does not own the
+ * data.
+ *
+ * @param pool The pool to attach the data to.
+ * @param data The data to attach.
+ */
+PRISM_EXPORTED_FUNCTION void pm_shared_constant_pool_data_set(pm_shared_constant_pool_t *pool, void *data) PRISM_NONNULL(1);
+
+/**
+ * Return the data that was attached to a shared constant pool.
+ *
+ * @param pool The pool to get the data from.
+ * @returns The attached data, or NULL if none was attached.
+ */
+PRISM_EXPORTED_FUNCTION void * pm_shared_constant_pool_data(const pm_shared_constant_pool_t *pool) PRISM_NONNULL(1);
+
+/**
+ * Free a shared constant pool and all of its constants.
+ *
+ * @param pool The pool to free.
+ */
+PRISM_EXPORTED_FUNCTION void pm_shared_constant_pool_free(pm_shared_constant_pool_t *pool) PRISM_NONNULL(1);
+
 #endif
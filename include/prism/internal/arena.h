@@ -42,6 +42,18 @@ struct pm_arena_t {
     size_t block_count;
 };
 
+/*
+ * A position in an arena, taken with pm_arena_mark and later passed to
+ * pm_arena_rewind to release everything allocated after it.
+ */
+typedef struct {
+    /* The block that was active when the mark was taken. */
+    pm_arena_block_t *block;
+
+    /* The number of bytes consumed in that block when the mark was taken. */
+    size_t used;
+} pm_arena_mark_t;
+
 /*
  * Free all blocks in the arena. After this call, all pointers returned by
  * pm_arena_alloc and pm_arena_zalloc are invalid.
@@ -55,6 +67,12 @@ void pm_arena_cleanup(pm_arena_t *arena);
  */
 void pm_arena_reserve(pm_arena_t *arena, size_t capacity);
 
+/*
+ * Release everything allocated from the arena since the given mark was taken.
+ * Blocks allocated since then are freed, so pointers into them are invalid.
+ */
+void pm_arena_rewind(pm_arena_t *arena, pm_arena_mark_t mark);
+
 /*
  * Slow path for pm_arena_alloc: allocate a new block and return a pointer to
  * the first `size` bytes. Do not call directly — use pm_arena_alloc instead.
@@ -83,6 +101,19 @@ pm_arena_alloc(pm_arena_t *arena, size_t size, size_t alignment) {
     return pm_arena_alloc_slow(arena, size);
 }
 
+/*
+ * Take a mark of the current position in the arena, which can be rewound to
+ * with pm_arena_rewind. This is useful for temporaries with a stack-like
+ * lifetime.
+ */
+static PRISM_INLINE pm_arena_mark_t
+pm_arena_mark(const pm_arena_t *arena) {
+    return (pm_arena_mark_t) {
+        .block = arena->current,
+        .used = arena->current == NULL ? 0 : arena->current->used
+    };
+}
+
 /*
  * Allocate zero-initialized memory from the arena. This function is infallible
  * — it aborts on allocation failure.
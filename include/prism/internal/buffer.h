@@ -73,12 +73,6 @@ void pm_buffer_prepend_string(pm_buffer_t *buffer, const char *value, size_t len
 /* Concatenate one buffer onto another. */
 void pm_buffer_concat(pm_buffer_t *destination, const pm_buffer_t *source);
 
-/*
- * Clear the buffer by reducing its size to 0. This does not free the allocated
- * memory, but it does allow the buffer to be reused.
- */
-void pm_buffer_clear(pm_buffer_t *buffer);
-
 /* Strip the whitespace from the end of the buffer. */
 void pm_buffer_rstrip(pm_buffer_t *buffer);
 
@@ -3,6 +3,8 @@
 
 #include "prism/constant_pool.h"
 
+#include "prism/compiler/inline.h"
+
 #include "prism/arena.h"
 
 #include <stdbool.h>
@@ -65,6 +67,36 @@ struct pm_constant_pool_t {
 
     /* The number of buckets that have been allocated in the hash map. */
     uint32_t capacity;
+
+    /*
+     * An optional pool that is consulted before this one. Its constants keep
+     * their ids, and the ids of the constants in this pool start after them.
+     * The base pool is never modified through this pool.
+     */
+    const pm_constant_pool_t *base;
+
+#ifdef PRISM_STATS
+    /* The number of constants that were inserted or found by inserting. */
+    size_t stats_inserts;
+
+    /* The number of occupied buckets that were skipped while inserting. */
+    size_t stats_collisions;
+
+    /* The number of times the pool was resized. */
+    size_t stats_resizes;
+#endif
+};
+
+/* A constant pool that can be shared between parsers, with its own arena. */
+struct pm_shared_constant_pool_t {
+    /* The arena that holds the buckets, constants, and their contents. */
+    pm_arena_t *arena;
+
+    /* The pool that parsers use as their base pool. */
+    pm_constant_pool_t pool;
+
+    /* Arbitrary data attached by the consumer of the pool. */
+    void *data;
 };
 
 /*
@@ -74,14 +106,48 @@ struct pm_constant_pool_t {
  */
 #define PM_CONSTANT_ID_UNSET 0
 
+/*
+ * A set of constant ids, used to check for duplicates such as repeated
+ * captures in a pattern. This is an open-addressed hash set, so that checking
+ * each new id takes constant time no matter how many ids have been added.
+ */
+typedef struct {
+    /* The slots of the set, where unused slots are PM_CONSTANT_ID_UNSET. */
+    pm_constant_id_t *ids;
+
+    /* The number of ids in the set. */
+    uint32_t size;
+
+    /* The number of slots in the set, which is zero or a power of two. */
+    uint32_t capacity;
+} pm_constant_id_set_t;
+
+/*
+ * Return the number of ids that are taken by the base pool of the given pool,
+ * which is the offset of the ids of the constants in the pool itself.
+ */
+static PRISM_INLINE uint32_t
+pm_constant_pool_base_size(const pm_constant_pool_t *pool) {
+    return pool->base == NULL ? 0 : pool->base->size;
+}
+
+/*
+ * Return the number of ids that have been assigned by the given pool,
+ * including those of its base pool.
+ */
+static PRISM_INLINE uint32_t
+pm_constant_pool_total_size(const pm_constant_pool_t *pool) {
+    return pm_constant_pool_base_size(pool) + pool->size;
+}
+
 /* Initialize a list of constant ids with a given capacity. */
 void pm_constant_id_list_init_capacity(pm_arena_t *arena, pm_constant_id_list_t *list, size_t capacity);
 
 /* Insert a constant id into a list of constant ids at the specified index. */
 void pm_constant_id_list_insert(pm_constant_id_list_t *list, size_t index, pm_constant_id_t id);
 
-/* Checks if the current constant id list includes the given constant id. */
-bool pm_constant_id_list_includes(pm_constant_id_list_t *list, pm_constant_id_t id);
+/* Add a constant id to a set, returning false if it was already present. */
+bool pm_constant_id_set_add(pm_arena_t *arena, pm_constant_id_set_t *set, pm_constant_id_t id);
 
 /* Initialize a new constant pool with a given capacity. */
 void pm_constant_pool_init(pm_arena_t *arena, pm_constant_pool_t *pool, uint32_t capacity);
@@ -114,4 +180,11 @@ pm_constant_id_t pm_constant_pool_insert_owned(pm_arena_t *arena, pm_constant_po
  */
 pm_constant_id_t pm_constant_pool_insert_constant(pm_arena_t *arena, pm_constant_pool_t *pool, const uint8_t *start, size_t length);
 
+/*
+ * Move the constants with ids up to the given id that are slices of the old
+ * source over to the new source, which replaced the range from start to end of
+ * the old source with a range that differs in length by delta.
+ */
+void pm_constant_pool_rebase(pm_arena_t *arena, pm_constant_pool_t *pool, pm_constant_id_t maximum, const uint8_t *old_source, size_t old_size, const uint8_t *new_source, uint32_t start, uint32_t end, int64_t delta);
+
 #endif
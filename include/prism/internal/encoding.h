@@ -5,6 +5,19 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * The ranges of lead and trailing bytes of a double-byte encoding for which any
+ * lead byte followed by any trailing byte is a valid two-byte character. Each
+ * range is inclusive, and encodings that only need one range repeat it.
+ */
+typedef struct {
+    /* The ranges of lead bytes. */
+    uint8_t lead[2][2];
+
+    /* The ranges of trailing bytes. */
+    uint8_t trail[2][2];
+} pm_encoding_double_byte_t;
+
 /*
  * This struct defines the functions necessary to implement the encoding
  * interface so we can determine how many bytes the subsequent character takes.
@@ -48,6 +61,13 @@ typedef struct {
 
     /* Return true if the encoding is a multibyte encoding. */
     bool multibyte;
+
+    /*
+     * The lead and trailing bytes that always form a valid two-byte character,
+     * used to skip over runs of two-byte characters many bytes at a time, or
+     * NULL if the encoding does not have any.
+     */
+    const pm_encoding_double_byte_t *double_byte;
 } pm_encoding_t;
 
 /*
@@ -89,6 +109,30 @@ size_t pm_encoding_utf_8_alnum_char(const uint8_t *b, ptrdiff_t n);
  */
 bool pm_encoding_utf_8_isupper_char(const uint8_t *b, ptrdiff_t n);
 
+/*
+ * Returns the number of bytes at the start of the given string before the first
+ * byte that is not ASCII, which is the length of the string if it is entirely
+ * ASCII.
+ */
+size_t pm_ascii_prefix_length(const uint8_t *source, size_t length);
+
+/*
+ * Returns the number of bytes at the start of the given string that are a run
+ * of two-byte characters matching the double_byte ranges of the given encoding.
+ * This is always even, and is 0 if the encoding does not have any.
+ */
+size_t pm_encoding_double_byte_length(const pm_encoding_t *encoding, const uint8_t *source, size_t length);
+
+/*
+ * Returns the number of bytes at the start of the given UTF-8 string that are
+ * identifier characters: ASCII letters, digits, and underscores, and any valid
+ * multibyte character.
+ */
+size_t pm_encoding_utf_8_identifier_length(const uint8_t *source, size_t length);
+
+/* Returns true if the given string is entirely made up of valid UTF-8. */
+bool pm_encoding_utf_8_valid_p(const uint8_t *source, size_t length);
+
 /*
  * This lookup table is referenced in both the UTF-8 encoding file and the
  * parser directly in order to speed up the default encoding processing. It is
@@ -4,6 +4,7 @@
 #ifndef PRISM_INTERNAL_INTEGER_H
 #define PRISM_INTERNAL_INTEGER_H
 
+#include "prism/arena.h"
 #include "prism/buffer.h"
 #include "prism/integer.h"
 
@@ -42,9 +43,10 @@ typedef enum {
 /*
  * Parse an integer from a string. This assumes that the format of the integer
  * has already been validated, as internal validation checks are not performed
- * here.
+ * here. If the integer does not fit into a uint32_t, its values are allocated
+ * from the given arena.
  */
-void pm_integer_parse(pm_integer_t *integer, pm_integer_base_t base, const uint8_t *start, const uint8_t *end);
+void pm_integer_parse(pm_arena_t *arena, pm_integer_t *integer, pm_integer_base_t base, const uint8_t *start, const uint8_t *end);
 
 /*
  * Compare two integers. This function returns -1 if the left integer is less
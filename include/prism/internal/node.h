@@ -6,6 +6,7 @@
 #include "prism/compiler/force_inline.h"
 
 #include "prism/arena.h"
+#include "prism/line_offset_list.h"
 
 /*
  * Slow path for pm_node_list_append: grow the list and append the node.
@@ -29,4 +30,90 @@ void pm_node_list_prepend(pm_arena_t *arena, pm_node_list_t *list, pm_node_t *no
 /* Concatenate the given node list onto the end of the other node list. */
 void pm_node_list_concat(pm_arena_t *arena, pm_node_list_t *list, pm_node_list_t *other);
 
+/*
+ * Call the given callback for each target that comments can be attached to
+ * within the given node, in the same order as Node#comment_targets in Ruby.
+ */
+void pm_node_comment_targets_each(const pm_node_t *node, void (*callback)(const pm_node_t *target, const pm_location_t *location, void *data), void *data);
+
+/*
+ * Replace the newline flags set while parsing with ones that mark the first
+ * node on each line that would fire a :line tracepoint event. Any node other
+ * than a program is treated as a statement, with its own line marked first.
+ */
+void pm_node_mark_newlines(pm_node_t *node, const pm_line_offset_list_t *line_offsets);
+
+/*
+ * A single edit that pm_node_rebase moves a tree across, from the source that
+ * it was parsed from over to the source after the edit.
+ */
+typedef struct {
+    /* The node to leave alone, because it was parsed from the new source. */
+    const pm_node_t *skip;
+
+    /* The source that the tree was parsed from. */
+    const uint8_t *old_source;
+
+    /* The size of the source that the tree was parsed from. */
+    size_t old_size;
+
+    /* The source after the edit. */
+    const uint8_t *new_source;
+
+    /* The offset in the old source where the edited range ends. */
+    uint32_t end;
+
+    /* The difference in length between the new source and the old source. */
+    int64_t delta;
+} pm_node_rebase_t;
+
+/*
+ * Move the locations and shared strings in the given subtree across the edit
+ * described by the given rebase.
+ */
+void pm_node_rebase(pm_node_t *node, const pm_node_rebase_t *rebase);
+
+/* The kinds of values that pm_node_field can read out of a node. */
+typedef enum {
+    PM_NODE_FIELD_NODE,
+    PM_NODE_FIELD_NODE_LIST,
+    PM_NODE_FIELD_CONSTANT,
+    PM_NODE_FIELD_CONSTANT_LIST,
+    PM_NODE_FIELD_STRING,
+    PM_NODE_FIELD_OTHER
+} pm_node_field_type_t;
+
+/* A field read out of a node by pm_node_field. */
+typedef struct {
+    /* The kind of value that was read. */
+    pm_node_field_type_t type;
+
+    /* The value itself, depending on the type. Other fields have no value. */
+    union {
+        const pm_node_t *node;
+        const pm_node_list_t *node_list;
+        pm_constant_id_t constant;
+        const pm_constant_id_list_t *constant_list;
+        const pm_string_t *string;
+    } as;
+} pm_node_field_t;
+
+/* Returned by pm_node_field_find for keys that #deconstruct_keys omits. */
+#define PM_NODE_FIELD_INDEX_NONE -1
+
+/* Returned by pm_node_field_find for keys that are not fields of the node. */
+#define PM_NODE_FIELD_INDEX_OTHER -2
+
+/*
+ * Return the index of the field of the given type of node that
+ * Node#deconstruct_keys returns for the given key.
+ */
+int pm_node_field_find(pm_node_type_t type, const uint8_t *name, size_t length);
+
+/*
+ * Read the field at the given index of the given node. Returns false if the
+ * node does not have that many fields.
+ */
+bool pm_node_field(const pm_node_t *node, int index, pm_node_field_t *field);
+
 #endif
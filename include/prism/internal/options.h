@@ -147,6 +147,49 @@ struct pm_options_t {
      * between concurrency primitives.
      */
     bool freeze;
+
+    /*
+     * Whether or not the parser should compute where each comment attaches in
+     * the tree and include the result when serializing.
+     */
+    bool attach_comments;
+
+    /*
+     * Whether or not the parser should replace the newline flags that it sets
+     * while parsing with ones that emulate CRuby's :line tracepoint event.
+     */
+    bool mark_newlines;
+
+    /*
+     * Whether or not the loader of the serialized output holds the source, so
+     * that string fields which are slices of it can be serialized as offsets
+     * into it instead of copies of their bytes.
+     */
+    bool source_strings;
+
+    /*
+     * Whether or not the parser should skip keeping the list of comments, for
+     * callers that never read it.
+     */
+    bool discard_comments;
+
+    /*
+     * The number of errors after which the parser stops reading the source and
+     * returns what it has, or 0 to always read the whole source.
+     */
+    uint32_t error_limit;
+
+    /*
+     * Whether or not the parser only checks the syntax of the source, in which
+     * case the tree that it returns is incomplete.
+     */
+    bool syntax_check;
+
+    /*
+     * The constant pool whose constants are looked up before the parser's own,
+     * so that they keep the same ids across parses. Not owned by the options.
+     */
+    const pm_shared_constant_pool_t *shared_constant_pool;
 };
 
 /* Free the internal memory associated with the options. */
@@ -179,6 +222,12 @@ void pm_options_cleanup(pm_options_t *options);
  * | `1`     | main script                |
  * | `1`     | partial script             |
  * | `1`     | freeze                     |
+ * | `1`     | attach comments            |
+ * | `1`     | mark newlines              |
+ * | `1`     | source strings             |
+ * | `1`     | discard comments           |
+ * | `4`     | the error limit            |
+ * | `1`     | syntax check               |
  * | `4`     | the number of scopes       |
  * | ...     | the scopes                 |
  *
@@ -556,6 +556,22 @@ typedef struct pm_scope {
      * If closed is true, then the scope cannot see into its parent.
      */
     bool closed;
+
+    /*
+     * A boolean indicating whether or not this scope is the top-level scope or
+     * is open to it. This is computed when the scope is pushed so that it does
+     * not need to walk the scope stack each time it is checked.
+     */
+    bool toplevel;
+
+    /*
+     * A bloom filter over the locals of this scope and of every scope that it
+     * can see into. Locals are only ever added to the current scope, so this
+     * is inherited when the scope is pushed and then kept up to date as locals
+     * are added. It lets lookups of names that are not visible return without
+     * walking the scope stack.
+     */
+    uint32_t visible_bloom;
 } pm_scope_t;
 
 /*
@@ -635,6 +651,14 @@ struct pm_parser_t {
 
         /* The current index into the lexer mode stack. */
         size_t index;
+
+        /*
+         * The lowest index that the lexer mode stack has been popped to since
+         * this was last lowered by the parser. This lets the parser tell
+         * whether a lex mode it pushed is still on the stack without walking
+         * the stack to find it.
+         */
+        size_t floor;
     } lex_modes;
 
     /* The pointer to the start of the source. */
@@ -677,12 +701,31 @@ struct pm_parser_t {
      */
     pm_location_t data_loc;
 
+    /*
+     * The part of the source that was parsed last, which is the whole source
+     * unless pm_reparse was able to parse a single definition again.
+     */
+    pm_location_t reparsed_loc;
+
+    /*
+     * The number of bytes that pm_reparse has parsed again since the source
+     * was last parsed from scratch. The parts of the tree that they replaced
+     * stay in the arena, so this bounds how much of it is garbage.
+     */
+    size_t reparsed_size;
+
     /* The list of warnings that have been found while parsing. */
     pm_list_t warning_list;
 
     /* The list of errors that have been found while parsing. */
     pm_list_t error_list;
 
+    /*
+     * The number of errors after which the lexer skips to the end of the
+     * source, or 0 if it never does.
+     */
+    uint32_t error_limit;
+
     /* The current local scope. */
     pm_scope_t *current_scope;
 
@@ -698,6 +741,35 @@ struct pm_parser_t {
      */
     pm_static_literals_t *current_hash_keys;
 
+    /*
+     * The last and/or node whose left-hand side was checked for a void value
+     * expression, along with the result of that check. These operators nest
+     * to the left, so each new link in a chain like `a && b && c` can reuse
+     * the result for the previous link rather than walking the whole chain
+     * again.
+     */
+    struct {
+        /* The and/or node that was checked. */
+        const pm_node_t *node;
+
+        /* The void node that was found, or NULL if there was none. */
+        pm_node_t *void_node;
+    } value_expression;
+
+    /*
+     * The last node that was checked for being a command call value, along
+     * with the result. Unary operators nest through their receivers, so each
+     * new operator in a chain like `- - - foo` can reuse the result for its
+     * receiver rather than walking the whole chain again.
+     */
+    struct {
+        /* The node that was checked. */
+        const pm_node_t *node;
+
+        /* Whether or not the node is a command call value. */
+        bool value;
+    } command_call_value;
+
     /*
      * The encoding functions for the current file is attached to the parser as
      * it's parsing so that it can change with a magic comment.
@@ -753,6 +825,12 @@ struct pm_parser_t {
      */
     pm_constant_pool_t constant_pool;
 
+    /*
+     * The shared constant pool that was given in the options, if any. Its pool
+     * is the base of the constant pool above.
+     */
+    const pm_shared_constant_pool_t *shared_constant_pool;
+
     /* This is the list of line offsets in the source file. */
     pm_line_offset_list_t line_offsets;
 
@@ -863,6 +941,36 @@ struct pm_parser_t {
      */
     bool partial_script;
 
+    /*
+     * Whether or not the comment attachments should be computed and included
+     * when the tree is serialized.
+     */
+    bool attach_comments;
+
+    /*
+     * Whether or not the newline flags should be marked to emulate CRuby's
+     * :line tracepoint event once the tree has been parsed.
+     */
+    bool mark_newlines;
+
+    /*
+     * Whether or not string fields that are slices of the source should be
+     * serialized as offsets into it instead of copies of their bytes.
+     */
+    bool source_strings;
+
+    /*
+     * Whether or not comments are skipped instead of being added to the list of
+     * comments. Magic comments are still found either way.
+     */
+    bool discard_comments;
+
+    /*
+     * Whether or not the nodes of each statement are released once it has been
+     * checked, because the tree is only being parsed to check its syntax.
+     */
+    bool syntax_check;
+
     /* Whether or not we're at the beginning of a command. */
     bool command_start;
 
@@ -884,6 +992,26 @@ struct pm_parser_t {
      */
     bool continuable;
 
+    /*
+     * The offset of the first byte in the source that is not ASCII, or the
+     * length of the source if every byte is ASCII. This is only meaningful
+     * when encoding_scanned is set.
+     */
+    uint32_t first_non_ascii;
+
+    /*
+     * Whether the source is valid in its final encoding. This is only
+     * meaningful when encoding_scanned is set.
+     */
+    pm_encoding_validity_t encoding_validity;
+
+    /*
+     * Whether first_non_ascii and encoding_validity have been computed for the
+     * source in its final encoding. Most consumers never ask for them, so they
+     * are computed the first time they are requested after parsing.
+     */
+    bool encoding_scanned;
+
     /*
      * This is very specialized behavior for when you want to parse in a context
      * that does not respect encoding comments. Its main use case is translating
@@ -940,8 +1068,30 @@ struct pm_parser_t {
         uint64_t table[4];
     } strpbrk_cache;
 #endif
+
+#ifdef PRISM_STATS
+    /* The statistics gathered while parsing. */
+    pm_parser_stats_t stats;
+#endif
 };
 
+#ifdef PRISM_STATS
+
+/* Increment the given statistics counter on the parser. */
+#define PM_PARSER_STATS_INCREMENT(parser_, field_) ((parser_)->stats.field_++)
+
+/*
+ * Return a monotonic timestamp in nanoseconds, used to time the phases of the
+ * parser.
+ */
+uint64_t pm_parser_stats_time(void);
+
+#else
+
+#define PM_PARSER_STATS_INCREMENT(parser_, field_) ((void) 0)
+
+#endif
+
 /*
  * Initialize a parser with the given start and end pointers.
  */
@@ -17,6 +17,8 @@
 #include "prism/compiler/exported.h"
 #include "prism/compiler/nonnull.h"
 
+#include "prism/arena.h"
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -58,4 +60,31 @@ typedef struct {
  */
 PRISM_EXPORTED_FUNCTION pm_line_column_t pm_line_offset_list_line_column(const pm_line_offset_list_t *list, uint32_t cursor, int32_t start_line) PRISM_NONNULL(1);
 
+/**
+ * Returns the number of line feeds in the given source. This uses vectorized
+ * instructions where they are available, and is used by the parser to size the
+ * line offset list of large inputs exactly.
+ *
+ * @param source The source to scan.
+ * @param length The length of the source in bytes.
+ * @returns The number of line feeds in the source.
+ */
+PRISM_EXPORTED_FUNCTION size_t pm_newline_count(const uint8_t *source, size_t length);
+
+/**
+ * Build the line offset list for the given source without parsing it, for
+ * consumers that only need to map between offsets and lines. The list has an
+ * offset for the start of the first line and one for the byte following every
+ * line feed, and is allocated from the given arena.
+ *
+ * This is the same list the parser builds as it lexes, except when the -x
+ * command line option makes the parser skip lines that precede the script.
+ *
+ * @param arena The arena to allocate the offsets from.
+ * @param list The list to initialize.
+ * @param source The source to scan.
+ * @param length The length of the source in bytes.
+ */
+PRISM_EXPORTED_FUNCTION void pm_line_offset_list_build(pm_arena_t *arena, pm_line_offset_list_t *list, const uint8_t *source, size_t length) PRISM_NONNULL(1, 2);
+
 #endif
@@ -26,6 +26,16 @@
  */
 PRISM_EXPORTED_FUNCTION const char * pm_node_type(pm_node_type_t node_type);
 
+/**
+ * Returns the type of node whose Ruby class has the given name (like
+ * "CallNode"), or 0 if there is no such class.
+ *
+ * @param name The name of the class.
+ * @param length The length of the name.
+ * @returns The type of node, or 0 if there is none.
+ */
+PRISM_EXPORTED_FUNCTION pm_node_type_t pm_node_type_find(const uint8_t *name, size_t length) PRISM_NONNULL(1);
+
 /**
  * Visit each of the nodes in this subtree using the given visitor callback. The
  * callback function will be called for each node in the subtree. If it returns
@@ -91,4 +101,53 @@ PRISM_EXPORTED_FUNCTION void pm_visit_node(const pm_node_t *node, bool (*visitor
  */
 PRISM_EXPORTED_FUNCTION void pm_visit_child_nodes(const pm_node_t *node, bool (*visitor)(const pm_node_t *node, void *data), void *data) PRISM_NONNULL(1);
 
+#ifdef PRISM_NODE_STATS
+
+/**
+ * Statistics about the memory used by a single type of node within a tree.
+ */
+typedef struct {
+    /** The number of nodes of this type. */
+    size_t count;
+
+    /** The number of bytes used by the node structs themselves. */
+    size_t bytes;
+
+    /**
+     * The number of bytes used by the arrays backing the node lists owned by
+     * nodes of this type, including unused capacity.
+     */
+    size_t list_bytes;
+
+    /**
+     * The number of bytes that the node structs and their node list arrays
+     * would use if children were stored as 32-bit arena-relative offsets and
+     * node lists as a (uint32 size, uint32 capacity, uint32 offset) triple.
+     */
+    size_t compact_bytes;
+} pm_node_stats_entry_t;
+
+/**
+ * Statistics about the memory used by a tree, broken down by node type. This
+ * is only available when prism is compiled with PRISM_NODE_STATS, and is meant
+ * to be used to measure the effects of changes to the node layout against real
+ * code.
+ */
+typedef struct {
+    /** The per-type statistics, indexed by pm_node_type_t. */
+    pm_node_stats_entry_t entries[PM_SCOPE_NODE];
+} pm_node_stats_t;
+
+/**
+ * Walk the given tree and accumulate statistics about its nodes into the given
+ * stats struct. The struct is not reset first, so it can be used to aggregate
+ * over many trees.
+ *
+ * @param node The root node of the tree to walk.
+ * @param stats The stats struct to accumulate into.
+ */
+PRISM_EXPORTED_FUNCTION void pm_node_stats(const pm_node_t *node, pm_node_stats_t *stats) PRISM_NONNULL(1, 2);
+
+#endif
+
 #endif
@@ -10,6 +10,7 @@
 #include "prism/compiler/nodiscard.h"
 #include "prism/compiler/nonnull.h"
 
+#include "prism/constant_pool.h"
 #include "prism/stringy.h"
 
 #include <stdbool.h>
@@ -249,6 +250,136 @@ PRISM_EXPORTED_FUNCTION bool pm_options_freeze(const pm_options_t *options) PRIS
  */
 PRISM_EXPORTED_FUNCTION void pm_options_freeze_set(pm_options_t *options, bool freeze) PRISM_NONNULL(1);
 
+/**
+ * Get the attach comments option on the given options struct.
+ *
+ * @param options The options struct to get the attach comments value from.
+ * @returns The attach comments value.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_options_attach_comments(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the attach comments option on the given options struct.
+ *
+ * @param options The options struct to set the attach comments value on.
+ * @param attach_comments The attach comments value to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_attach_comments_set(pm_options_t *options, bool attach_comments) PRISM_NONNULL(1);
+
+/**
+ * Get the mark newlines option on the given options struct.
+ *
+ * @param options The options struct to get the mark newlines value from.
+ * @returns The mark newlines value.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_options_mark_newlines(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the mark newlines option on the given options struct.
+ *
+ * @param options The options struct to set the mark newlines value on.
+ * @param mark_newlines The mark newlines value to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_mark_newlines_set(pm_options_t *options, bool mark_newlines) PRISM_NONNULL(1);
+
+/**
+ * Get the source strings option on the given options struct.
+ *
+ * @param options The options struct to get the source strings value from.
+ * @returns The source strings value.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_options_source_strings(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the source strings option on the given options struct. When it is set,
+ * string fields whose contents are a slice of the source are serialized as the
+ * offset of that slice instead of a copy of its bytes, so it should only be
+ * set when whatever loads the serialized output also holds the source.
+ *
+ * @param options The options struct to set the source strings value on.
+ * @param source_strings The source strings value to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_source_strings_set(pm_options_t *options, bool source_strings) PRISM_NONNULL(1);
+
+/**
+ * Get the discard comments option on the given options struct.
+ *
+ * @param options The options struct to get the discard comments value from.
+ * @returns The discard comments value.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_options_discard_comments(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the discard comments option on the given options struct. When it is set,
+ * the parser does not keep a list of the comments it lexes, for callers that
+ * never read them. Magic comments are still found and applied. It has no effect
+ * when the attach comments option is set, since that needs the comments.
+ *
+ * @param options The options struct to set the discard comments value on.
+ * @param discard_comments The discard comments value to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_discard_comments_set(pm_options_t *options, bool discard_comments) PRISM_NONNULL(1);
+
+/**
+ * Get the error limit option on the given options struct.
+ *
+ * @param options The options struct to get the error limit from.
+ * @returns The error limit, or 0 if there is none.
+ */
+PRISM_EXPORTED_FUNCTION uint32_t pm_options_error_limit(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the error limit option on the given options struct. Once the parser has
+ * found this many errors it stops reading the source, closes whatever is still
+ * open as if the source had ended there, and keeps only the first this many
+ * errors. This is meant for callers that only need to know whether and where
+ * the source is invalid. A value of 0 means there is no limit.
+ *
+ * @param options The options struct to set the error limit on.
+ * @param error_limit The error limit to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_error_limit_set(pm_options_t *options, uint32_t error_limit) PRISM_NONNULL(1);
+
+/**
+ * Get the syntax check option on the given options struct.
+ *
+ * @param options The options struct to get the syntax check value from.
+ * @returns The syntax check value.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_options_syntax_check(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the syntax check option on the given options struct. When it is set, the
+ * parser releases the nodes of each statement once the statement has been
+ * checked and nothing else can refer to it, so that memory use is bounded by
+ * the largest statement instead of the whole tree. Every error and warning is
+ * still reported, though not always in the same order, but the lists of
+ * statements in the returned tree may be missing all but their first and last
+ * statements, so it should only be used to check syntax.
+ *
+ * @param options The options struct to set the syntax check value on.
+ * @param syntax_check The syntax check value to set.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_syntax_check_set(pm_options_t *options, bool syntax_check) PRISM_NONNULL(1);
+
+/**
+ * Get the shared constant pool option on the given options struct.
+ *
+ * @param options The options struct to get the shared constant pool from.
+ * @returns The shared constant pool, or NULL if none was set.
+ */
+PRISM_EXPORTED_FUNCTION const pm_shared_constant_pool_t * pm_options_shared_constant_pool(const pm_options_t *options) PRISM_NONNULL(1);
+
+/**
+ * Set the shared constant pool option on the given options struct. The pool is
+ * not owned by the options, and must outlive every parser that is created with
+ * them. It cannot be passed through the serialized options.
+ *
+ * @param options The options struct to set the shared constant pool on.
+ * @param shared_constant_pool The shared constant pool to set, or NULL.
+ */
+PRISM_EXPORTED_FUNCTION void pm_options_shared_constant_pool_set(pm_options_t *options, const pm_shared_constant_pool_t *shared_constant_pool) PRISM_NONNULL(1);
+
 /**
  * Get the raise_error option on the given options struct.
  *
@@ -21,6 +21,24 @@
  */
 typedef struct pm_parser_t pm_parser_t;
 
+/**
+ * Whether the source is made up of valid characters in the encoding that it was
+ * parsed with, as far as the parser can tell.
+ */
+typedef enum {
+    /**
+     * The source contains bytes that are not ASCII and is in an encoding that
+     * the parser does not validate.
+     */
+    PM_ENCODING_VALIDITY_UNKNOWN = 0,
+
+    /** Every character in the source is valid. */
+    PM_ENCODING_VALIDITY_VALID = 1,
+
+    /** The source contains at least one invalid character. */
+    PM_ENCODING_VALIDITY_INVALID = 2
+} pm_encoding_validity_t;
+
 /**
  * Allocate and initialize a parser with the given start and end pointers.
  *
@@ -150,6 +168,16 @@ PRISM_EXPORTED_FUNCTION const pm_string_t * pm_parser_filepath(const pm_parser_t
  */
 PRISM_EXPORTED_FUNCTION pm_constant_id_t pm_parser_constant_find(const pm_parser_t *parser, const uint8_t *start, size_t length) PRISM_NONNULL(1, 2);
 
+/**
+ * Returns the shared constant pool that was given to the parser through its
+ * options. The constants with ids from 1 through the size of this pool are the
+ * constants of the shared pool.
+ *
+ * @param parser the parser whose shared constant pool we want to get
+ * @returns the shared constant pool, or NULL if none was given
+ */
+PRISM_EXPORTED_FUNCTION const pm_shared_constant_pool_t * pm_parser_shared_constant_pool(const pm_parser_t *parser) PRISM_NONNULL(1);
+
 /**
  * Returns the frozen string literal value of the parser, as determined by the
  * frozen_string_literal magic comment or the option set on the parser.
@@ -186,6 +214,42 @@ PRISM_EXPORTED_FUNCTION const pm_location_t * pm_parser_data_loc(const pm_parser
  */
 PRISM_EXPORTED_FUNCTION bool pm_parser_continuable(const pm_parser_t *parser) PRISM_NONNULL(1);
 
+/**
+ * Returns the offset of the first byte in the source that is not ASCII. This is
+ * computed the first time it is requested, and should only be requested once
+ * the source has been parsed. The result is cached on the parser, so this is
+ * not safe to call from multiple threads on the same parser at once.
+ *
+ * @param parser the parser whose source we want to check
+ * @returns the offset of the first byte that is not ASCII, or the length of
+ *     the source if every byte is ASCII
+ */
+PRISM_EXPORTED_FUNCTION uint32_t pm_parser_first_non_ascii(pm_parser_t *parser) PRISM_NONNULL(1);
+
+/**
+ * Returns whether every byte in the source is ASCII. This is computed the first
+ * time it is requested, and should only be requested once the source has been
+ * parsed. The result is cached on the parser, so this is not safe to call from
+ * multiple threads on the same parser at once.
+ *
+ * @param parser the parser whose source we want to check
+ * @returns whether every byte in the source is ASCII
+ */
+PRISM_EXPORTED_FUNCTION bool pm_parser_ascii_only(pm_parser_t *parser) PRISM_NONNULL(1);
+
+/**
+ * Returns whether the source is valid in the encoding that it was parsed with.
+ * ASCII-only sources are always valid. Otherwise the source is only checked
+ * when it is UTF-8 or US-ASCII. This is computed the first time it is requested,
+ * and should only be requested once the source has been parsed. The result is
+ * cached on the parser, so this is not safe to call from multiple threads on
+ * the same parser at once.
+ *
+ * @param parser the parser whose source we want to check
+ * @returns whether the source is valid in its encoding
+ */
+PRISM_EXPORTED_FUNCTION pm_encoding_validity_t pm_parser_encoding_validity(pm_parser_t *parser) PRISM_NONNULL(1);
+
 /**
  * Returns the lex state of the parser. Note that this is an internal detail,
  * and we are purposefully not returning an instance of the internal enum that
@@ -223,6 +287,21 @@ typedef void (*pm_comment_callback_t)(const pm_comment_t *comment, void *data);
  */
 PRISM_EXPORTED_FUNCTION void pm_parser_comments_each(const pm_parser_t *parser, pm_comment_callback_t callback, void *data) PRISM_NONNULL(1);
 
+/**
+ * Computes where each comment found while parsing should be attached in the
+ * given syntax tree, which must be the tree returned by parsing with the given
+ * parser. This is a native implementation of ParseResult#attach_comments! from
+ * the Ruby library that visits each node at most once and only descends into
+ * nodes that contain comments.
+ *
+ * @param parser the parser whose comments we want to attach
+ * @param node the root of the syntax tree returned by the parser
+ * @param attachments an array with room for pm_parser_comments_size(parser)
+ *     entries, which will be filled in with the attachment of each comment in
+ *     the order that the comments are yielded by pm_parser_comments_each
+ */
+PRISM_EXPORTED_FUNCTION void pm_parser_comments_attach(const pm_parser_t *parser, const pm_node_t *node, pm_comment_attachment_t *attachments) PRISM_NONNULL(1, 2);
+
 /**
  * Returns the number of magic comments associated with the given parser.
  *
@@ -337,6 +416,88 @@ PRISM_EXPORTED_FUNCTION void pm_parser_constants_each(const pm_parser_t *parser,
  */
 PRISM_EXPORTED_FUNCTION const pm_constant_t * pm_parser_constant(const pm_parser_t *parser, pm_constant_id_t constant_id) PRISM_NONNULL(1);
 
+#ifdef PRISM_STATS
+
+/**
+ * Counters and timings describing the work that a parser did. This is only
+ * available when prism is compiled with PRISM_STATS, and is meant to be used to
+ * find where parse time goes and to find inputs that take pathological paths
+ * through the parser.
+ */
+typedef struct {
+    /** The number of tokens lexed, indexed by pm_token_type_t. */
+    size_t tokens[PM_TOKEN_MAXIMUM];
+
+    /**
+     * The number of nanoseconds spent lexing tokens. Timing each token costs
+     * two clock reads, so this is only gathered when prism is also compiled
+     * with PRISM_STATS_LEX_TIME, and is 0 otherwise.
+     */
+    uint64_t lex_time;
+
+    /** The number of nanoseconds spent in pm_parse, including lexing. */
+    uint64_t parse_time;
+
+    /** The number of lex modes that were pushed. */
+    size_t lex_mode_pushes;
+
+    /** The number of heredoc bodies that were lexed. */
+    size_t heredocs;
+
+    /** The number of blocks allocated by the arena holding the tree. */
+    size_t ast_arena_blocks;
+
+    /** The number of bytes used in the arena holding the tree. */
+    size_t ast_arena_bytes;
+
+    /** The number of blocks allocated by the arena holding the metadata. */
+    size_t metadata_arena_blocks;
+
+    /** The number of bytes used in the arena holding the metadata. */
+    size_t metadata_arena_bytes;
+
+    /** The number of constants that were inserted or found in the pool. */
+    size_t constant_inserts;
+
+    /** The number of occupied buckets skipped while probing the pool. */
+    size_t constant_collisions;
+
+    /** The number of times the constant pool was resized. */
+    size_t constant_resizes;
+
+    /** The number of calls to pm_strpbrk. */
+    size_t strpbrk_calls;
+
+    /** The number of calls to pm_strpbrk answered by the vectorized scan. */
+    size_t strpbrk_accelerated;
+
+    /** The number of regular expressions that were validated. */
+    size_t regexp_validations;
+
+    /** The number of errors that were added. */
+    size_t errors;
+
+    /** The number of warnings that were added. */
+    size_t warnings;
+
+    /** The number of error recovery nodes that were created. */
+    size_t error_recovery_nodes;
+
+    /** The number of times the parser started recovering from an error. */
+    size_t recoveries;
+} pm_parser_stats_t;
+
+/**
+ * Copy the statistics gathered by the given parser into the given stats struct.
+ * This is only available when prism is compiled with PRISM_STATS.
+ *
+ * @param parser The parser to get the statistics of.
+ * @param stats The stats struct to fill in.
+ */
+PRISM_EXPORTED_FUNCTION void pm_parser_stats(const pm_parser_t *parser, pm_parser_stats_t *stats) PRISM_NONNULL(1, 2);
+
+#endif
+
 /**
  * Initiate the parser with the given parser.
  *
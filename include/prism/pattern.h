@@ -0,0 +1,97 @@
+/**
+ * @file pattern.h
+ *
+ * A native implementation of the pattern language of Prism::Pattern, which
+ * compiles a pattern into a small bytecode that is matched directly against the
+ * nodes of a tree without creating any Ruby objects.
+ */
+#ifndef PRISM_PATTERN_H
+#define PRISM_PATTERN_H
+
+#include "prism/compiler/exported.h"
+#include "prism/compiler/nodiscard.h"
+#include "prism/compiler/nonnull.h"
+
+#include "prism/ast.h"
+#include "prism/parser.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A compiled pattern. This is an opaque type that is created with
+ * pm_pattern_new and freed with pm_pattern_free.
+ */
+typedef struct pm_pattern_t pm_pattern_t;
+
+/**
+ * The result of matching a pattern against a node.
+ */
+typedef enum {
+    /** The node does not match the pattern. */
+    PM_PATTERN_MATCH_NONE,
+
+    /**
+     * The node may match the pattern, but that depends on something that
+     * cannot be checked natively (a regular expression, a constant that is not
+     * a node class, or a field that is not a node, constant, or string). The
+     * caller is responsible for checking the node itself.
+     */
+    PM_PATTERN_MATCH_MAYBE,
+
+    /** The node matches the pattern. */
+    PM_PATTERN_MATCH_EXACT
+} pm_pattern_match_t;
+
+/**
+ * The callback that is called by pm_pattern_scan for each node that matches or
+ * may match the pattern.
+ */
+typedef void (*pm_pattern_callback_t)(const pm_node_t *node, pm_pattern_match_t match, void *data);
+
+/**
+ * Compile the given query into a pattern. The query uses the same language as
+ * Prism::Pattern, which is a subset of the syntax accepted by the `in` clause
+ * of a `case` expression.
+ *
+ * @param query The query to compile.
+ * @param length The length of the query.
+ * @returns The compiled pattern, or NULL if the query is invalid or uses syntax
+ *   that is not supported. The caller is responsible for freeing the pattern
+ *   using pm_pattern_free.
+ */
+PRISM_EXPORTED_FUNCTION PRISM_NODISCARD pm_pattern_t * pm_pattern_new(const uint8_t *query, size_t length) PRISM_NONNULL(1);
+
+/**
+ * Free the given pattern.
+ *
+ * @param pattern The pattern to free.
+ */
+PRISM_EXPORTED_FUNCTION void pm_pattern_free(pm_pattern_t *pattern) PRISM_NONNULL(1);
+
+/**
+ * Returns whether every part of the given pattern can be checked natively,
+ * which is the case when it only refers to node classes and contains no regular
+ * expressions. Patterns that are not complete refer to constants that the
+ * caller must resolve to know whether the pattern is valid.
+ *
+ * @param pattern The pattern to check.
+ * @returns Whether the pattern is complete.
+ */
+PRISM_EXPORTED_FUNCTION bool pm_pattern_complete(const pm_pattern_t *pattern) PRISM_NONNULL(1);
+
+/**
+ * Walk the given tree breadth-first (in the same order as Prism::Pattern#scan)
+ * and call the given callback for each node that matches or may match the
+ * pattern.
+ *
+ * @param pattern The pattern to match.
+ * @param parser The parser that created the tree, used to resolve symbols.
+ * @param node The root of the tree to scan.
+ * @param callback The callback to call for each matching node.
+ * @param data The data to pass to the callback.
+ */
+PRISM_EXPORTED_FUNCTION void pm_pattern_scan(pm_pattern_t *pattern, const pm_parser_t *parser, const pm_node_t *node, pm_pattern_callback_t callback, void *data) PRISM_NONNULL(1, 2, 3, 4);
+
+#endif
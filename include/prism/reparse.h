@@ -0,0 +1,76 @@
+/**
+ * @file reparse.h
+ *
+ * Functions for parsing a source again after it has been edited.
+ */
+#ifndef PRISM_REPARSE_H
+#define PRISM_REPARSE_H
+
+#include "prism/compiler/exported.h"
+#include "prism/compiler/nonnull.h"
+
+#include "prism/arena.h"
+#include "prism/ast.h"
+#include "prism/options.h"
+#include "prism/parser.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A single edit to a source: the bytes from start up to start + old_length
+ * were replaced by new_length bytes. Offsets are in terms of the source after
+ * all of the edits before it have been applied.
+ */
+typedef struct {
+    /** The offset in bytes where the edit starts. */
+    uint32_t start;
+
+    /** The number of bytes that the edit replaced. */
+    uint32_t old_length;
+
+    /** The number of bytes that replaced them. */
+    uint32_t new_length;
+} pm_edit_t;
+
+/**
+ * Parse the source again after it has been changed by the given edits, reusing
+ * as much of the tree from the previous parse as possible.
+ *
+ * When the edits fall within a single method, class, module, or singleton class
+ * definition that can be parsed on its own, only that definition is parsed
+ * again. Its node in the tree is replaced, and everything else in the tree and
+ * on the parser (locations, comments, diagnostics, and line offsets) is moved
+ * across the edits in place, keeping its node ids. Otherwise the parser is
+ * freed, the arena is cleaned up, and the new source is parsed from scratch, in
+ * which case any pointers into the previous tree are no longer valid. Either
+ * way node ids are never reused, and pm_parser_reparsed_loc returns the part of
+ * the source that was parsed.
+ *
+ * The source that the parser was using must not be changed or freed until
+ * this function returns, and the new source must outlive the parser.
+ *
+ * @param parser The parser that parsed the previous source, which is replaced
+ *     with a new parser if the source has to be parsed from scratch.
+ * @param arena The arena that holds the tree from the previous parse.
+ * @param node The tree that was returned by the previous parse.
+ * @param source The source after the edits.
+ * @param size The size of the source after the edits.
+ * @param edits The edits that were made to the previous source, in order.
+ * @param edits_count The number of edits.
+ * @param options The options that the previous source was parsed with.
+ * @returns The tree representing the new source.
+ */
+PRISM_EXPORTED_FUNCTION pm_node_t * pm_reparse(pm_parser_t **parser, pm_arena_t *arena, pm_node_t *node, const uint8_t *source, size_t size, const pm_edit_t *edits, size_t edits_count, const pm_options_t *options) PRISM_NONNULL(1, 2, 3, 4);
+
+/**
+ * Returns the location of the part of the source that was parsed the last time
+ * the given parser parsed anything, which is the whole source unless the last
+ * call to pm_reparse was able to reparse a single definition.
+ *
+ * @param parser The parser to get the reparsed location of.
+ * @returns The location of the part of the source that was parsed.
+ */
+PRISM_EXPORTED_FUNCTION const pm_location_t * pm_parser_reparsed_loc(const pm_parser_t *parser) PRISM_NONNULL(1);
+
+#endif
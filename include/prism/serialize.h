@@ -31,6 +31,17 @@
  */
 PRISM_EXPORTED_FUNCTION void pm_serialize(pm_parser_t *parser, pm_node_t *node, pm_buffer_t *buffer) PRISM_NONNULL(1, 2, 3);
 
+/**
+ * Serialize the errors found by the given parser to the given buffer, as the
+ * number of errors followed by one compact record for each error in the order
+ * that they were found. This is the format written by
+ * pm_serialize_parse_errors.
+ *
+ * @param parser The parser whose errors should be serialized.
+ * @param buffer The buffer to serialize to.
+ */
+PRISM_EXPORTED_FUNCTION void pm_serialize_compact_errors(pm_parser_t *parser, pm_buffer_t *buffer) PRISM_NONNULL(1, 2);
+
 /**
  * Parse the given source to the AST and dump the AST to the given buffer.
  *
@@ -84,6 +95,7 @@ PRISM_EXPORTED_FUNCTION void pm_serialize_parse_lex(pm_buffer_t *buffer, const u
 
 /**
  * Parse the source and return true if it parses without errors or warnings.
+ * This sets the syntax check option, since the tree is never looked at.
  *
  * @param source The source to parse.
  * @param size The size of the source.
@@ -92,6 +104,20 @@ PRISM_EXPORTED_FUNCTION void pm_serialize_parse_lex(pm_buffer_t *buffer, const u
  */
 PRISM_EXPORTED_FUNCTION bool pm_serialize_parse_success_p(const uint8_t *source, size_t size, const char *data) PRISM_NONNULL(1);
 
+/**
+ * Parse the given source and serialize only the errors that are encountered to
+ * the given buffer, as the number of errors followed by one compact record for
+ * each error in the order that they were found. This is cheaper than
+ * serializing the whole tree or formatting the errors, for callers that render
+ * the errors themselves. It is best combined with the error limit option.
+ *
+ * @param buffer The buffer to serialize to.
+ * @param source The source to parse.
+ * @param size The size of the source.
+ * @param data The optional data to pass to the parser.
+ */
+PRISM_EXPORTED_FUNCTION void pm_serialize_parse_errors(pm_buffer_t *buffer, const uint8_t *source, size_t size, const char *data) PRISM_NONNULL(1, 2);
+
 /**
  * Parse the given source and format any errors that are encountered into the
  * given buffer using the given format type. If the source parses without any
@@ -151,6 +151,28 @@ public abstract class ParsingOptions {
         // freeze
         output.write(0);
 
+        // attachComments, which does not apply because comments are not
+        // included when serializing for Java
+        output.write(0);
+
+        // markNewlines, which is always set because the Loader relies on the
+        // parser to set the newline flags
+        output.write(1);
+
+        // sourceStrings, which does not apply because the Loader reads string
+        // contents from the serialized buffer rather than the source
+        output.write(0);
+
+        // discardComments, which is always set because comments are not
+        // included when serializing for Java
+        output.write(1);
+
+        // errorLimit, which is never set so that the whole source is parsed
+        write(output, serializeInt(0));
+
+        // syntaxCheck, which is never set since the tree is always loaded
+        output.write(0);
+
         // scopes
 
         // number of scopes
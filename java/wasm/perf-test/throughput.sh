@@ -0,0 +1,6 @@
+#! /bin/bash
+set -euxo pipefail
+
+SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
+
+jbang --fresh ${SCRIPT_DIR}/throughput "$@"
@@ -15,6 +15,15 @@ public class Prism implements AutoCloseable {
     protected final Prism_ModuleExports exports;
     private final RedlineInstance instance;
 
+    // Allocations in the wasm heap that are kept between calls to
+    // serializeParse, so that parsing many files on one instance does not
+    // malloc and free them for every file. They only ever grow.
+    private Buffer reusableBuffer;
+    private int sourcePointer;
+    private int sourceCapacity;
+    private int optionsPointer;
+    private int optionsCapacity;
+
     public Prism() {
         this(WasiOptions.builder().build());
     }
@@ -141,13 +150,55 @@ public class Prism implements AutoCloseable {
     }
 
     public ParseResult serializeParse(byte[] packedOptions, String source) {
-        var sourceBytes = source.getBytes(StandardCharsets.ISO_8859_1);
-        byte[] result = parse(sourceBytes, 0, sourceBytes.length, packedOptions);
-        return Loader.load(result);
+        return serializeParse(packedOptions, source.getBytes(StandardCharsets.ISO_8859_1));
+    }
+
+    public ParseResult serializeParse(byte[] packedOptions, byte[] sourceBytes) {
+        return serializeParse(packedOptions, sourceBytes, 0, sourceBytes.length);
+    }
+
+    /**
+     * Parse the given slice of source bytes and load the result. Unlike parse,
+     * this reuses the serialization buffer and the source and options
+     * allocations of previous calls on this instance, and the serialized bytes
+     * are copied out of linear memory exactly once, straight into the Loader.
+     */
+    public ParseResult serializeParse(byte[] packedOptions, byte[] sourceBytes, int sourceOffset, int sourceLength) {
+        if (reusableBuffer == null) {
+            reusableBuffer = new Buffer();
+        } else {
+            reusableBuffer.clear();
+        }
+
+        if (sourceCapacity < sourceLength + 1) {
+            exports.free(sourcePointer);
+            sourceCapacity = Math.max(sourceLength + 1, sourceCapacity * 2);
+            sourcePointer = exports.calloc(1, sourceCapacity);
+        }
+
+        if (optionsCapacity < packedOptions.length) {
+            exports.free(optionsPointer);
+            optionsCapacity = packedOptions.length;
+            optionsPointer = exports.calloc(1, optionsCapacity);
+        }
+
+        var memory = instance.memory();
+        memory.write(sourcePointer, sourceBytes, sourceOffset, sourceLength);
+        memory.writeByte(sourcePointer + sourceLength, (byte) 0);
+        memory.write(optionsPointer, packedOptions);
+
+        exports.pmSerializeParse(reusableBuffer.pointer, sourcePointer, sourceLength, optionsPointer);
+        return Loader.load(reusableBuffer.read());
     }
 
     @Override
     public void close() {
+        if (reusableBuffer != null) {
+            reusableBuffer.close();
+            reusableBuffer = null;
+            exports.free(sourcePointer);
+            exports.free(optionsPointer);
+        }
         if (instance != null) {
             instance.close();
         }
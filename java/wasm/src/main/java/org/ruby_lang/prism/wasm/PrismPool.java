@@ -0,0 +1,75 @@
+package org.ruby_lang.prism.wasm;
+
+import org.ruby_lang.prism.ParseResult;
+
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.function.Supplier;
+
+/**
+ * A pool of warm Prism instances, one per thread that uses it. Instantiating
+ * the wasm module and growing its heap are fixed costs that dominate parsing
+ * small files, so each thread keeps its own instance (and with it the buffers
+ * that Prism#serializeParse reuses) for as long as the pool is open.
+ *
+ * Instances are not shared between threads, so no locking happens on the parse
+ * path.
+ */
+public class PrismPool implements AutoCloseable {
+    private final Supplier<Prism> factory;
+    private final ConcurrentLinkedQueue<Prism> instances = new ConcurrentLinkedQueue<>();
+    private final ThreadLocal<Prism> local = ThreadLocal.withInitial(this::create);
+    private volatile boolean closed = false;
+
+    public PrismPool() {
+        this(Prism::new);
+    }
+
+    public PrismPool(Supplier<Prism> factory) {
+        this.factory = factory;
+    }
+
+    /**
+     * Return the instance owned by the current thread, creating it on first
+     * use. The instance must not be handed to another thread or closed
+     * directly.
+     */
+    public Prism get() {
+        if (closed) {
+            throw new IllegalStateException("PrismPool is closed");
+        }
+
+        return local.get();
+    }
+
+    public ParseResult serializeParse(byte[] packedOptions, byte[] sourceBytes) {
+        return get().serializeParse(packedOptions, sourceBytes);
+    }
+
+    public ParseResult serializeParse(byte[] packedOptions, String source) {
+        return get().serializeParse(packedOptions, source);
+    }
+
+    /**
+     * The number of instances created so far, which is the number of distinct
+     * threads that have parsed through this pool.
+     */
+    public int size() {
+        return instances.size();
+    }
+
+    private Prism create() {
+        Prism prism = factory.get();
+        instances.add(prism);
+        return prism;
+    }
+
+    @Override
+    public void close() {
+        closed = true;
+
+        Prism prism;
+        while ((prism = instances.poll()) != null) {
+            prism.close();
+        }
+    }
+}
@@ -1,12 +1,15 @@
 package org.jruby.parser.prism;
 
 import org.junit.jupiter.api.Test;
+import org.ruby_lang.prism.Loader;
 import org.ruby_lang.prism.ParseResult;
 import org.ruby_lang.prism.ParsingOptions;
 import org.ruby_lang.prism.wasm.Prism;
+import org.ruby_lang.prism.wasm.PrismPool;
 
 import java.nio.charset.StandardCharsets;
 import java.util.EnumSet;
+import java.util.concurrent.atomic.AtomicInteger;
 
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertTrue;
@@ -74,6 +77,47 @@ public class WASMTest {
         assertTrue(pr.value.childNodes()[0].toString().contains("hell\\xc3\\xb8"));
     }
 
+    @Test
+    public void testReusedBuffers() {
+        var sources = new String[] { "foo(bar, baz)\n" + "x = 1\n".repeat(1000), "1 + 1", "puts \"hello\"" };
+
+        try (Prism prism = new Prism()) {
+            for (var source : sources) {
+                ParseResult reused = prism.serializeParse(packedOptions, source);
+                ParseResult fresh = Loader.load(prism.parse(source.getBytes(StandardCharsets.ISO_8859_1), packedOptions));
+
+                assertEquals(fresh.value.toString(), reused.value.toString());
+            }
+        }
+    }
+
+    @Test
+    public void testPool() throws Exception {
+        try (PrismPool pool = new PrismPool()) {
+            var threads = new Thread[4];
+            var failures = new AtomicInteger();
+
+            for (int index = 0; index < threads.length; index++) {
+                threads[index] = new Thread(() -> {
+                    for (int iteration = 0; iteration < 10; iteration++) {
+                        ParseResult pr = pool.serializeParse(packedOptions, "1 + 1");
+                        if (!pr.value.childNodes()[0].toString().contains("IntegerNode")) {
+                            failures.incrementAndGet();
+                        }
+                    }
+                });
+                threads[index].start();
+            }
+
+            for (var thread : threads) {
+                thread.join();
+            }
+
+            assertEquals(0, failures.get());
+            assertEquals(threads.length, pool.size());
+        }
+    }
+
     @Test
     public void testVersion() {
         try (Prism prism = new Prism()) {
@@ -0,0 +1,85 @@
+// Reports the size, instantiation time, and parse throughput of each wasm
+// profile built by `make wasm-profiles`. Pass file paths to parse those instead
+// of the fixtures.
+//
+//     make wasm-profiles && node javascript/bench.js [file ...]
+
+import { WASI } from "wasi";
+import { readFile, readdir, stat } from "node:fs/promises";
+import { fileURLToPath } from "node:url";
+import { join } from "node:path";
+import { performance } from "node:perf_hooks";
+
+import { parsePrism } from "./src/parsePrism.js";
+
+const root = fileURLToPath(new URL("..", import.meta.url));
+const profiles = ["full", "lean", "tiny"];
+const iterations = 20;
+
+async function collect(directory, extension) {
+  const filepaths = [];
+
+  for (const entry of await readdir(directory, { withFileTypes: true })) {
+    const filepath = join(directory, entry.name);
+
+    if (entry.isDirectory()) {
+      filepaths.push(...await collect(filepath, extension));
+    } else if (entry.name.endsWith(extension)) {
+      filepaths.push(filepath);
+    }
+  }
+
+  return filepaths.sort();
+}
+
+async function instantiate(bytes) {
+  const wasm = await WebAssembly.compile(bytes);
+  const wasi = new WASI({ version: "preview1" });
+  const instance = await WebAssembly.instantiate(wasm, wasi.getImportObject());
+
+  wasi.initialize(instance);
+  return instance;
+}
+
+const filepaths = process.argv.length > 2 ? process.argv.slice(2) : await collect(join(root, "test/prism/fixtures"), ".txt");
+const sources = await Promise.all(filepaths.map((filepath) => readFile(filepath, "utf8")));
+const totalBytes = sources.reduce((sum, source) => sum + Buffer.byteLength(source), 0);
+
+console.log(`Parsing ${sources.length} files (${totalBytes} bytes) ${iterations} times per profile\n`);
+console.log("profile      size (bytes)   instantiate (ms)   parse (ms)   MB/s");
+
+for (const profile of profiles) {
+  const filepath = join(root, "build/wasm", `prism-${profile}.wasm`);
+
+  let size;
+  try {
+    size = (await stat(filepath)).size;
+  } catch {
+    console.log(`${profile.padEnd(12)} not built, run \`make wasm-profiles\``);
+    continue;
+  }
+
+  const bytes = await readFile(filepath);
+
+  let instance;
+  let instantiateTime = Infinity;
+
+  for (let index = 0; index < iterations; index++) {
+    const start = performance.now();
+    instance = await instantiate(bytes);
+    instantiateTime = Math.min(instantiateTime, performance.now() - start);
+  }
+
+  let parseTime = Infinity;
+  for (let index = 0; index < iterations; index++) {
+    const start = performance.now();
+    for (const source of sources) parsePrism(instance.exports, source);
+    parseTime = Math.min(parseTime, performance.now() - start);
+  }
+
+  const throughput = (totalBytes / (1024 * 1024)) / (parseTime / 1000);
+
+  console.log(
+    `${profile.padEnd(12)} ${String(size).padStart(12)}   ${instantiateTime.toFixed(2).padStart(16)}   ${parseTime.toFixed(1).padStart(10)}   ${throughput.toFixed(1).padStart(4)}`
+  );
+}
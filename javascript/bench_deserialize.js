@@ -0,0 +1,82 @@
+// Compares eager deserialization (parsePrism) against lazy deserialization
+// (parsePrismLazy) using javascript/src/prism.wasm. By default it parses every
+// Ruby file in lib/, pass file paths to parse those instead.
+//
+//     make wasm && node javascript/bench_deserialize.js [file ...]
+
+import { readFile, readdir } from "node:fs/promises";
+import { fileURLToPath } from "node:url";
+import { join } from "node:path";
+import { performance } from "node:perf_hooks";
+import { WASI } from "wasi";
+
+import { parsePrism, parsePrismLazy } from "./src/parsePrism.js";
+
+const root = fileURLToPath(new URL("..", import.meta.url));
+const iterations = 10;
+
+async function collect(directory, extension) {
+  const filepaths = [];
+
+  for (const entry of await readdir(directory, { withFileTypes: true })) {
+    const filepath = join(directory, entry.name);
+
+    if (entry.isDirectory()) {
+      filepaths.push(...await collect(filepath, extension));
+    } else if (entry.name.endsWith(extension)) {
+      filepaths.push(filepath);
+    }
+  }
+
+  return filepaths.sort();
+}
+
+// Visit every node in the tree, which forces the lazy tree to materialize.
+function walk(node) {
+  let count = 1;
+
+  for (const child of node.compactChildNodes()) {
+    count += walk(child);
+  }
+
+  return count;
+}
+
+// Visit only the top-level statements, which is typical of tools that only
+// look at the outline of a file.
+function outline(node) {
+  return node.statements.body.length;
+}
+
+const wasm = await WebAssembly.compile(await readFile(join(root, "javascript/src/prism.wasm")));
+const wasi = new WASI({ version: "preview1" });
+const instance = await WebAssembly.instantiate(wasm, wasi.getImportObject());
+wasi.initialize(instance);
+
+const filepaths = process.argv.length > 2 ? process.argv.slice(2) : await collect(join(root, "lib"), ".rb");
+const sources = await Promise.all(filepaths.map((filepath) => readFile(filepath, "utf8")));
+const totalBytes = sources.reduce((sum, source) => sum + Buffer.byteLength(source), 0);
+
+console.log(`Parsing ${sources.length} files (${totalBytes} bytes), best of ${iterations}\n`);
+
+const cases = [
+  ["eager, parse only", parsePrism, () => {}],
+  ["lazy, parse only", parsePrismLazy, () => {}],
+  ["eager, outline", parsePrism, outline],
+  ["lazy, outline", parsePrismLazy, outline],
+  ["eager, full walk", parsePrism, walk],
+  ["lazy, full walk", parsePrismLazy, walk]
+];
+
+for (const [name, parse, visit] of cases) {
+  let best = Infinity;
+
+  for (let iteration = 0; iteration < iterations; iteration++) {
+    const start = performance.now();
+    for (const source of sources) visit(parse(instance.exports, source).value);
+    best = Math.min(best, performance.now() - start);
+  }
+
+  const throughput = (totalBytes / (1024 * 1024)) / (best / 1000);
+  console.log(`${name.padEnd(20)} ${best.toFixed(1).padStart(10)} ms ${throughput.toFixed(1).padStart(8)} MB/s`);
+}
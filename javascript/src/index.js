@@ -3,26 +3,31 @@ import { readFile } from "node:fs/promises";
 import { fileURLToPath } from "node:url";
 
 import { ParseResult } from "./deserialize.js";
-import { parsePrism } from "./parsePrism.js";
+import { parsePrism, parsePrismLazy } from "./parsePrism.js";
 
 export * from "./visitor.js";
 export * from "./nodes.js";
 
 /**
- * Load the prism wasm module and return a parse function.
+ * Load the prism wasm module and return a parse function. If `lazy` is true,
+ * the returned function creates each node only when it is first accessed (see
+ * parsePrismLazy).
  *
  * @typedef {import("./parsePrism.js").Options} Options
  *
+ * @param {{ lazy?: boolean }} loadOptions
  * @returns {Promise<(source: string, options?: Options) => ParseResult>}
  */
-export async function loadPrism() {
+export async function loadPrism({ lazy = false } = {}) {
   const wasm = await WebAssembly.compile(await readFile(fileURLToPath(new URL("prism.wasm", import.meta.url))));
   const wasi = new WASI({ version: "preview1" });
 
   const instance = await WebAssembly.instantiate(wasm, wasi.getImportObject());
   wasi.initialize(instance);
 
+  const parse = lazy ? parsePrismLazy : parsePrism;
+
   return function (source, options = {}) {
-    return parsePrism(instance.exports, source, options);
+    return parse(instance.exports, source, options);
   }
 }
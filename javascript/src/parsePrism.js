@@ -1,4 +1,18 @@
-import { ParseResult, deserialize } from "./deserialize.js";
+import { ParseResult, deserialize, deserializeLazy } from "./deserialize.js";
+
+/**
+ * The encoder used to write source strings into wasm memory.
+ */
+const encoder = new TextEncoder();
+
+/**
+ * The source and output buffers for each wasm instance, which are reused across
+ * calls to avoid allocating them for every parse. They grow to fit the largest
+ * source seen so far and are held for the lifetime of the instance.
+ *
+ * @type {WeakMap<WebAssembly.Exports, { sourcePointer: number, sourceCapacity: number, bufferPointer: number }>}
+ */
+const buffers = new WeakMap();
 
 /**
  * Parse the given source code.
@@ -17,6 +31,11 @@ import { ParseResult, deserialize } from "./deserialize.js";
  *   version?: string,
  *   main_script?: boolean,
  *   partial_script?: boolean,
+ *   attach_comments?: boolean,
+ *   mark_newlines?: boolean,
+ *   discard_comments?: boolean,
+ *   error_limit?: number,
+ *   syntax_check?: boolean,
  *   scopes?: (string[] | Scope)[]
  * }} Options<C>
  *
@@ -26,27 +45,65 @@ import { ParseResult, deserialize } from "./deserialize.js";
  * @returns {ParseResult}
  */
 export function parsePrism(prism, source, options = {}) {
-  const sourceArray = new TextEncoder().encode(source);
-  const sourcePointer = prism.calloc(1, sourceArray.length);
+  return serializeParse(prism, source, options, deserialize);
+}
+
+/**
+ * Parse the given source code, returning a tree whose nodes are only created
+ * when they are first accessed. This is much faster than parsePrism when only
+ * part of the tree is visited. The serialized result is copied out of wasm
+ * memory, so the tree remains valid across subsequent parses.
+ *
+ * @param {WebAssembly.Exports} prism
+ * @param {string} source
+ * @param {Options} options
+ * @returns {ParseResult}
+ */
+export function parsePrismLazy(prism, source, options = {}) {
+  return serializeParse(prism, source, options, (serialized) => deserializeLazy(serialized.slice()));
+}
+
+/**
+ * Serialize the parse of the given source code into the reusable output buffer
+ * and pass a view of it to the given callback.
+ *
+ * @param {WebAssembly.Exports} prism
+ * @param {string} source
+ * @param {Options} options
+ * @param {(serialized: Uint8Array) => ParseResult} callback
+ * @returns {ParseResult}
+ */
+function serializeParse(prism, source, options, callback) {
+  let state = buffers.get(prism);
+  if (state === undefined) {
+    state = { sourcePointer: 0, sourceCapacity: 0, bufferPointer: prism.pm_buffer_new() };
+    buffers.set(prism, state);
+  }
+
+  // Every UTF-16 code unit encodes to at most 3 bytes of UTF-8, so this is
+  // always enough room to encode the source directly into wasm memory.
+  const sourceCapacity = Math.max(source.length * 3, 1);
+  if (sourceCapacity > state.sourceCapacity) {
+    if (state.sourcePointer !== 0) prism.free(state.sourcePointer);
+    state.sourcePointer = prism.calloc(1, sourceCapacity);
+    state.sourceCapacity = sourceCapacity;
+  }
+
+  const sourceView = new Uint8Array(prism.memory.buffer, state.sourcePointer, state.sourceCapacity);
+  const { written: sourceLength } = encoder.encodeInto(source, sourceView);
 
   const packedOptions = dumpOptions(options);
   const optionsPointer = prism.calloc(1, packedOptions.length);
-  const bufferPointer = prism.pm_buffer_new();
-
-  const sourceView = new Uint8Array(prism.memory.buffer, sourcePointer, sourceArray.length);
-  sourceView.set(sourceArray);
 
   const optionsView = new Uint8Array(prism.memory.buffer, optionsPointer, packedOptions.length);
   optionsView.set(packedOptions);
 
-  prism.pm_serialize_parse(bufferPointer, sourcePointer, sourceArray.length, optionsPointer);
-  const serializedView = new Uint8Array(prism.memory.buffer, prism.pm_buffer_value(bufferPointer), prism.pm_buffer_length(bufferPointer));
-  const result = deserialize(serializedView);
-
-  prism.pm_buffer_free(bufferPointer);
-  prism.free(sourcePointer);
+  prism.pm_buffer_clear(state.bufferPointer);
+  prism.pm_serialize_parse(state.bufferPointer, state.sourcePointer, sourceLength, optionsPointer);
   prism.free(optionsPointer);
-  return result;
+
+  const serializedView = new Uint8Array(prism.memory.buffer, prism.pm_buffer_value(state.bufferPointer), prism.pm_buffer_length(state.bufferPointer));
+  return callback(serializedView);
 }
 
 /**
@@ -104,9 +161,6 @@ function dumpOptions(options) {
   /** @type {PackValues} */
   const values = [];
 
-  /** @type {TextEncoder} */
-  const encoder = new TextEncoder();
-
   template.push("L")
   if (options.filepath) {
     const filepath = encoder.encode(options.filepath);
@@ -163,6 +217,26 @@ function dumpOptions(options) {
   template.push("C");
   values.push(0);
 
+  template.push("C");
+  values.push(dumpBooleanOption(options.attach_comments));
+
+  template.push("C");
+  values.push(dumpBooleanOption(options.mark_newlines));
+
+  // source_strings, which is never set because the loader does not hold on to
+  // the source to slice strings from
+  template.push("C");
+  values.push(0);
+
+  template.push("C");
+  values.push(dumpBooleanOption(options.discard_comments));
+
+  template.push("L");
+  values.push(options.error_limit || 0);
+
+  template.push("C");
+  values.push(dumpBooleanOption(options.syntax_check));
+
   template.push("L");
   if (options.scopes) {
     const scopes = options.scopes;
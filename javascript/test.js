@@ -5,6 +5,7 @@ import * as nodes from "./src/nodes.js";
 import { Visitor } from "./src/visitor.js";
 
 const parse = await loadPrism();
+const parseLazy = await loadPrism({ lazy: true });
 
 function statement(result) {
   return result.value.statements.body[0];
@@ -259,3 +260,23 @@ test("visitor visits nodes inside node list fields", () => {
   assert.deepStrictEqual(collect("begin\n  a\nrescue B\n  c\nend"), ["a", "c"]);
   assert.deepStrictEqual(collect("def foo(a = b); end"), ["b"]);
 });
+
+test("lazy parse matches eager parse", () => {
+  const replacer = (key, value) => typeof value === "bigint" ? value.toString() : value;
+
+  for (const source of ["foo.bar(1, *baz) { |x| x + 2 }", "class A < B; def c(d = 1r) = e; end", "case a\nin [b, *] then 0xffffffffffffffff\nend"]) {
+    assert.strictEqual(JSON.stringify(parseLazy(source), replacer), JSON.stringify(parse(source), replacer));
+  }
+});
+
+test("lazy parse results survive later parses", () => {
+  const first = parseLazy("foo(bar)");
+  parseLazy("baz(" + "qux, ".repeat(1000) + ")");
+
+  assert.strictEqual(statement(first).arguments_.arguments_[0].name, "bar");
+});
+
+test("reused buffers handle shrinking sources", () => {
+  parse("a".repeat(10000));
+  assert.strictEqual(statement(parse("foo")).name, "foo");
+});
@@ -20,6 +20,7 @@ module Prism
   autoload :Dispatcher, "prism/dispatcher"
   autoload :DotVisitor, "prism/dot_visitor"
   autoload :DSL, "prism/dsl"
+  autoload :IncrementalParser, "prism/incremental_parser"
   autoload :InspectVisitor, "prism/inspect_visitor"
   autoload :LexCompat, "prism/lex_compat"
   autoload :MutationCompiler, "prism/mutation_compiler"
@@ -28,6 +29,7 @@ module Prism
   autoload :Reflection, "prism/reflection"
   autoload :Relocation, "prism/relocation"
   autoload :Serialize, "prism/serialize"
+  autoload :SharedConstantPool, "prism/shared_constant_pool"
   autoload :StringQuery, "prism/string_query"
   autoload :Translation, "prism/translation"
   autoload :Visitor, "prism/visitor"
@@ -85,6 +87,16 @@ module Prism
     Serialize.load_parse(source, serialized, freeze)
   end
 
+  # :call-seq:
+  #   load_errors(serialized, freeze) -> Array[CompactError]
+  #
+  # Load the compact errors serialized by Prism.dump_errors.
+  #--
+  #: (String serialized, ?bool freeze) -> Array[CompactError]
+  def self.load_errors(serialized, freeze = false)
+    Serialize.load_errors(serialized, freeze)
+  end
+
   # Given a Method, UnboundMethod, Proc, or Thread::Backtrace::Location,
   # returns the Prism node representing it. On CRuby, this uses node_id for
   # an exact match. On other implementations, it falls back to best-effort
@@ -103,23 +115,26 @@ module Prism
   #      def gets: (?Integer integer) -> (String | nil)
   #    end
   #
-  #    def self.parse:               (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> ParseResult
-  #    def self.profile:             (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> void
-  #    def self.lex:                 (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> LexResult
-  #    def self.parse_lex:           (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> ParseLexResult
-  #    def self.dump:                (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> String
-  #    def self.parse_comments:      (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> Array[Comment]
-  #    def self.parse_success?:      (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> bool
-  #    def self.parse_failure?:      (String source,  ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> bool
-  #    def self.parse_stream:        (_Stream stream, ?filepath: String, ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> ParseResult
-  #    def self.parse_file:          (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> ParseResult
-  #    def self.profile_file:        (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> void
-  #    def self.lex_file:            (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> LexResult
-  #    def self.parse_lex_file:      (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> ParseLexResult
-  #    def self.dump_file:           (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> String
-  #    def self.parse_file_comments: (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> Array[Comment]
-  #    def self.parse_file_success?: (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> bool
-  #    def self.parse_file_failure?: (String filepath,                   ?command_line: String, ?encoding: Encoding | false, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?version: String) -> bool
+  #    def self.parse:               (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> ParseResult
+  #    def self.profile:             (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> void
+  #    def self.lex:                 (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> LexResult
+  #    def self.parse_lex:           (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> ParseLexResult
+  #    def self.dump:                (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> String
+  #    def self.dump_errors:         (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> String
+  #    def self.parse_comments:      (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> Array[Comment]
+  #    def self.parse_success?:      (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> bool
+  #    def self.parse_failure?:      (String source,  ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> bool
+  #    def self.scan:                (String source,  String | Pattern pattern, ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> Array[node]
+  #    def self.parse_events:        (String source,  Array[Symbol] types, ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> Array[node | bool]
+  #    def self.parse_stream:        (_Stream stream, ?filepath: String, ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> ParseResult
+  #    def self.parse_file:          (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> ParseResult
+  #    def self.profile_file:        (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> void
+  #    def self.lex_file:            (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> LexResult
+  #    def self.parse_lex_file:      (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> ParseLexResult
+  #    def self.dump_file:           (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> String
+  #    def self.parse_file_comments: (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> Array[Comment]
+  #    def self.parse_file_success?: (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> bool
+  #    def self.parse_file_failure?: (String filepath,                   ?attach_comments: bool, ?command_line: String, ?constant_pool: SharedConstantPool, ?discard_comments: bool, ?encoding: Encoding | false, ?error_limit: Integer, ?freeze: bool, ?frozen_string_literal: bool, ?line: Integer, ?main_script: bool, ?mark_newlines: bool, ?partial_script: bool, ?raise_error: Symbol | true, ?scopes: Array[Array[Symbol]], ?source_strings: bool, ?syntax_check: bool, ?version: String) -> bool
 end
 
 require_relative "prism/polyfill/byteindex"
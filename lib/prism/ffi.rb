@@ -113,6 +113,7 @@ module Prism # :nodoc:
       "pm_serialize_lex",
       "pm_serialize_parse_lex",
       "pm_serialize_parse_success_p",
+      "pm_serialize_parse_errors",
       "pm_serialize_parse_errors_format",
       []
     )
@@ -269,6 +270,20 @@ module Prism # :nodoc:
       LibRubyParser::PrismSource.with_file(filepath) { |string| dump_common(string, options) }
     end
 
+    # Mirror the Prism.dump_errors API by using the serialization API.
+    def dump_errors(source, **options)
+      LibRubyParser::PrismSource.with_string(source) do |string|
+        LibRubyParser::PrismBuffer.with do |buffer|
+          LibRubyParser.pm_serialize_parse_errors(buffer.pointer, string.pointer, string.length, dump_options(options))
+
+          dumped = buffer.read
+          dumped.freeze if options.fetch(:freeze, false)
+
+          dumped
+        end
+      end
+    end
+
     # Mirror the Prism.lex API by using the serialization API.
     def lex(code, **options)
       LibRubyParser::PrismSource.with_string(code) { |string| lex_common(string, code, options) }
@@ -324,7 +339,7 @@ module Prism # :nodoc:
 
         pm_source = LibRubyParser.pm_source_stream_new(nil, callback, eof_callback)
         begin
-          LibRubyParser.pm_serialize_parse_stream(buffer.pointer, pm_source, dump_options(options))
+          LibRubyParser.pm_serialize_parse_stream(buffer.pointer, pm_source, dump_options({ source_strings: true, **options }))
           result = Prism.load(source, buffer.read, options.fetch(:freeze, false))
 
           if format_type && result.failure?
@@ -385,6 +400,30 @@ module Prism # :nodoc:
       !parse_file_success?(filepath, **options)
     end
 
+    # Mirror the Prism.scan API by parsing the whole tree and matching it with
+    # the Ruby pattern matcher.
+    def scan(code, pattern, **options)
+      pattern = Pattern.new(pattern) if pattern.is_a?(String)
+      raise TypeError, "wrong argument type #{pattern.class} (expected String or Prism::Pattern)" unless pattern.is_a?(Pattern)
+
+      value = pattern.scan(parse(code, **options).value).to_a
+      options[:freeze] ? value.freeze : value
+    end
+
+    # Mirror the Prism.parse_events API by parsing the whole tree and walking
+    # it in Ruby.
+    def parse_events(code, types, **options)
+      classes = types.map do |type|
+        klass = Prism.const_get(type) if type.is_a?(Symbol) && Prism.const_defined?(type, false)
+        raise ArgumentError, "unknown node type: #{type}" unless klass.is_a?(Class) && klass < Node
+        klass
+      end
+
+      events = [] #: Array[untyped]
+      parse_events_walk(parse(code, **options).value, classes, events)
+      options[:freeze] ? events.freeze : events
+    end
+
     # Mirror the Prism.profile API by using the serialization API.
     def profile(source, **options)
       LibRubyParser::PrismSource.with_string(source) do |string|
@@ -393,7 +432,7 @@ module Prism # :nodoc:
         end
 
         LibRubyParser::PrismBuffer.with do |buffer|
-          LibRubyParser.pm_serialize_parse(buffer.pointer, string.pointer, string.length, dump_options(options))
+          LibRubyParser.pm_serialize_parse(buffer.pointer, string.pointer, string.length, dump_options({ discard_comments: true, **options }))
           nil
         end
       end
@@ -409,7 +448,7 @@ module Prism # :nodoc:
         end
 
         LibRubyParser::PrismBuffer.with do |buffer|
-          LibRubyParser.pm_serialize_parse(buffer.pointer, string.pointer, string.length, dump_options(options))
+          LibRubyParser.pm_serialize_parse(buffer.pointer, string.pointer, string.length, dump_options({ discard_comments: true, **options }))
           nil
         end
       end
@@ -417,6 +456,13 @@ module Prism # :nodoc:
 
     private
 
+    def parse_events_walk(node, classes, events) # :nodoc:
+      subscribed = classes.include?(node.class)
+      events << node << true if subscribed
+      node.compact_child_nodes.each { |child| parse_events_walk(child, classes, events) }
+      events << node << false if subscribed
+    end
+
     def dump_common(string, options) # :nodoc:
       if (format_type = raise_error_format_type(options))
         raise_error(string, options, format_type)
@@ -446,7 +492,10 @@ module Prism # :nodoc:
 
     def parse_common(string, code, options) # :nodoc:
       format_type = raise_error_format_type(options)
-      serialized = dump_common(string, options)
+
+      # The serialized output is loaded right away against the same source, so
+      # string fields can refer to it instead of copying their bytes.
+      serialized = dump_common(string, { source_strings: true, **options })
       result = Serialize.load_parse(code, serialized, options.fetch(:freeze, false))
 
       raise_error(string, options, format_type) if format_type && result.failure?
@@ -468,7 +517,7 @@ module Prism # :nodoc:
       format_type = raise_error_format_type(options)
 
       LibRubyParser::PrismBuffer.with do |buffer|
-        LibRubyParser.pm_serialize_parse_lex(buffer.pointer, string.pointer, string.length, dump_options(options))
+        LibRubyParser.pm_serialize_parse_lex(buffer.pointer, string.pointer, string.length, dump_options({ source_strings: true, **options }))
         result = Serialize.load_parse_lex(code, buffer.read, options.fetch(:freeze, false))
 
         raise_error(string, options, format_type) if format_type && result.failure?
@@ -478,7 +527,7 @@ module Prism # :nodoc:
 
     def parse_file_success_common(string, options) # :nodoc:
       format_type = raise_error_format_type(options)
-      success = LibRubyParser.pm_serialize_parse_success_p(string.pointer, string.length, dump_options(options))
+      success = LibRubyParser.pm_serialize_parse_success_p(string.pointer, string.length, dump_options({ discard_comments: true, **options }))
 
       raise_error(string, options, format_type) if format_type && !success
       success
@@ -598,8 +647,10 @@ module Prism # :nodoc:
 
     # The set of options that are understood by the parsing APIs. Note that
     # raise_error is not listed here because it is deleted from the options
-    # hash by raise_error_format_type before the options are dumped.
-    DUMP_OPTIONS_KEYS = [:command_line, :encoding, :filepath, :freeze, :frozen_string_literal, :line, :main_script, :partial_script, :scopes, :version].freeze
+    # hash by raise_error_format_type before the options are dumped. The
+    # constant_pool option is accepted but not dumped, since a shared constant
+    # pool cannot be passed through the serialized options.
+    DUMP_OPTIONS_KEYS = [:attach_comments, :command_line, :constant_pool, :discard_comments, :encoding, :error_limit, :filepath, :freeze, :frozen_string_literal, :line, :main_script, :mark_newlines, :partial_script, :scopes, :source_strings, :syntax_check, :version].freeze
     private_constant :DUMP_OPTIONS_KEYS
 
     # Convert the given options into a serialized options string.
@@ -607,6 +658,10 @@ module Prism # :nodoc:
       unknown_keys = options.keys - DUMP_OPTIONS_KEYS
       raise ArgumentError, "unknown keyword: #{unknown_keys.first}" unless unknown_keys.empty?
 
+      if (constant_pool = options[:constant_pool]) && !constant_pool.is_a?(SharedConstantPool)
+        raise TypeError, "wrong argument type #{constant_pool.class} (expected Prism::SharedConstantPool)"
+      end
+
       template = +""
       values = []
 
@@ -651,6 +706,26 @@ module Prism # :nodoc:
       template << "C"
       values << (options.fetch(:freeze, false) ? 1 : 0)
 
+      template << "C"
+      values << (options.fetch(:attach_comments, false) ? 1 : 0)
+
+      template << "C"
+      values << (options.fetch(:mark_newlines, false) ? 1 : 0)
+
+      template << "C"
+      values << (options.fetch(:source_strings, false) ? 1 : 0)
+
+      template << "C"
+      values << (options.fetch(:discard_comments, false) ? 1 : 0)
+
+      template << "L"
+      error_limit = options[:error_limit] || 0
+      raise ArgumentError, "invalid error_limit: #{error_limit}" if error_limit.negative?
+      values << error_limit
+
+      template << "C"
+      values << (options.fetch(:syntax_check, false) ? 1 : 0)
+
       template << "L"
       if (scopes = options[:scopes])
         values << scopes.length
@@ -701,6 +776,39 @@ module Prism # :nodoc:
     end
   end
 
+  # The FFI backend parses from serialized options, which cannot refer to a
+  # shared constant pool, so there is nothing to build for one.
+  class SharedConstantPool # :nodoc:
+    private
+
+    # Mirrors the C extension's SharedConstantPool#compile method.
+    def compile(symbols)
+    end
+  end
+
+  # The FFI backend cannot keep a parser and its tree alive between calls, so
+  # every source is parsed from scratch.
+  class IncrementalParser # :nodoc:
+    # Mirrors the C extension's IncrementalParser#result method.
+    def result
+      @result
+    end
+
+    private
+
+    # Mirrors the C extension's IncrementalParser#setup method.
+    def setup(source, options)
+      @options = options
+      @result = Prism.parse(source, **options)
+    end
+
+    # Mirrors the C extension's IncrementalParser#update method.
+    def update(source, edits)
+      @result = Prism.parse(source, **@options)
+      0...source.bytesize
+    end
+  end
+
   # Here we are going to patch StringQuery to put in the class-level methods so
   # that it can maintain a consistent interface
   class StringQuery # :nodoc:
@@ -735,4 +843,70 @@ module Prism # :nodoc:
       end
     end
   end
+
+  # Here we are going to patch Source to put in the class-level methods that
+  # search packed line offsets so that it can maintain a consistent interface.
+  # This backend always creates sources with arrays of offsets, so these are
+  # only reached if packed offsets are passed in by hand.
+  class Source # :nodoc:
+    class << self
+      # Mirrors the C extension's Source::find_line method.
+      def find_line(offsets, byte_offset)
+        offsets = offsets.unpack("L*")
+        (offsets.bsearch_index { |offset| offset > byte_offset } || offsets.length) - 1
+      end
+
+      # Mirrors the C extension's Source::line_column method.
+      def line_column(offsets, byte_offset)
+        index = find_line(offsets, byte_offset)
+        (index << 32) | (byte_offset - offsets.unpack("L*")[index]) if index >= 0
+      end
+
+      # Mirrors the C extension's Source::line_offset method.
+      def line_offset(offsets, index)
+        offsets.unpack("L*")[index]
+      end
+
+      # Mirrors the C extension's Source::code_units_table method. Code units
+      # are not counted natively by this backend, so this always returns nil to
+      # fall back to transcoding.
+      def code_units_table(source, offsets, encoding)
+        nil
+      end
+
+      # Mirrors the C extension's Source::code_units_offset method. Code units
+      # are not counted natively by this backend, so this always returns nil to
+      # fall back to transcoding.
+      def code_units_offset(source, offsets, table, byte_offset, encoding)
+        nil
+      end
+
+      # Mirrors the C extension's Source::character_offsets method.
+      def character_offsets(source)
+        offsets = []
+        offset = 0
+
+        source.each_char do |char|
+          char.bytesize.times { offsets << offset }
+          offset += 1
+        end
+
+        offsets << offset
+      end
+
+      # Mirrors the C extension's Source::newline_count method.
+      def newline_count(source)
+        source.b.count("\n")
+      end
+
+      # Mirrors the C extension's Source::line_offsets method.
+      def line_offsets(source)
+        offsets = [0]
+        source.b.scan("\n") { offsets << $~.end(0) }
+        offsets.pack("L*")
+      end
+
+      private :newline_count, :line_offsets
+    end
+  end
 end
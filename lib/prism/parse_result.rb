@@ -15,6 +15,18 @@ module Prism
   # conjunction with locations to allow them to resolve line numbers and source
   # ranges.
   class Source
+    # @rbs!
+    #    def self.find_line: (String offsets, Integer byte_offset) -> Integer
+    #    def self.line_column: (String offsets, Integer byte_offset) -> Integer?
+    #    def self.line_offset: (String offsets, Integer index) -> Integer?
+    #    def self.code_units_table: (String source, String offsets, Encoding? encoding) -> String?
+    #    def self.code_units_offset: (String source, String offsets, String? table, Integer byte_offset, Encoding? encoding) -> Integer?
+    #    def self.character_offsets: (String source) -> Array[Integer]
+
+    # @rbs @offsets: Array[Integer] | String
+    # @rbs @code_units_tables: Hash[Encoding?, String?]?
+    # @rbs @unpacked_offsets: Array[Integer]?
+
     # Create a new source object with the given source code. This method should
     # be used instead of `new` and it will return either a `Source` or a
     # specialized and more performant `ASCIISource` if no multibyte characters
@@ -27,11 +39,13 @@ module Prism
     # array of byte offsets for the start of each line in the source code, which
     # can be calculated by iterating through the source code and recording the
     # byte offset whenever a newline character is encountered.  The first
-    # element is always 0 to mark the first line.
+    # element is always 0 to mark the first line. If the parser has already
+    # determined whether the source is ASCII-only, it can be passed as
+    # ascii_only to avoid scanning the source again.
     #--
-    #: (String source, Integer start_line, Array[Integer] offsets) -> Source
-    def self.for(source, start_line, offsets)
-      if source.ascii_only?
+    #: (String source, Integer start_line, Array[Integer] | String offsets, ?bool ascii_only) -> Source
+    def self.for(source, start_line, offsets, ascii_only = source.ascii_only?)
+      if ascii_only
         ASCIISource.new(source, start_line, offsets)
       elsif source.encoding == Encoding::BINARY
         source.force_encoding(Encoding::UTF_8)
@@ -60,13 +74,16 @@ module Prism
     attr_reader :start_line #: Integer
 
     # The list of newline byte offsets in the source code. When initialized from
-    # the C extension, this may be a packed binary string of uint32_t values
-    # that is lazily unpacked on first access.
+    # the C extension, this is a packed binary string of uint32_t values that is
+    # unpacked on first access, or when the source is deeply frozen. Line lookups
+    # do not need it to be unpacked, since they search the packed string
+    # directly.
     #--
     #: () -> Array[Integer]
     def offsets
       offsets = @offsets
       return offsets if offsets.is_a?(Array)
+      return @unpacked_offsets || offsets.unpack("L*").freeze if frozen?
       @offsets = offsets.unpack("L*")
     end
 
@@ -93,6 +110,7 @@ module Prism
     #: (Array[Integer] offsets) -> void
     def replace_offsets(offsets)
       @offsets = offsets
+      @code_units_tables = nil
     end
 
     # Returns the encoding of the source code, which is set by parameters to the
@@ -124,7 +142,7 @@ module Prism
     def byte_offset(line, column)
       normal = line - @start_line
       raise IndexError if normal < 0
-      offsets.fetch(normal) + column
+      (line_offset(normal) or raise IndexError) + column
     rescue IndexError
       raise ArgumentError, "line #{line} is out of range"
     end
@@ -142,7 +160,7 @@ module Prism
     #--
     #: (Integer byte_offset) -> Integer
     def line_start(byte_offset)
-      offsets[find_line(byte_offset)]
+      line_offset(find_line(byte_offset)) #: Integer
     end
 
     # Returns the byte offset of the end of the line corresponding to the given
@@ -150,7 +168,7 @@ module Prism
     #--
     #: (Integer byte_offset) -> Integer
     def line_end(byte_offset)
-      offsets[find_line(byte_offset) + 1] || source.bytesize
+      line_offset(find_line(byte_offset) + 1) || source.bytesize
     end
 
     # Return the column in bytes for the given byte offset.
@@ -164,7 +182,7 @@ module Prism
     #--
     #: (Integer byte_offset) -> Integer
     def character_offset(byte_offset)
-      (source.byteslice(0, byte_offset) or raise).length
+      packed_code_units_offset(byte_offset, nil) || (source.byteslice(0, byte_offset) or raise).length
     end
 
     # Return the column in characters for the given byte offset.
@@ -191,6 +209,9 @@ module Prism
     def code_units_offset(byte_offset, encoding)
       return byte_offset if encoding == Encoding::UTF_8
 
+      offset = packed_code_units_offset(byte_offset, encoding)
+      return offset if offset
+
       byteslice = (source.byteslice(0, byte_offset) or raise).encode(encoding, invalid: :replace, undef: :replace)
 
       if encoding == Encoding::UTF_16LE || encoding == Encoding::UTF_16BE
@@ -201,11 +222,17 @@ module Prism
     end
 
     # Generate a cache that targets a specific encoding for calculating code
-    # unit offsets.
+    # unit offsets. When the offsets came from the C extension, the code units at
+    # the start of every line are already cached natively, so this looks up
+    # offsets through the source itself.
     #--
-    #: (Encoding encoding) -> CodeUnitsCache
+    #: (Encoding encoding) -> _CodeUnitsCache
     def code_units_cache(encoding)
-      CodeUnitsCache.new(source, encoding)
+      if !frozen? && @offsets.is_a?(String) && code_units_table(encoding)
+        ->(byte_offset) { code_units_offset(byte_offset, encoding) }
+      else
+        CodeUnitsCache.new(source, encoding)
+      end
     end
 
     # Returns the column in code units for the given encoding for the
@@ -221,7 +248,14 @@ module Prism
     #: () -> void
     def deep_freeze
       source.freeze
+
+      # A frozen source cannot unpack its offsets on first access, so they are
+      # unpacked once here. The packed string is kept for line lookups.
+      offsets = @offsets
+      @unpacked_offsets = offsets.unpack("L*").freeze if offsets.is_a?(String)
+
       offsets.freeze
+      @code_units_tables&.each_value(&:freeze)&.freeze
       freeze
     end
 
@@ -230,9 +264,63 @@ module Prism
     #--
     #: (Integer byte_offset) -> Integer
     def find_line(byte_offset) # :nodoc:
+      offsets = @offsets
+      return Source.find_line(offsets, byte_offset) if offsets.is_a?(String)
+
       index = offsets.bsearch_index { |offset| offset > byte_offset } || offsets.length
       index - 1
     end
+
+    # Returns the index of the line that contains the given byte offset and the
+    # column in bytes, packed into a single Integer as (index << 32) | column,
+    # if the offsets are still packed. Returns nil otherwise, in which case the
+    # caller searches the offsets itself.
+    #--
+    #: (Integer byte_offset) -> Integer?
+    def line_column(byte_offset) # :nodoc:
+      offsets = @offsets
+      Source.line_column(offsets, byte_offset) if offsets.is_a?(String)
+    end
+
+    private
+
+    # Returns the byte offset of the start of the line at the given index, or
+    # nil if there is no such line.
+    #--
+    #: (Integer index) -> Integer?
+    def line_offset(index)
+      offsets = @offsets
+      offsets.is_a?(String) ? Source.line_offset(offsets, index) : offsets[index]
+    end
+
+    # Returns the table of code units at the start of every line for the given
+    # encoding (or characters if the encoding is nil), building it on first
+    # use. Returns nil if the table cannot be built natively.
+    #--
+    #: (Encoding? encoding) -> String?
+    def code_units_table(encoding)
+      tables = (@code_units_tables ||= {})
+      return tables[encoding] if tables.key?(encoding)
+
+      tables[encoding] = Source.code_units_table(source, @offsets, encoding) #: String
+    end
+
+    # Returns the offset in code units for the given encoding (or characters if
+    # the encoding is nil) by counting natively from the start of the line of
+    # the given byte offset. Returns nil if the offset cannot be computed
+    # natively, in which case the caller falls back to transcoding.
+    #--
+    #: (Integer byte_offset, Encoding? encoding) -> Integer?
+    def packed_code_units_offset(byte_offset, encoding)
+      offsets = @offsets
+      return unless offsets.is_a?(String)
+
+      if frozen?
+        Source.code_units_offset(source, offsets, nil, byte_offset, encoding)
+      elsif (table = code_units_table(encoding))
+        Source.code_units_offset(source, offsets, table, byte_offset, encoding)
+      end
+    end
   end
 
   # A cache that can be used to quickly compute code unit offsets from byte
@@ -857,6 +945,53 @@ module Prism
     end
   end
 
+  # This represents an error that was serialized by Prism.dump_errors. Compact
+  # errors do not carry a message or a reference to the source, only where the
+  # error starts and how long it is.
+  class CompactError
+    # The type of error. This is an _internal_ symbol that is used for
+    # communicating with translation layers. It is not meant to be public API.
+    attr_reader :type #: Symbol
+
+    # The level of this error.
+    attr_reader :level #: Symbol
+
+    # The line number where this error starts, counting from the start line that
+    # the source was parsed with.
+    attr_reader :line #: Integer
+
+    # The column in bytes where this error starts.
+    attr_reader :column #: Integer
+
+    # The length of this error in bytes.
+    attr_reader :length #: Integer
+
+    # Create a new compact error object with the given type and position.
+    #--
+    #: (Symbol type, Symbol level, Integer line, Integer column, Integer length) -> void
+    def initialize(type, level, line, column, length)
+      @type = type
+      @level = level
+      @line = line
+      @column = column
+      @length = length
+    end
+
+    # Implement the hash pattern matching interface for CompactError.
+    #--
+    #: (Array[Symbol]? keys) -> Hash[Symbol, untyped]
+    def deconstruct_keys(keys) # :nodoc:
+      { type: type, level: level, line: line, column: column, length: length }
+    end
+
+    # Returns a string representation of this error.
+    #--
+    #: () -> String
+    def inspect # :nodoc:
+      "#<Prism::CompactError @type=#{@type.inspect} @level=#{@level.inspect} @line=#{@line.inspect} @column=#{@column.inspect} @length=#{@length.inspect}>"
+    end
+  end
+
   # This represents a warning that was encountered during parsing.
   class ParseWarning
     # The type of warning. This is an _internal_ symbol that is used for
@@ -1002,20 +1137,25 @@ module Prism
   class ParseResult < Result
     autoload :Comments, "prism/parse_result/comments"
     autoload :Errors, "prism/parse_result/errors"
-    autoload :Newlines, "prism/parse_result/newlines"
 
     private_constant :Comments
     private_constant :Errors
-    private_constant :Newlines
 
     # The syntax tree that was parsed from the source code.
     attr_reader :value #: ProgramNode
 
+    # Where the parser attached each comment in the tree, if the
+    # attach_comments option was given. This is a flat list of node id, target,
+    # and kind triples, one for each comment, that attach_comments! uses in
+    # place of walking the tree itself.
+    attr_reader :comment_attachments #: Array[Integer]?
+
     # Create a new parse result object with the given values.
     #--
-    #: (ProgramNode value, Array[Comment] comments, Array[MagicComment] magic_comments, Location? data_loc, Array[ParseError] errors, Array[ParseWarning] warnings, bool continuable, Source source) -> void
-    def initialize(value, comments, magic_comments, data_loc, errors, warnings, continuable, source)
+    #: (ProgramNode value, Array[Comment] comments, Array[MagicComment] magic_comments, Location? data_loc, Array[ParseError] errors, Array[ParseWarning] warnings, bool continuable, Source source, ?Array[Integer]? comment_attachments) -> void
+    def initialize(value, comments, magic_comments, data_loc, errors, warnings, continuable, source, comment_attachments = nil)
       @value = value
+      @comment_attachments = comment_attachments
       super(comments, magic_comments, data_loc, errors, warnings, continuable, source)
     end
 
@@ -1033,14 +1173,6 @@ module Prism
       Comments.new(self).attach! # steep:ignore
     end
 
-    # Walk the tree and mark nodes that are on a new line, loosely emulating
-    # the behavior of CRuby's `:line` tracepoint event.
-    #--
-    #: () -> void
-    def mark_newlines!
-      value.accept(Newlines.new(source.offsets.size)) # steep:ignore
-    end
-
     # Returns a string representation of the syntax tree with the errors
     # displayed inline.
     #--
@@ -1134,6 +1266,24 @@ module Prism
       @location = Location.new(source, location >> 32, location & 0xFFFFFFFF)
     end
 
+    # The byte offset from the beginning of the source where this token starts.
+    # Unlike `location.start_offset`, this does not create a Location.
+    #--
+    #: () -> Integer
+    def start_offset
+      location = @location
+      location.is_a?(Location) ? location.start_offset : location >> 32
+    end
+
+    # The byte offset from the beginning of the source where this token ends.
+    # Unlike `location.end_offset`, this does not create a Location.
+    #--
+    #: () -> Integer
+    def end_offset
+      location = @location
+      location.is_a?(Location) ? location.end_offset : (location >> 32) + (location & 0xFFFFFFFF)
+    end
+
     # Implement the pretty print interface for Token.
     #--
     #: (PP q) -> void
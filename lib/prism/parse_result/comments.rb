@@ -120,6 +120,11 @@ module Prism
       #--
       #: () -> void
       def attach!
+        if (comment_attachments = parse_result.comment_attachments)
+          attach_from(comment_attachments)
+          return
+        end
+
         parse_result.comments.each do |comment|
           preceding, enclosing, following = nearest_targets(parse_result.value, comment)
 
@@ -144,6 +149,48 @@ module Prism
 
       private
 
+      # Attach the comments using the table that the parser computed when the
+      # attach_comments option was given. For each comment in order it holds
+      # the id of a node, the target (0 for the node itself, otherwise one more
+      # than the index of a location in the node's comment targets), and the
+      # kind (0 for leading, 1 for trailing).
+      #--
+      #: (Array[Integer] comment_attachments) -> void
+      def attach_from(comment_attachments)
+        nodes = {} #: Hash[Integer, node?]
+        index = 0
+
+        while index < comment_attachments.length
+          nodes[comment_attachments[index]] = nil
+          index += 3
+        end
+
+        # Find each of the nodes, stopping as soon as they have all been found.
+        remaining = nodes.size
+        queue = [parse_result.value] #: Array[node]
+
+        while remaining > 0 && (node = queue.pop)
+          if nodes.key?(node.node_id)
+            nodes[node.node_id] = node
+            remaining -= 1
+          end
+
+          queue.concat(node.compact_child_nodes)
+        end
+
+        parse_result.comments.each_with_index do |comment, comment_index|
+          node = nodes.fetch(comment_attachments[comment_index * 3]) #: node
+          target = comment_attachments[comment_index * 3 + 1]
+          location = target == 0 ? node.location : node.comment_targets.fetch(target - 1) #: Location
+
+          if comment_attachments[comment_index * 3 + 2] == 0
+            location.leading_comment(comment)
+          else
+            location.trailing_comment(comment)
+          end
+        end
+      end
+
       # Responsible for finding the nearest targets to the given comment within
       # the context of the given encapsulating node.
       #--
@@ -0,0 +1,44 @@
+# frozen_string_literal: true
+# :markup: markdown
+#--
+# rbs_inline: enabled
+
+module Prism
+  # A set of constant names that can be shared between parses. When it is given
+  # as the `constant_pool` option, the parser looks names up in it before adding
+  # them to its own constant pool, and the C extension reuses the symbols that
+  # it holds instead of interning them again for every parse. This makes it
+  # worthwhile when parsing many files that use the same names, for example:
+  #
+  #     pool = Prism::SharedConstantPool.new(%i[require attr_reader private])
+  #     files.map { |file| Prism.parse_file(file, constant_pool: pool) }
+  #
+  # Instances are frozen and never modified by the parser, so they can be used
+  # by many parses at once.
+  class SharedConstantPool
+    # The symbols in the pool, in the order of their constant ids.
+    attr_reader :symbols #: Array[Symbol]
+
+    # Initialize a new shared constant pool with the given names. Duplicate
+    # names are only added once.
+    #--
+    #: (Array[Symbol | String] names) -> void
+    def initialize(names)
+      @symbols = names.map { |name| name.to_s.encode(Encoding::UTF_8).to_sym }.uniq.freeze
+      compile(@symbols)
+      freeze
+    end
+
+    # The number of constants in the pool.
+    #--
+    #: () -> Integer
+    def size
+      symbols.size
+    end
+
+    private
+
+    # @rbs!
+    #    def compile: (Array[Symbol] symbols) -> void
+  end
+end
@@ -297,15 +297,7 @@ module Prism
         if source.bytesize == source.length
           -> (offset) { offset }
         else
-          offset_cache = []
-          offset = 0
-
-          source.each_char do |char|
-            char.bytesize.times { offset_cache << offset }
-            offset += 1
-          end
-
-          offset_cache << offset
+          Prism::Source.character_offsets(source)
         end
       end
 
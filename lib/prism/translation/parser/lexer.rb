@@ -236,7 +236,7 @@ module Prism
 
             type = TYPES.fetch(token.type)
             value = token.value
-            location = range(token.location.start_offset, token.location.end_offset)
+            location = range(token.start_offset, token.end_offset)
 
             # A newline deferred past a run of comments is emitted before the
             # token that follows the last comment.
@@ -259,12 +259,12 @@ module Prism
                 end
 
                 value += next_token.value
-                location = range(token.location.start_offset, next_token.location.end_offset)
+                location = range(token.start_offset, next_token.end_offset)
                 index += 1
               else
                 # A carriage return before the terminating newline is part of
                 # the comment token but not of the comment's value.
-                location = range(token.location.start_offset, token.location.end_offset - 1) if value.chomp!
+                location = range(token.start_offset, token.end_offset - 1) if value.chomp!
               end
             when :tNL
               next_token = lexed[index]
@@ -281,8 +281,8 @@ module Prism
               value = parse_complex(value)
             when :tINTEGER
               if value.start_with?("+")
-                tokens << [:tUNARY_NUM, ["+", range(token.location.start_offset, token.location.start_offset + 1)]]
-                location = range(token.location.start_offset + 1, token.location.end_offset)
+                tokens << [:tUNARY_NUM, ["+", range(token.start_offset, token.start_offset + 1)]]
+                location = range(token.start_offset + 1, token.end_offset)
               end
 
               value = parse_integer(value)
@@ -297,7 +297,7 @@ module Prism
             when :tRATIONAL
               value = parse_rational(value)
             when :tSPACE
-              location = range(token.location.start_offset, token.location.start_offset + percent_array_leading_whitespace(value))
+              location = range(token.start_offset, token.start_offset + percent_array_leading_whitespace(value))
               value = nil
             when :tSTRING_BEG
               next_token = lexed[index]
@@ -305,23 +305,21 @@ module Prism
               basic_quotes = value == '"' || value == "'"
 
               if basic_quotes && next_token&.type == :STRING_END
-                next_location = token.location.join(next_token.location)
                 type = :tSTRING
                 value = ""
-                location = range(next_location.start_offset, next_location.end_offset)
+                location = range(token.start_offset, next_token.end_offset)
                 index += 1
               elsif value.start_with?("'", '"', "%")
                 if next_token&.type == :STRING_CONTENT && next_next_token&.type == :STRING_END
                   string_value = next_token.value
                   if simplify_string?(string_value, value)
-                    next_location = token.location.join(next_next_token.location)
                     if percent_array?(value)
                       value = percent_array_unescape(string_value)
                     else
                       value = unescape_string(string_value, value)
                     end
                     type = :tSTRING
-                    location = range(next_location.start_offset, next_location.end_offset)
+                    location = range(token.start_offset, next_next_token.end_offset)
                     index += 2
                     tokens << [type, [value, location]]
 
@@ -365,7 +363,7 @@ module Prism
                 # For squiggly heredocs they are not joined so we do that manually here.
                 current_string = +""
                 current_length = 0
-                start_offset = token.location.start_offset
+                start_offset = token.start_offset
                 while token.type == :STRING_CONTENT
                   current_length += token.value.bytesize
                   # Heredoc interpolation can have multiple STRING_CONTENT nodes on the same line.
@@ -397,7 +395,7 @@ module Prism
                 # it emits a single string node. The backslash (and remaining newline) is removed.
                 current_line = +""
                 adjustment = 0
-                start_offset = token.location.start_offset
+                start_offset = token.start_offset
                 emit = false
 
                 lines.each.with_index do |line, index|
@@ -437,10 +435,10 @@ module Prism
               if token.type == :HEREDOC_END && value.end_with?("\n")
                 newline_length = value.end_with?("\r\n") ? 2 : 1
                 value = heredoc_stack.pop.identifier
-                location = range(token.location.start_offset, token.location.end_offset - newline_length)
+                location = range(token.start_offset, token.end_offset - newline_length)
               elsif token.type == :REGEXP_END
                 value = value[0]
-                location = range(token.location.start_offset, token.location.start_offset + 1)
+                location = range(token.start_offset, token.start_offset + 1)
               end
 
               if percent_array?(quote_stack.pop)
@@ -449,16 +447,15 @@ module Prism
                 ends_with_whitespace = prev_token&.type == :WORDS_SEP
                 # parser always emits a space token after content in a percent array, even if no actual whitespace is present.
                 if !empty && !ends_with_whitespace
-                  tokens << [:tSPACE, [nil, range(token.location.start_offset, token.location.start_offset)]]
+                  tokens << [:tSPACE, [nil, range(token.start_offset, token.start_offset)]]
                 end
               end
             when :tSYMBEG
               if (next_token = lexed[index]) && next_token.type != :STRING_CONTENT && next_token.type != :EMBEXPR_BEGIN && next_token.type != :EMBVAR && next_token.type != :STRING_END
-                next_location = token.location.join(next_token.location)
                 type = :tSYMBOL
                 value = next_token.value
                 value = { "~@" => "~", "!@" => "!" }.fetch(value, value)
-                location = range(next_location.start_offset, next_location.end_offset)
+                location = range(token.start_offset, next_token.end_offset)
                 index += 1
               else
                 quote_stack.push(value)
@@ -482,7 +479,7 @@ module Prism
             tokens << [type, [value, location]]
 
             if token.type == :REGEXP_END
-              tokens << [:tREGEXP_OPT, [token.value[1..], range(token.location.start_offset + 1, token.location.end_offset)]]
+              tokens << [:tREGEXP_OPT, [token.value[1..], range(token.start_offset + 1, token.end_offset)]]
             end
           end
 
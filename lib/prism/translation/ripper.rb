@@ -447,8 +447,10 @@ module Prism
       autoload :SexpBuilderPP, "prism/translation/ripper/sexp"
 
       # Provides optimized access to line and column information.
-      # Ripper bounds are mostly accessed in a linear fashion, so
-      # we can try a linear scan first and fall back to binary search.
+      # If the source still has the packed offsets from the C extension,
+      # each lookup is a single native binary search. Otherwise Ripper
+      # bounds are mostly accessed in a linear fashion, so we can try a
+      # linear scan first and fall back to binary search.
       class LineAndColumnCache # :nodoc:
         # How many should it look ahead/behind before falling back to binary searching.
         WINDOW = 8
@@ -457,14 +459,27 @@ module Prism
         #: (Source source) -> void
         def initialize(source)
           @source = source
-          @offsets = source.offsets
+          @offsets = nil
           @hint = 0
         end
 
         #: (Integer byte_offset) -> [Integer, Integer]
         def line_and_column(byte_offset)
+          line_column = line_column(byte_offset)
+          [line_column >> 32, line_column & 0xFFFFFFFF]
+        end
+
+        # Returns the line and column packed into a single Integer as
+        # (line << 32) | column, so that looking them up allocates nothing.
+        #: (Integer byte_offset) -> Integer
+        def line_column(byte_offset)
+          if (line_column = @source.line_column(byte_offset))
+            return line_column + (@source.start_line << 32)
+          end
+
+          @offsets ||= @source.offsets
           @hint = new_hint(byte_offset) || @source.find_line(byte_offset)
-          return [@hint + @source.start_line, byte_offset - @offsets[@hint]]
+          ((@hint + @source.start_line) << 32) | (byte_offset - @offsets[@hint])
         end
 
         private
@@ -4200,7 +4215,9 @@ module Prism
       # This method is responsible for updating lineno and column information
       # to reflect the current node.
       def bounds(location)
-        @lineno, @column = line_and_column_cache.line_and_column(location.start_offset)
+        line_column = line_and_column_cache.line_column(location.start_offset)
+        @lineno = line_column >> 32
+        @column = line_column & 0xFFFFFFFF
       end
 
       # :startdoc:
@@ -23,6 +23,10 @@ module Prism
   sig { params(source: String, serialized: String, freeze: T::Boolean).returns(ParseResult) }
   def self.load(source, serialized, freeze = T.unsafe(nil)); end
 
+  # Load the compact errors serialized by Prism.dump_errors.
+  sig { params(serialized: String, freeze: T::Boolean).returns(T::Array[CompactError]) }
+  def self.load_errors(serialized, freeze = T.unsafe(nil)); end
+
   # Given a Method, UnboundMethod, Proc, or Thread::Backtrace::Location,
   # returns the Prism node representing it. On CRuby, this uses node_id for
   # an exact match. On other implementations, it falls back to best-effort
@@ -33,54 +37,63 @@ module Prism
   VERSION = T.let(nil, String)
   BACKEND = T.let(nil, Symbol)
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(ParseResult) }
-  def self.parse(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(ParseResult) }
+  def self.parse(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
+
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).void }
+  def self.profile(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
+
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(LexResult) }
+  def self.lex(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
+
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(ParseLexResult) }
+  def self.parse_lex(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).void }
-  def self.profile(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(String) }
+  def self.dump(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(LexResult) }
-  def self.lex(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(String) }
+  def self.dump_errors(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(ParseLexResult) }
-  def self.parse_lex(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Array[Comment]) }
+  def self.parse_comments(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(String) }
-  def self.dump(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Boolean) }
+  def self.parse_success?(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Array[Comment]) }
-  def self.parse_comments(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Boolean) }
+  def self.parse_failure?(source, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Boolean) }
-  def self.parse_success?(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, pattern: ::T.any(String, Pattern), filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Array[Prism::Node]) }
+  def self.scan(source, pattern, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(source: String, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Boolean) }
-  def self.parse_failure?(source, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(source: String, types: T::Array[Symbol], filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Array[::T.any(Prism::Node, T::Boolean)]) }
+  def self.parse_events(source, types, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(stream: ::T.untyped, filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(ParseResult) }
-  def self.parse_stream(stream, filepath: T.unsafe(nil), command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(stream: ::T.untyped, filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(ParseResult) }
+  def self.parse_stream(stream, filepath: T.unsafe(nil), attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(ParseResult) }
-  def self.parse_file(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(ParseResult) }
+  def self.parse_file(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).void }
-  def self.profile_file(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).void }
+  def self.profile_file(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(LexResult) }
-  def self.lex_file(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(LexResult) }
+  def self.lex_file(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(ParseLexResult) }
-  def self.parse_lex_file(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(ParseLexResult) }
+  def self.parse_lex_file(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(String) }
-  def self.dump_file(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(String) }
+  def self.dump_file(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Array[Comment]) }
-  def self.parse_file_comments(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Array[Comment]) }
+  def self.parse_file_comments(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Boolean) }
-  def self.parse_file_success?(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Boolean) }
+  def self.parse_file_success?(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 
-  sig { params(filepath: String, command_line: String, encoding: ::T.any(Encoding, FalseClass), freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], version: String).returns(T::Boolean) }
-  def self.parse_file_failure?(filepath, command_line: T.unsafe(nil), encoding: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), version: T.unsafe(nil)); end
+  sig { params(filepath: String, attach_comments: T::Boolean, command_line: String, constant_pool: SharedConstantPool, discard_comments: T::Boolean, encoding: ::T.any(Encoding, FalseClass), error_limit: Integer, freeze: T::Boolean, frozen_string_literal: T::Boolean, line: Integer, main_script: T::Boolean, mark_newlines: T::Boolean, partial_script: T::Boolean, raise_error: ::T.any(Symbol, TrueClass), scopes: T::Array[T::Array[Symbol]], source_strings: T::Boolean, syntax_check: T::Boolean, version: String).returns(T::Boolean) }
+  def self.parse_file_failure?(filepath, attach_comments: T.unsafe(nil), command_line: T.unsafe(nil), constant_pool: T.unsafe(nil), discard_comments: T.unsafe(nil), encoding: T.unsafe(nil), error_limit: T.unsafe(nil), freeze: T.unsafe(nil), frozen_string_literal: T.unsafe(nil), line: T.unsafe(nil), main_script: T.unsafe(nil), mark_newlines: T.unsafe(nil), partial_script: T.unsafe(nil), raise_error: T.unsafe(nil), scopes: T.unsafe(nil), source_strings: T.unsafe(nil), syntax_check: T.unsafe(nil), version: T.unsafe(nil)); end
 end
@@ -32,7 +32,19 @@ module Prism
   #
   #     integer = result.value.statements.body.first.receiver.receiver
   #     dispatcher.dispatch_once(integer)
+  #
+  # If you have the source rather than a tree, you can use `#dispatch_source`
+  # to parse it and dispatch events in one step. This only creates Ruby objects
+  # for the nodes that have listeners registered (and the nodes beneath them),
+  # which is much cheaper when the listeners are only interested in a few types
+  # of nodes.
+  #
+  #     dispatcher.dispatch_source("001 + 002 + 003")
   class Dispatcher < Visitor
+    # The names of the enter and leave events for each type of node, keyed by
+    # the name of the node class.
+    EVENTS = T.let(nil, T::Hash[Symbol, [Symbol, Symbol]])
+
     # A hash mapping event names to arrays of listeners that should be notified
     # when that event is fired.
     sig { returns(T::Hash[Symbol, T::Array[::T.untyped]]) }
@@ -59,6 +71,13 @@ module Prism
     sig { params(node: ::T.nilable(Node)).returns(::T.untyped) }
     def dispatch(node); end
 
+    # Parses `source` and dispatches events to all registered listeners in the
+    # same order as `#dispatch` would for the resulting tree. Only the nodes that
+    # have listeners registered for them are created as Ruby objects. For
+    # supported options, see Prism.parse.
+    sig { params(source: String, options: ::T.untyped).void }
+    def dispatch_source(source, **options); end
+
     # Dispatches a single event for `node` to all registered listeners.
     sig { params(node: Node).void }
     def dispatch_once(node); end
@@ -0,0 +1,46 @@
+# typed: true
+
+module Prism
+  # A parser that keeps the tree from the last parse of a source so that the
+  # source can be parsed again cheaply after it has been edited, which is what
+  # editors need to keep a tree up to date as the user types, for example:
+  #
+  #     parser = Prism::IncrementalParser.new("def foo\n  1\nend\n")
+  #     parser.reparse("def foo\n  12\nend\n", [[11, 0, 1]]) # => 0...16
+  #     parser.result.value # => the same tree as Prism.parse would return
+  #
+  # When the edits fall within a single method, class, module, or singleton
+  # class definition that can be parsed on its own, only that definition is
+  # parsed again and the rest of the tree keeps its node ids. Otherwise the
+  # whole source is parsed again. Either way the result matches the one that
+  # Prism.parse returns for the new source, except that node ids are not reused
+  # and diagnostics may come in a different order.
+  class IncrementalParser
+    # The source that was parsed last.
+    sig { returns(String) }
+    attr_reader :source
+
+    # Initialize a new incremental parser by parsing the given source. For
+    # supported options, see Prism.parse.
+    sig { params(source: String, options: ::T.untyped).void }
+    def initialize(source, **options); end
+
+    # Parse the given source, which is the previous source with the given edits
+    # applied, and return the range of bytes of the new source that were parsed
+    # again. Each edit is an array of the byte offset where it starts, the
+    # number of bytes that it replaced, and the number of bytes that replaced
+    # them, with offsets in terms of the source after the edits before it.
+    sig { params(source: String, edits: T::Array[[Integer, Integer, Integer]]).returns(T::Range[Integer]) }
+    def reparse(source, edits); end
+
+    # Return the result of the last parse.
+    sig { returns(ParseResult) }
+    def result; end
+
+    sig { params(source: String, options: T::Hash[Symbol, ::T.untyped]).void }
+    private def setup(source, options); end
+
+    sig { params(source: String, edits: T::Array[[Integer, Integer, Integer]]).returns(T::Range[Integer]) }
+    private def update(source, edits); end
+  end
+end
@@ -5,6 +5,24 @@ module Prism
   # conjunction with locations to allow them to resolve line numbers and source
   # ranges.
   class Source
+    sig { params(offsets: String, byte_offset: Integer).returns(Integer) }
+    def self.find_line(offsets, byte_offset); end
+
+    sig { params(offsets: String, byte_offset: Integer).returns(::T.nilable(Integer)) }
+    def self.line_column(offsets, byte_offset); end
+
+    sig { params(offsets: String, index: Integer).returns(::T.nilable(Integer)) }
+    def self.line_offset(offsets, index); end
+
+    sig { params(source: String, offsets: String, encoding: ::T.nilable(Encoding)).returns(::T.nilable(String)) }
+    def self.code_units_table(source, offsets, encoding); end
+
+    sig { params(source: String, offsets: String, table: ::T.nilable(String), byte_offset: Integer, encoding: ::T.nilable(Encoding)).returns(::T.nilable(Integer)) }
+    def self.code_units_offset(source, offsets, table, byte_offset, encoding); end
+
+    sig { params(source: String).returns(T::Array[Integer]) }
+    def self.character_offsets(source); end
+
     # Create a new source object with the given source code. This method should
     # be used instead of `new` and it will return either a `Source` or a
     # specialized and more performant `ASCIISource` if no multibyte characters
@@ -17,9 +35,11 @@ module Prism
     # array of byte offsets for the start of each line in the source code, which
     # can be calculated by iterating through the source code and recording the
     # byte offset whenever a newline character is encountered.  The first
-    # element is always 0 to mark the first line.
-    sig { params(source: String, start_line: Integer, offsets: T::Array[Integer]).returns(Source) }
-    def self.for(source, start_line, offsets); end
+    # element is always 0 to mark the first line. If the parser has already
+    # determined whether the source is ASCII-only, it can be passed as
+    # ascii_only to avoid scanning the source again.
+    sig { params(source: String, start_line: Integer, offsets: ::T.any(T::Array[Integer], String), ascii_only: T::Boolean).returns(Source) }
+    def self.for(source, start_line, offsets, ascii_only = T.unsafe(nil)); end
 
     # The source code that this source object represents.
     sig { returns(String) }
@@ -30,8 +50,9 @@ module Prism
     attr_reader :start_line
 
     # The list of newline byte offsets in the source code. When initialized from
-    # the C extension, this may be a packed binary string of uint32_t values
-    # that is lazily unpacked on first access.
+    # the C extension, this is a packed binary string of uint32_t values that is
+    # unpacked on first access. Line lookups do not need it to be unpacked, since
+    # they search the packed string directly.
     sig { returns(T::Array[Integer]) }
     def offsets; end
 
@@ -110,8 +131,10 @@ module Prism
     def code_units_offset(byte_offset, encoding); end
 
     # Generate a cache that targets a specific encoding for calculating code
-    # unit offsets.
-    sig { params(encoding: Encoding).returns(CodeUnitsCache) }
+    # unit offsets. When the offsets came from the C extension, the code units at
+    # the start of every line are already cached natively, so this looks up
+    # offsets through the source itself.
+    sig { params(encoding: Encoding).returns(::T.untyped) }
     def code_units_cache(encoding); end
 
     # Returns the column in code units for the given encoding for the
@@ -127,6 +150,31 @@ module Prism
     # byte offset.
     sig { params(byte_offset: Integer).returns(Integer) }
     def find_line(byte_offset); end
+
+    # Returns the index of the line that contains the given byte offset and the
+    # column in bytes, packed into a single Integer as (index << 32) | column,
+    # if the offsets are still packed. Returns nil otherwise, in which case the
+    # caller searches the offsets itself.
+    sig { params(byte_offset: Integer).returns(::T.nilable(Integer)) }
+    def line_column(byte_offset); end
+
+    # Returns the byte offset of the start of the line at the given index, or
+    # nil if there is no such line.
+    sig { params(index: Integer).returns(::T.nilable(Integer)) }
+    private def line_offset(index); end
+
+    # Returns the table of code units at the start of every line for the given
+    # encoding (or characters if the encoding is nil), building it on first
+    # use. Returns nil if the table cannot be built natively.
+    sig { params(encoding: ::T.nilable(Encoding)).returns(::T.nilable(String)) }
+    private def code_units_table(encoding); end
+
+    # Returns the offset in code units for the given encoding (or characters if
+    # the encoding is nil) by counting natively from the start of the line of
+    # the given byte offset. Returns nil if the offset cannot be computed
+    # natively, in which case the caller falls back to transcoding.
+    sig { params(byte_offset: Integer, encoding: ::T.nilable(Encoding)).returns(::T.nilable(Integer)) }
+    private def packed_code_units_offset(byte_offset, encoding); end
   end
 
   # A cache that can be used to quickly compute code unit offsets from byte
@@ -509,6 +557,45 @@ module Prism
     def inspect; end
   end
 
+  # This represents an error that was serialized by Prism.dump_errors. Compact
+  # errors do not carry a message or a reference to the source, only where the
+  # error starts and how long it is.
+  class CompactError
+    # The type of error. This is an _internal_ symbol that is used for
+    # communicating with translation layers. It is not meant to be public API.
+    sig { returns(Symbol) }
+    attr_reader :type
+
+    # The level of this error.
+    sig { returns(Symbol) }
+    attr_reader :level
+
+    # The line number where this error starts, counting from the start line that
+    # the source was parsed with.
+    sig { returns(Integer) }
+    attr_reader :line
+
+    # The column in bytes where this error starts.
+    sig { returns(Integer) }
+    attr_reader :column
+
+    # The length of this error in bytes.
+    sig { returns(Integer) }
+    attr_reader :length
+
+    # Create a new compact error object with the given type and position.
+    sig { params(type: Symbol, level: Symbol, line: Integer, column: Integer, length: Integer).void }
+    def initialize(type, level, line, column, length); end
+
+    # Implement the hash pattern matching interface for CompactError.
+    sig { params(keys: ::T.nilable(T::Array[Symbol])).returns(T::Hash[Symbol, ::T.untyped]) }
+    def deconstruct_keys(keys); end
+
+    # Returns a string representation of this error.
+    sig { returns(String) }
+    def inspect; end
+  end
+
   # This represents a warning that was encountered during parsing.
   class ParseWarning
     # The type of warning. This is an _internal_ symbol that is used for
@@ -627,9 +714,16 @@ module Prism
     sig { returns(ProgramNode) }
     attr_reader :value
 
+    # Where the parser attached each comment in the tree, if the
+    # attach_comments option was given. This is a flat list of node id, target,
+    # and kind triples, one for each comment, that attach_comments! uses in
+    # place of walking the tree itself.
+    sig { returns(::T.nilable(T::Array[Integer])) }
+    attr_reader :comment_attachments
+
     # Create a new parse result object with the given values.
-    sig { params(value: ProgramNode, comments: T::Array[Comment], magic_comments: T::Array[MagicComment], data_loc: ::T.nilable(Location), errors: T::Array[ParseError], warnings: T::Array[ParseWarning], continuable: T::Boolean, source: Source).void }
-    def initialize(value, comments, magic_comments, data_loc, errors, warnings, continuable, source); end
+    sig { params(value: ProgramNode, comments: T::Array[Comment], magic_comments: T::Array[MagicComment], data_loc: ::T.nilable(Location), errors: T::Array[ParseError], warnings: T::Array[ParseWarning], continuable: T::Boolean, source: Source, comment_attachments: ::T.nilable(T::Array[Integer])).void }
+    def initialize(value, comments, magic_comments, data_loc, errors, warnings, continuable, source, comment_attachments = nil); end
 
     # Implement the hash pattern matching interface for ParseResult.
     sig { params(keys: ::T.nilable(T::Array[Symbol])).returns(T::Hash[Symbol, ::T.untyped]) }
@@ -639,11 +733,6 @@ module Prism
     sig { void }
     def attach_comments!; end
 
-    # Walk the tree and mark nodes that are on a new line, loosely emulating
-    # the behavior of CRuby's `:line` tracepoint event.
-    sig { void }
-    def mark_newlines!; end
-
     # Returns a string representation of the syntax tree with the errors
     # displayed inline.
     sig { returns(String) }
@@ -707,6 +796,16 @@ module Prism
     sig { returns(Location) }
     def location; end
 
+    # The byte offset from the beginning of the source where this token starts.
+    # Unlike `location.start_offset`, this does not create a Location.
+    sig { returns(Integer) }
+    def start_offset; end
+
+    # The byte offset from the beginning of the source where this token ends.
+    # Unlike `location.end_offset`, this does not create a Location.
+    sig { returns(Integer) }
+    def end_offset; end
+
     # Implement the pretty print interface for Token.
     sig { params(q: PP).void }
     def pretty_print(q); end
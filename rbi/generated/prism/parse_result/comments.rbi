@@ -81,6 +81,14 @@ module Prism
       sig { void }
       def attach!; end
 
+      # Attach the comments using the table that the parser computed when the
+      # attach_comments option was given. For each comment in order it holds
+      # the id of a node, the target (0 for the node itself, otherwise one more
+      # than the index of a location in the node's comment targets), and the
+      # kind (0 for leading, 1 for trailing).
+      sig { params(comment_attachments: T::Array[Integer]).void }
+      private def attach_from(comment_attachments); end
+
       # Responsible for finding the nearest targets to the given comment within
       # the context of the given encapsulating node.
       sig { params(node: Node, comment: Comment).returns([::T.untyped, ::T.untyped, ::T.untyped]) }
@@ -37,6 +37,10 @@ module Prism
     sig { params(input: String, serialized: String, freeze: T::Boolean).returns(T::Array[Comment]) }
     def self.load_parse_comments(input, serialized, freeze); end
 
+    # Deserialize the dumped output from a request to dump_errors.
+    sig { params(serialized: String, freeze: T::Boolean).returns(T::Array[CompactError]) }
+    def self.load_errors(serialized, freeze); end
+
     # Deserialize the dumped output from a request to parse_lex or
     # parse_lex_file.
     #
@@ -66,10 +70,10 @@ module Prism
       attr_reader :io
 
       sig { returns(Source) }
-      attr_reader :source
+      attr_accessor :source
 
-      sig { params(source: Source, serialized: String).void }
-      def initialize(source, serialized); end
+      sig { params(input: String, serialized: String).void }
+      def initialize(input, serialized); end
 
       sig { returns(T::Boolean) }
       def eof?; end
@@ -86,9 +90,15 @@ module Prism
       sig { params(freeze: T::Boolean).returns(T::Array[Integer]) }
       def load_line_offsets(freeze); end
 
+      sig { returns(T::Boolean) }
+      def load_ascii_only; end
+
       sig { params(freeze: T::Boolean).returns(T::Array[Comment]) }
       def load_comments(freeze); end
 
+      sig { params(freeze: T::Boolean).returns(::T.nilable(T::Array[Integer])) }
+      def load_comment_attachments(freeze); end
+
       sig { params(freeze: T::Boolean).returns(T::Array[MagicComment]) }
       def load_magic_comments(freeze); end
 
@@ -100,6 +110,9 @@ module Prism
       sig { params(encoding: Encoding, freeze: T::Boolean).returns(T::Array[ParseError]) }
       def load_errors(encoding, freeze); end
 
+      sig { params(freeze: T::Boolean).returns(T::Array[CompactError]) }
+      def load_compact_errors(freeze); end
+
       sig { returns(Symbol) }
       def load_warning_level; end
 
@@ -135,6 +148,15 @@ module Prism
       sig { params(encoding: Encoding).returns(String) }
       def load_string(encoding); end
 
+      # Load a string field. If the source_strings option was given, the low bit
+      # of the length says whether the string is a slice of the source, in
+      # which case its offset follows instead of its bytes. A length of one
+      # (an empty slice) is instead followed by the index of an interned frozen
+      # string literal, which is followed by its contents the first time it is
+      # seen.
+      sig { params(encoding: Encoding).returns(String) }
+      def load_string_field(encoding); end
+
       sig { params(freeze: T::Boolean).returns(Location) }
       def load_location_object(freeze); end
 
@@ -0,0 +1,32 @@
+# typed: true
+
+module Prism
+  # A set of constant names that can be shared between parses. When it is given
+  # as the `constant_pool` option, the parser looks names up in it before adding
+  # them to its own constant pool, and the C extension reuses the symbols that
+  # it holds instead of interning them again for every parse. This makes it
+  # worthwhile when parsing many files that use the same names, for example:
+  #
+  #     pool = Prism::SharedConstantPool.new(%i[require attr_reader private])
+  #     files.map { |file| Prism.parse_file(file, constant_pool: pool) }
+  #
+  # Instances are frozen and never modified by the parser, so they can be used
+  # by many parses at once.
+  class SharedConstantPool
+    # The symbols in the pool, in the order of their constant ids.
+    sig { returns(T::Array[Symbol]) }
+    attr_reader :symbols
+
+    # Initialize a new shared constant pool with the given names. Duplicate
+    # names are only added once.
+    sig { params(names: T::Array[::T.any(Symbol, String)]).void }
+    def initialize(names); end
+
+    # The number of constants in the pool.
+    sig { returns(Integer) }
+    def size; end
+
+    sig { params(symbols: T::Array[Symbol]).void }
+    private def compile(symbols); end
+  end
+end
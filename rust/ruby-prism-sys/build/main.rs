@@ -158,6 +158,7 @@ fn generate_bindings(ruby_include_path: &Path, clang_args: &[String], layout_tes
         .size_t_is_usize(true)
         .sort_semantically(true)
         // Structs
+        .allowlist_type("pm_comment_attachment_t")
         .allowlist_type("pm_comment_t")
         .allowlist_type("pm_constant_t")
         .allowlist_type("pm_diagnostic_t")
@@ -175,6 +176,7 @@ fn generate_bindings(ruby_include_path: &Path, clang_args: &[String], layout_tes
         .allowlist_type(r"^pm_\w+_node_t")
         .allowlist_type(r"^pm_\w+_flags")
         // Enums
+        .rustified_non_exhaustive_enum("pm_comment_attachment_kind_t")
         .rustified_non_exhaustive_enum("pm_comment_type_t")
         .rustified_non_exhaustive_enum("pm_error_level_t")
         .rustified_non_exhaustive_enum(r"pm_\w+_flags")
@@ -212,6 +214,7 @@ fn generate_bindings(ruby_include_path: &Path, clang_args: &[String], layout_tes
         .allowlist_function("pm_options_scopes_init")
         .allowlist_function("pm_options_version_set")
         .allowlist_function("pm_parse")
+        .allowlist_function("pm_parser_comments_attach")
         .allowlist_function("pm_parser_comments_each")
         .allowlist_function("pm_parser_comments_size")
         .allowlist_function("pm_parser_constant")
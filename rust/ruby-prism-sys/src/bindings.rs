@@ -9624,6 +9624,27 @@ pub struct pm_diagnostic_t {
 pub struct pm_comment_t {
     _unused: [u8; 0],
 }
+/** Where a comment is attached in the syntax tree, as computed by
+ pm_parser_comments_attach. The rules are the same as those used by
+ ParseResult#attach_comments! in the Ruby library.
+*/
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct pm_comment_attachment_t {
+    /** The id of the node that the comment is attached to, or of the node that
+ owns the location that the comment is attached to.
+*/
+    pub node_id: u32,
+    /** 0 if the comment is attached to the node itself. Otherwise the comment is
+ attached to a location field of the node, and this is one more than the
+ index of that location in the node's comment targets (the array returned
+ by Node#comment_targets in Ruby).
+*/
+    pub target: u32,
+    /** Whether this is a leading or a trailing comment.
+*/
+    pub kind: pm_comment_attachment_kind_t,
+}
 /** A list of offsets of the start of lines in a string. The offsets are assumed
  to be sorted/inserted in ascending order.
 */
@@ -10507,6 +10528,19 @@ pub enum pm_comment_type_t {
     PM_COMMENT_INLINE = 0,
     PM_COMMENT_EMBDOC = 1,
 }
+#[repr(u32)]
+#[non_exhaustive]
+/** How a comment is attached to its target in the syntax tree.
+*/
+#[derive(Debug, Copy, Clone, Hash, PartialEq, Eq)]
+pub enum pm_comment_attachment_kind_t {
+    /** The comment comes before its target.
+*/
+    PM_COMMENT_ATTACHMENT_LEADING = 0,
+    /** The comment comes after its target.
+*/
+    PM_COMMENT_ATTACHMENT_TRAILING = 1,
+}
 impl Default for pm_constant_id_list_t {
     fn default() -> Self {
         let mut s = ::std::mem::MaybeUninit::<Self>::uninit();
@@ -11959,6 +11993,23 @@ unsafe extern "C" {
         callback: pm_comment_callback_t,
         data: *mut ::std::os::raw::c_void,
     );
+    /** Computes where each comment found while parsing should be attached in the
+ given syntax tree, which must be the tree returned by parsing with the given
+ parser. This is a native implementation of ParseResult#attach_comments! from
+ the Ruby library that visits each node at most once and only descends into
+ nodes that contain comments.
+
+ @param parser the parser whose comments we want to attach
+ @param node the root of the syntax tree returned by the parser
+ @param attachments an array with room for pm_parser_comments_size(parser)
+     entries, which will be filled in with the attachment of each comment in
+     the order that the comments are yielded by pm_parser_comments_each
+*/
+    pub fn pm_parser_comments_attach(
+        parser: *const pm_parser_t,
+        node: *const pm_node_t,
+        attachments: *mut pm_comment_attachment_t,
+    );
     /** Returns the number of magic comments associated with the given parser.
 
  @param parser the parser whose magic comments we want to get the size of
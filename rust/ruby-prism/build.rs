@@ -243,6 +243,12 @@ fn write_node(file: &mut File, flags: &[Flags], node: &Node) -> Result<(), Box<d
     writeln!(file, "        Location::new(self.parser, unsafe {{ &(*pointer) }})")?;
     writeln!(file, "    }}")?;
     writeln!(file)?;
+    writeln!(file, "    /// Returns the id of this node, which is unique within the tree.")?;
+    writeln!(file, "    #[must_use]")?;
+    writeln!(file, "    pub fn node_id(&self) -> u32 {{")?;
+    writeln!(file, "        unsafe {{ (*self.pointer).base.node_id }}")?;
+    writeln!(file, "    }}")?;
+    writeln!(file)?;
     writeln!(file, "    /// Returns the flags of this node.")?;
     writeln!(file, "    #[must_use]")?;
     writeln!(file, "    pub fn flags(&self) -> pm_node_flags_t {{")?;
@@ -614,6 +620,17 @@ impl<'pr> Node<'pr> {{
     writeln!(file, "    }}")?;
     writeln!(file)?;
 
+    writeln!(file, "    /// Returns the id of this node, which is unique within the tree.")?;
+    writeln!(file, "    #[must_use]")?;
+    writeln!(file, "    pub fn node_id(&self) -> u32 {{")?;
+    writeln!(file, "        match *self {{")?;
+    for node in &config.nodes {
+        writeln!(file, "            Self::{} {{ pointer, .. }} => unsafe {{ (*pointer.cast::<pm_node_t>()).node_id }},", node.name)?;
+    }
+    writeln!(file, "        }}")?;
+    writeln!(file, "    }}")?;
+    writeln!(file)?;
+
     for node in &config.nodes {
         writeln!(file, "    /// Returns the node as a `{}`.", node.name)?;
         writeln!(file, "    #[must_use]")?;
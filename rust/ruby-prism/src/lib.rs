@@ -25,7 +25,7 @@ use std::ptr::NonNull;
 pub use self::bindings::*;
 pub use self::node::{ConstantId, ConstantList, ConstantListIter, Integer, NodeList, NodeListIter};
 pub use self::node_ext::{ConstantPathError, FullName};
-pub use self::parse_result::{Comment, CommentType, Comments, Diagnostic, Diagnostics, Location, MagicComment, MagicComments, ParseResult};
+pub use self::parse_result::{Comment, CommentAttachment, CommentAttachmentKind, CommentType, Comments, Diagnostic, Diagnostics, Location, MagicComment, MagicComments, ParseResult};
 
 use ruby_prism_sys::{
     pm_arena_new, pm_options_command_line_set, pm_options_encoding_locked_set, pm_options_encoding_set, pm_options_filepath_set, pm_options_free, pm_options_frozen_string_literal_set, pm_options_line_set, pm_options_main_script_set, pm_options_new, pm_options_partial_script_set,
@@ -391,6 +391,33 @@ mod tests {
         }
     }
 
+    #[test]
+    fn comment_attachments_test() {
+        let source = "# leading\nfoo # trailing\n";
+        let result = parse(source.as_ref());
+
+        let statement = result.node().as_program_node().unwrap().statements().body().iter().next().unwrap();
+        let attachments = result.comment_attachments();
+
+        assert_eq!(2, attachments.len());
+        assert_eq!(
+            super::CommentAttachment {
+                node_id: statement.node_id(),
+                target: 0,
+                kind: super::CommentAttachmentKind::Leading
+            },
+            attachments[0]
+        );
+        assert_eq!(
+            super::CommentAttachment {
+                node_id: statement.node_id(),
+                target: 0,
+                kind: super::CommentAttachmentKind::Trailing
+            },
+            attachments[1]
+        );
+    }
+
     #[test]
     fn line_offsets_test() {
         let source = "";
@@ -2,7 +2,7 @@
 
 use std::marker::PhantomData;
 
-use ruby_prism_sys::{pm_comment_location, pm_comment_t, pm_comment_type, pm_comment_type_t, pm_magic_comment_key, pm_magic_comment_t, pm_magic_comment_value, pm_parser_start, pm_parser_t};
+use ruby_prism_sys::{pm_comment_attachment_kind_t, pm_comment_attachment_t, pm_comment_location, pm_comment_t, pm_comment_type, pm_comment_type_t, pm_magic_comment_key, pm_magic_comment_t, pm_magic_comment_value, pm_parser_start, pm_parser_t};
 
 use super::Location;
 
@@ -82,6 +82,42 @@ impl<'pr> Iterator for Comments<'pr> {
     }
 }
 
+/// Whether a comment comes before or after its target.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CommentAttachmentKind {
+    /// The comment comes before its target.
+    Leading,
+    /// The comment comes after its target.
+    Trailing,
+}
+
+/// Where a comment is attached in the syntax tree, following the same rules
+/// as `ParseResult#attach_comments!` in the Ruby library.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct CommentAttachment {
+    /// The id of the node that the comment is attached to, or of the node that
+    /// owns the location that the comment is attached to.
+    pub node_id: u32,
+    /// 0 if the comment is attached to the node itself, otherwise one more than
+    /// the index of the location field it is attached to in the node's comment
+    /// targets.
+    pub target: u32,
+    /// Whether this is a leading or a trailing comment.
+    pub kind: CommentAttachmentKind,
+}
+
+impl CommentAttachment {
+    pub(crate) fn new(raw: &pm_comment_attachment_t) -> Self {
+        let kind = if raw.kind == pm_comment_attachment_kind_t::PM_COMMENT_ATTACHMENT_TRAILING {
+            CommentAttachmentKind::Trailing
+        } else {
+            CommentAttachmentKind::Leading
+        };
+
+        CommentAttachment { node_id: raw.node_id, target: raw.target, kind }
+    }
+}
+
 /// A magic comment that was found during parsing.
 #[derive(Debug)]
 pub struct MagicComment<'pr> {
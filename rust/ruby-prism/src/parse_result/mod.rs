@@ -6,11 +6,11 @@ mod diagnostics;
 use std::ptr::NonNull;
 
 use ruby_prism_sys::{
-    pm_arena_free, pm_arena_t, pm_comment_t, pm_diagnostic_t, pm_line_offset_list_line_column, pm_location_t, pm_magic_comment_t, pm_node_t, pm_parser_comments_each, pm_parser_comments_size, pm_parser_data_loc, pm_parser_errors_each, pm_parser_errors_size, pm_parser_free,
-    pm_parser_frozen_string_literal, pm_parser_line_offsets, pm_parser_magic_comments_each, pm_parser_magic_comments_size, pm_parser_start, pm_parser_start_line, pm_parser_t, pm_parser_warnings_each, pm_parser_warnings_size,
+    pm_arena_free, pm_arena_t, pm_comment_attachment_kind_t, pm_comment_attachment_t, pm_comment_t, pm_diagnostic_t, pm_line_offset_list_line_column, pm_location_t, pm_magic_comment_t, pm_node_t, pm_parser_comments_attach, pm_parser_comments_each, pm_parser_comments_size, pm_parser_data_loc,
+    pm_parser_errors_each, pm_parser_errors_size, pm_parser_free, pm_parser_frozen_string_literal, pm_parser_line_offsets, pm_parser_magic_comments_each, pm_parser_magic_comments_size, pm_parser_start, pm_parser_start_line, pm_parser_t, pm_parser_warnings_each, pm_parser_warnings_size,
 };
 
-pub use self::comments::{Comment, CommentType, Comments, MagicComment, MagicComments};
+pub use self::comments::{Comment, CommentAttachment, CommentAttachmentKind, CommentType, Comments, MagicComment, MagicComments};
 pub use self::diagnostics::{Diagnostic, Diagnostics};
 
 use crate::Node;
@@ -239,6 +239,27 @@ impl<'pr> ParseResult<'pr> {
         Comments::new(ptrs, self.parser)
     }
 
+    /// Returns where each comment is attached in the syntax tree, in the same
+    /// order as the comments returned by `comments`.
+    #[must_use]
+    pub fn comment_attachments(&self) -> Vec<CommentAttachment> {
+        let size = unsafe { pm_parser_comments_size(self.parser) };
+        let empty = pm_comment_attachment_t {
+            node_id: 0,
+            target: 0,
+            kind: pm_comment_attachment_kind_t::PM_COMMENT_ATTACHMENT_LEADING,
+        };
+        let mut attachments = vec![empty; size];
+
+        if size > 0 {
+            unsafe {
+                pm_parser_comments_attach(self.parser, self.node.as_ptr(), attachments.as_mut_ptr());
+            }
+        }
+
+        attachments.iter().map(CommentAttachment::new).collect()
+    }
+
     /// Returns an iterator that can be used to iterate over the magic comments in the
     /// parse result.
     #[must_use]
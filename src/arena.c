@@ -70,6 +70,23 @@ pm_arena_reserve(pm_arena_t *arena, size_t capacity) {
     pm_arena_block_new(arena, capacity, 0);
 }
 
+/**
+ * Release everything allocated from the arena since the given mark was taken,
+ * freeing any blocks that were allocated after it.
+ */
+void
+pm_arena_rewind(pm_arena_t *arena, pm_arena_mark_t mark) {
+    while (arena->current != mark.block) {
+        assert(arena->current != NULL && "mark is not from this arena");
+        pm_arena_block_t *prev = arena->current->prev;
+        xfree_sized(arena->current, PM_ARENA_BLOCK_SIZE(arena->current->capacity));
+        arena->current = prev;
+        arena->block_count--;
+    }
+
+    if (arena->current != NULL) arena->current->used = mark.used;
+}
+
 /**
  * Slow path for pm_arena_alloc: allocate a new block and return a pointer to
  * the first `size` bytes. Called when the current block has insufficient space.
@@ -0,0 +1,293 @@
+#include "prism/internal/comments.h"
+
+#include "prism/internal/allocator.h"
+#include "prism/internal/node.h"
+#include "prism/internal/parser.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * A comment that is waiting to be attached, along with the information about it
+ * that the attachment rules need.
+ */
+typedef struct {
+    /** The offset of the start of the comment. */
+    uint32_t start;
+
+    /** The offset just past the end of the comment. */
+    uint32_t end;
+
+    /** The index of the comment in the parser's list of comments. */
+    uint32_t index;
+
+    /**
+     * Whether the comment follows other code on the same line, matching
+     * Comment#trailing? in Ruby.
+     */
+    bool trailing;
+} pm_attach_comment_t;
+
+/**
+ * A child node or a location field of a node that a comment can be attached to.
+ */
+typedef struct {
+    /** The offset of the start of the target. */
+    uint32_t start;
+
+    /** The offset just past the end of the target. */
+    uint32_t end;
+
+    /** The node, or NULL if this is a location field. */
+    const pm_node_t *node;
+
+    /**
+     * For location fields, one more than the index of the location in the
+     * comment targets of the node that owns it.
+     */
+    uint32_t target;
+} pm_attach_target_t;
+
+/**
+ * The state of the attachment pass. The targets of every node on the path from
+ * the root to the node being searched live on a single stack.
+ */
+typedef struct {
+    /** The comments, sorted by their start offsets. */
+    pm_attach_comment_t *comments;
+
+    /** The attachments being computed, indexed like the parser's comments. */
+    pm_comment_attachment_t *attachments;
+
+    /** The stack of targets. */
+    pm_attach_target_t *targets;
+
+    /** The number of targets on the stack. */
+    size_t size;
+
+    /** The number of targets the stack has room for. */
+    size_t capacity;
+
+    /** The number of comment targets of the current node seen so far. */
+    uint32_t target_index;
+} pm_attach_t;
+
+/**
+ * Push a target onto the stack, growing it if necessary.
+ */
+static void
+pm_attach_target_push(pm_attach_t *attach, uint32_t start, uint32_t end, const pm_node_t *node, uint32_t target) {
+    if (attach->size == attach->capacity) {
+        size_t capacity = attach->capacity == 0 ? 64 : attach->capacity * 2;
+        pm_attach_target_t *targets = (pm_attach_target_t *) xrealloc_sized(attach->targets, capacity * sizeof(pm_attach_target_t), attach->capacity * sizeof(pm_attach_target_t));
+        if (targets == NULL) abort();
+
+        attach->targets = targets;
+        attach->capacity = capacity;
+    }
+
+    attach->targets[attach->size++] = (pm_attach_target_t) { .start = start, .end = end, .node = node, .target = target };
+}
+
+/**
+ * Called for each comment target of a node. As in the Ruby implementation, a
+ * statements node is replaced by the statements that it contains.
+ */
+static void
+pm_attach_target_each(const pm_node_t *node, const pm_location_t *location, void *data) {
+    pm_attach_t *attach = (pm_attach_t *) data;
+    uint32_t index = attach->target_index++;
+
+    if (node == NULL) {
+        pm_attach_target_push(attach, location->start, location->start + location->length, NULL, index + 1);
+    } else if (PM_NODE_TYPE_P(node, PM_STATEMENTS_NODE)) {
+        const pm_node_list_t *body = &((const pm_statements_node_t *) node)->body;
+
+        for (size_t body_index = 0; body_index < body->size; body_index++) {
+            const pm_node_t *statement = body->nodes[body_index];
+            pm_attach_target_push(attach, statement->location.start, statement->location.start + statement->location.length, statement, 0);
+        }
+    } else {
+        pm_attach_target_push(attach, node->location.start, node->location.start + node->location.length, node, 0);
+    }
+}
+
+/**
+ * Record the attachment of a comment to the given target of the given node, or
+ * to the node itself if target is NULL.
+ */
+static void
+pm_attach_record(pm_attach_t *attach, const pm_attach_comment_t *comment, const pm_node_t *owner, const pm_attach_target_t *target, pm_comment_attachment_kind_t kind) {
+    pm_comment_attachment_t *attachment = &attach->attachments[comment->index];
+    attachment->kind = kind;
+
+    if (target == NULL) {
+        attachment->node_id = owner->node_id;
+        attachment->target = 0;
+    } else if (target->node != NULL) {
+        attachment->node_id = target->node->node_id;
+        attachment->target = 0;
+    } else {
+        attachment->node_id = owner->node_id;
+        attachment->target = target->target;
+    }
+}
+
+/**
+ * Attach the comments in [from, to), all of which are within the given node,
+ * to the node's targets. Both the comments and the targets are sorted, so this
+ * is a single merge over the two, recursing into any target that encloses a
+ * run of comments.
+ */
+static void
+pm_attach_node(pm_attach_t *attach, const pm_node_t *node, size_t from, size_t to) {
+    size_t base = attach->size;
+    attach->target_index = 0;
+    pm_node_comment_targets_each(node, pm_attach_target_each, attach);
+    size_t count = attach->size - base;
+
+    // Targets are almost always already in source order, so an insertion
+    // sort is effectively a single pass.
+    pm_attach_target_t *targets = attach->targets + base;
+    for (size_t index = 1; index < count; index++) {
+        pm_attach_target_t target = targets[index];
+        size_t cursor = index;
+
+        while (cursor > 0 && targets[cursor - 1].start > target.start) {
+            targets[cursor] = targets[cursor - 1];
+            cursor--;
+        }
+
+        targets[cursor] = target;
+    }
+
+    size_t next = 0;
+    size_t index = from;
+
+    while (index < to) {
+        const pm_attach_comment_t *comment = &attach->comments[index];
+        targets = attach->targets + base;
+
+        // Skip past every target that ends before this comment starts. The
+        // last of these is the nearest preceding target.
+        while (next < count && targets[next].end <= comment->start) next++;
+
+        // If the next target is a node that encloses this comment, then it
+        // encloses every following comment that starts before it ends, so
+        // recurse into it with all of them.
+        if (next < count && targets[next].node != NULL && targets[next].start <= comment->start && comment->end <= targets[next].end) {
+            const pm_attach_target_t enclosing = targets[next];
+            size_t end = index + 1;
+
+            while (end < to && attach->comments[end].end <= enclosing.end) end++;
+            pm_attach_node(attach, enclosing.node, index, end);
+
+            index = end;
+            continue;
+        }
+
+        const pm_attach_target_t *preceding = next > 0 ? &targets[next - 1] : NULL;
+        const pm_attach_target_t *following = (next < count && comment->end <= targets[next].start) ? &targets[next] : NULL;
+
+        if (comment->trailing) {
+            if (preceding != NULL) {
+                pm_attach_record(attach, comment, node, preceding, PM_COMMENT_ATTACHMENT_TRAILING);
+            } else {
+                pm_attach_record(attach, comment, node, following, PM_COMMENT_ATTACHMENT_LEADING);
+            }
+        } else {
+            // If a comment exists on its own line, prefer a leading comment.
+            if (following != NULL) {
+                pm_attach_record(attach, comment, node, following, PM_COMMENT_ATTACHMENT_LEADING);
+            } else if (preceding != NULL) {
+                pm_attach_record(attach, comment, node, preceding, PM_COMMENT_ATTACHMENT_TRAILING);
+            } else {
+                pm_attach_record(attach, comment, node, NULL, PM_COMMENT_ATTACHMENT_LEADING);
+            }
+        }
+
+        index++;
+    }
+
+    attach->size = base;
+}
+
+/**
+ * Returns true if there is anything other than whitespace between the start of
+ * the line and the given inline comment, matching Comment#trailing? in Ruby.
+ */
+static bool
+pm_attach_comment_trailing(const uint8_t *source, const pm_comment_t *comment) {
+    if (comment->type != PM_COMMENT_INLINE) return false;
+
+    for (const uint8_t *cursor = source + comment->location.start; cursor > source && cursor[-1] != '\n'; cursor--) {
+        switch (cursor[-1]) {
+            case ' ': case '\t': case '\v': case '\f': case '\r': case '\0':
+                break;
+            default:
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Compare two comments by their start offsets, falling back to their original
+ * order so that the sort is deterministic.
+ */
+static int
+pm_attach_comment_compare(const void *left, const void *right) {
+    const pm_attach_comment_t *left_comment = (const pm_attach_comment_t *) left;
+    const pm_attach_comment_t *right_comment = (const pm_attach_comment_t *) right;
+
+    if (left_comment->start != right_comment->start) return left_comment->start < right_comment->start ? -1 : 1;
+    return left_comment->index < right_comment->index ? -1 : (left_comment->index > right_comment->index);
+}
+
+/**
+ * Computes where each comment found while parsing should be attached in the
+ * given syntax tree.
+ */
+void
+pm_parser_comments_attach(const pm_parser_t *parser, const pm_node_t *node, pm_comment_attachment_t *attachments) {
+    size_t size = parser->comment_list.size;
+    if (size == 0) return;
+
+    pm_attach_comment_t *comments = (pm_attach_comment_t *) xmalloc(size * sizeof(pm_attach_comment_t));
+    if (comments == NULL) abort();
+
+    // Comments in heredocs are found before the rest of the line that the
+    // heredoc starts on, so they are not necessarily in source order.
+    uint32_t index = 0;
+    for (const pm_list_node_t *current = parser->comment_list.head; current != NULL; current = current->next) {
+        const pm_comment_t *comment = (const pm_comment_t *) current;
+
+        comments[index] = (pm_attach_comment_t) {
+            .start = comment->location.start,
+            .end = comment->location.start + comment->location.length,
+            .index = index,
+            .trailing = pm_attach_comment_trailing(parser->start, comment)
+        };
+
+        index++;
+    }
+
+    qsort(comments, size, sizeof(pm_attach_comment_t), pm_attach_comment_compare);
+
+    pm_attach_t attach = {
+        .comments = comments,
+        .attachments = attachments,
+        .targets = NULL,
+        .size = 0,
+        .capacity = 0,
+        .target_index = 0
+    };
+
+    pm_attach_node(&attach, node, 0, size);
+    assert(attach.size == 0);
+
+    xfree_sized(attach.targets, attach.capacity * sizeof(pm_attach_target_t));
+    xfree_sized(comments, size * sizeof(pm_attach_comment_t));
+}
@@ -2,10 +2,12 @@
 
 #include "prism/compiler/align.h"
 #include "prism/compiler/inline.h"
+#include "prism/internal/allocator.h"
 #include "prism/internal/arena.h"
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 /**
  * Initialize a list of constant ids.
@@ -65,14 +67,58 @@ pm_constant_id_list_insert(pm_constant_id_list_t *list, size_t index, pm_constan
 }
 
 /**
- * Checks if the current constant id list includes the given constant id.
+ * Mix the bits of a constant id so that sequential ids spread across the slots
+ * of a constant id set.
+ */
+static PRISM_INLINE uint32_t
+pm_constant_id_set_hash(pm_constant_id_t id) {
+    id = ((id >> 16) ^ id) * 0x45d9f3b;
+    id = ((id >> 16) ^ id) * 0x45d9f3b;
+    return (id >> 16) ^ id;
+}
+
+/**
+ * Add a constant id to a set of constant ids, growing the set once it is half
+ * full. Returns false if the id was already present in the set.
  */
 bool
-pm_constant_id_list_includes(pm_constant_id_list_t *list, pm_constant_id_t id) {
-    for (size_t index = 0; index < list->size; index++) {
-        if (list->ids[index] == id) return true;
+pm_constant_id_set_add(pm_arena_t *arena, pm_constant_id_set_t *set, pm_constant_id_t id) {
+    assert(id != PM_CONSTANT_ID_UNSET);
+
+    if (set->size * 2 >= set->capacity) {
+        uint32_t next_capacity = set->capacity == 0 ? 8 : set->capacity * 2;
+        uint32_t mask = next_capacity - 1;
+        pm_constant_id_t *next_ids = (pm_constant_id_t *) pm_arena_zalloc(arena, next_capacity * sizeof(pm_constant_id_t), PRISM_ALIGNOF(pm_constant_id_t));
+
+        for (uint32_t index = 0; index < set->capacity; index++) {
+            pm_constant_id_t existing = set->ids[index];
+            if (existing == PM_CONSTANT_ID_UNSET) continue;
+
+            uint32_t hash = pm_constant_id_set_hash(existing);
+            while (next_ids[hash & mask] != PM_CONSTANT_ID_UNSET) hash++;
+            next_ids[hash & mask] = existing;
+        }
+
+        set->ids = next_ids;
+        set->capacity = next_capacity;
+    }
+
+    uint32_t mask = set->capacity - 1;
+    uint32_t hash = pm_constant_id_set_hash(id);
+
+    while (true) {
+        pm_constant_id_t *slot = &set->ids[hash & mask];
+
+        if (*slot == PM_CONSTANT_ID_UNSET) {
+            *slot = id;
+            set->size++;
+            return true;
+        } else if (*slot == id) {
+            return false;
+        }
+
+        hash++;
     }
-    return false;
 }
 
 /**
@@ -207,6 +253,10 @@ pm_constant_pool_resize(pm_arena_t *arena, pm_constant_pool_t *pool) {
     pool->constants = next_constants;
     pool->buckets = next_buckets;
     pool->capacity = next_capacity;
+
+#ifdef PRISM_STATS
+    pool->stats_resizes++;
+#endif
 }
 
 /**
@@ -220,6 +270,13 @@ pm_constant_pool_init(pm_arena_t *arena, pm_constant_pool_t *pool, uint32_t capa
     pool->constants = (pm_constant_t *) pm_arena_alloc(arena, capacity * sizeof(pm_constant_t), PRISM_ALIGNOF(pm_constant_t));
     pool->size = 0;
     pool->capacity = capacity;
+    pool->base = NULL;
+
+#ifdef PRISM_STATS
+    pool->stats_inserts = 0;
+    pool->stats_collisions = 0;
+    pool->stats_resizes = 0;
+#endif
 }
 
 /**
@@ -227,20 +284,25 @@ pm_constant_pool_init(pm_arena_t *arena, pm_constant_pool_t *pool, uint32_t capa
  */
 pm_constant_t *
 pm_constant_pool_id_to_constant(const pm_constant_pool_t *pool, pm_constant_id_t constant_id) {
-    assert(constant_id != PM_CONSTANT_ID_UNSET && constant_id <= pool->size);
-    return &pool->constants[constant_id - 1];
+    uint32_t base_size = pm_constant_pool_base_size(pool);
+    if (constant_id <= base_size) {
+        assert(constant_id != PM_CONSTANT_ID_UNSET);
+        return &pool->base->constants[constant_id - 1];
+    }
+
+    assert(constant_id != PM_CONSTANT_ID_UNSET && constant_id - base_size <= pool->size);
+    return &pool->constants[constant_id - base_size - 1];
 }
 
 /**
- * Find a constant in a constant pool. Returns the id of the constant, or 0 if
- * the constant is not found.
+ * Find a constant with the given hash in a constant pool, ignoring its base
+ * pool. Returns the id of the constant, or 0 if the constant is not found.
  */
-pm_constant_id_t
-pm_constant_pool_find(const pm_constant_pool_t *pool, const uint8_t *start, size_t length) {
+static PRISM_INLINE pm_constant_id_t
+pm_constant_pool_find_hashed(const pm_constant_pool_t *pool, uint32_t hash, const uint8_t *start, size_t length) {
     assert(is_power_of_two(pool->capacity));
     const uint32_t mask = pool->capacity - 1;
 
-    uint32_t hash = pm_constant_pool_hash(start, length);
     uint32_t index = hash & mask;
     pm_constant_pool_bucket_t *bucket;
 
@@ -257,6 +319,22 @@ pm_constant_pool_find(const pm_constant_pool_t *pool, const uint8_t *start, size
     return PM_CONSTANT_ID_UNSET;
 }
 
+/**
+ * Find a constant in a constant pool. Returns the id of the constant, or 0 if
+ * the constant is not found.
+ */
+pm_constant_id_t
+pm_constant_pool_find(const pm_constant_pool_t *pool, const uint8_t *start, size_t length) {
+    uint32_t hash = pm_constant_pool_hash(start, length);
+
+    if (pool->base != NULL) {
+        pm_constant_id_t id = pm_constant_pool_find_hashed(pool->base, hash, start, length);
+        if (id != PM_CONSTANT_ID_UNSET) return id;
+    }
+
+    return pm_constant_pool_find_hashed(pool, hash, start, length);
+}
+
 /**
  * Insert a constant into a constant pool and return its index in the pool.
  */
@@ -266,12 +344,25 @@ pm_constant_pool_insert(pm_arena_t *arena, pm_constant_pool_t *pool, const uint8
         pm_constant_pool_resize(arena, pool);
     }
 
+#ifdef PRISM_STATS
+    pool->stats_inserts++;
+#endif
+
+    uint32_t hash = pm_constant_pool_hash(start, length);
+
+    // Constants that are in the base pool keep their ids there, which is what
+    // makes them stable across every pool that shares the same base.
+    if (pool->base != NULL) {
+        pm_constant_id_t id = pm_constant_pool_find_hashed(pool->base, hash, start, length);
+        if (id != PM_CONSTANT_ID_UNSET) return id;
+    }
+
     assert(is_power_of_two(pool->capacity));
     const uint32_t mask = pool->capacity - 1;
 
-    uint32_t hash = pm_constant_pool_hash(start, length);
     uint32_t index = hash & mask;
     pm_constant_pool_bucket_t *bucket;
+    uint32_t base_size = pm_constant_pool_base_size(pool);
 
     while (bucket = &pool->buckets[index], bucket->id != PM_CONSTANT_ID_UNSET) {
         // If there is a collision, then we need to check if the content is the
@@ -288,19 +379,23 @@ pm_constant_pool_insert(pm_arena_t *arena, pm_constant_pool_t *pool, const uint8
                 // shared constant to prefer non-owned references.
                 bucket->start = start;
                 bucket->type = (unsigned int) (type & 0x3);
-                pool->constants[bucket->id - 1].start = start;
+                pool->constants[bucket->id - base_size - 1].start = start;
             }
 
             return bucket->id;
         }
 
+#ifdef PRISM_STATS
+        pool->stats_collisions++;
+#endif
+
         index = (index + 1) & mask;
     }
 
-    // IDs are allocated starting at 1, since the value 0 denotes a non-existent
-    // constant.
-    uint32_t id = ++pool->size;
-    assert(pool->size < ((uint32_t) (1 << 30)));
+    // IDs are allocated starting at 1 (after those of the base pool), since
+    // the value 0 denotes a non-existent constant.
+    uint32_t id = base_size + ++pool->size;
+    assert(id < ((uint32_t) (1 << 30)));
 
     *bucket = (pm_constant_pool_bucket_t) {
         .id = (unsigned int) (id & 0x3fffffff),
@@ -310,7 +405,7 @@ pm_constant_pool_insert(pm_arena_t *arena, pm_constant_pool_t *pool, const uint8
         .length = length
     };
 
-    pool->constants[id - 1] = (pm_constant_t) {
+    pool->constants[pool->size - 1] = (pm_constant_t) {
         .start = start,
         .length = length,
     };
@@ -347,6 +442,39 @@ pm_constant_pool_insert_constant(pm_arena_t *arena, pm_constant_pool_t *pool, co
     return pm_constant_pool_insert(arena, pool, start, length, PM_CONSTANT_POOL_BUCKET_CONSTANT);
 }
 
+/**
+ * Move the constants with ids up to the given id that are slices of the old
+ * source over to the new source, which differs from it by replacing the range
+ * from start to end. Constants within that range no longer exist in the new
+ * source, so they are copied into the arena instead.
+ */
+void
+pm_constant_pool_rebase(pm_arena_t *arena, pm_constant_pool_t *pool, pm_constant_id_t maximum, const uint8_t *old_source, size_t old_size, const uint8_t *new_source, uint32_t start, uint32_t end, int64_t delta) {
+    uint32_t base_size = pm_constant_pool_base_size(pool);
+
+    for (uint32_t index = 0; index < pool->capacity; index++) {
+        pm_constant_pool_bucket_t *bucket = &pool->buckets[index];
+        if (bucket->id == PM_CONSTANT_ID_UNSET || bucket->id > maximum) continue;
+        if (bucket->type != PM_CONSTANT_POOL_BUCKET_DEFAULT) continue;
+        if (bucket->start < old_source || bucket->start >= old_source + old_size) continue;
+
+        ptrdiff_t offset = bucket->start - old_source;
+        const uint8_t *next;
+
+        if (offset >= (ptrdiff_t) end) {
+            next = new_source + offset + delta;
+        } else if (offset >= (ptrdiff_t) start) {
+            next = (const uint8_t *) pm_arena_memdup(arena, bucket->start, bucket->length, 1);
+            bucket->type = (unsigned int) (PM_CONSTANT_POOL_BUCKET_OWNED & 0x3);
+        } else {
+            next = new_source + offset;
+        }
+
+        bucket->start = next;
+        pool->constants[bucket->id - base_size - 1].start = next;
+    }
+}
+
 /**
  * Return a raw pointer to the start of a constant.
  */
@@ -361,3 +489,72 @@ pm_constant_start(const pm_constant_t *constant) {
 size_t pm_constant_length(const pm_constant_t *constant) {
     return constant->length;
 }
+
+/**
+ * Allocate a new, empty shared constant pool.
+ */
+pm_shared_constant_pool_t *
+pm_shared_constant_pool_new(void) {
+    pm_shared_constant_pool_t *pool = (pm_shared_constant_pool_t *) xcalloc(1, sizeof(pm_shared_constant_pool_t));
+    if (pool == NULL) abort();
+
+    pool->arena = pm_arena_new();
+    pm_constant_pool_init(pool->arena, &pool->pool, 64);
+    return pool;
+}
+
+/**
+ * Insert a constant into a shared constant pool, copying its contents into the
+ * pool's arena if it is not already present.
+ */
+pm_constant_id_t
+pm_shared_constant_pool_insert(pm_shared_constant_pool_t *pool, const uint8_t *start, size_t length) {
+    pm_constant_id_t id = pm_constant_pool_find(&pool->pool, start, length);
+    if (id != PM_CONSTANT_ID_UNSET) return id;
+
+    uint8_t *memory = (uint8_t *) pm_arena_alloc(pool->arena, length, 1);
+    if (length > 0) memcpy(memory, start, length);
+
+    return pm_constant_pool_insert_owned(pool->arena, &pool->pool, memory, length);
+}
+
+/**
+ * Return the number of constants in a shared constant pool.
+ */
+size_t
+pm_shared_constant_pool_size(const pm_shared_constant_pool_t *pool) {
+    return pool->pool.size;
+}
+
+/**
+ * Return the constant with the given id in a shared constant pool.
+ */
+const pm_constant_t *
+pm_shared_constant_pool_constant(const pm_shared_constant_pool_t *pool, pm_constant_id_t constant_id) {
+    return pm_constant_pool_id_to_constant(&pool->pool, constant_id);
+}
+
+/**
+ * Attach arbitrary data to a shared constant pool.
+ */
+void
+pm_shared_constant_pool_data_set(pm_shared_constant_pool_t *pool, void *data) {
+    pool->data = data;
+}
+
+/**
+ * Return the data that was attached to a shared constant pool.
+ */
+void *
+pm_shared_constant_pool_data(const pm_shared_constant_pool_t *pool) {
+    return pool->data;
+}
+
+/**
+ * Free a shared constant pool and all of its constants.
+ */
+void
+pm_shared_constant_pool_free(pm_shared_constant_pool_t *pool) {
+    pm_arena_free(pool->arena);
+    xfree_sized(pool, sizeof(pm_shared_constant_pool_t));
+}
@@ -1,9 +1,13 @@
 #include "prism/internal/encoding.h"
 
+#include "prism/compiler/accel.h"
+#include "prism/compiler/inline.h"
 #include "prism/compiler/unused.h"
+#include "prism/internal/bit.h"
 #include "prism/internal/strncasecmp.h"
 
 #include <assert.h>
+#include <string.h>
 
 typedef uint32_t pm_unicode_codepoint_t;
 
@@ -765,6 +769,31 @@ static const pm_unicode_codepoint_t unicode_alpha_codepoints[UNICODE_ALPHA_CODEP
     0x31350, 0x33479,
 };
 
+/**
+ * For each 256-codepoint page of the basic multilingual plane, the index into
+ * the table above of the first range that ends on or after the start of that
+ * page. The final entry does the same for the supplementary planes.
+ */
+static const uint16_t unicode_alpha_pages[257] = {
+    0, 0, 0, 10, 30, 32, 54, 72, 82, 102, 142, 198, 256, 304, 344, 372,
+    384, 402, 402, 428, 440, 440, 440, 450, 470, 476, 490, 502, 516, 536, 540, 540,
+    578, 584, 612, 612, 612, 614, 614, 614, 614, 614, 614, 614, 614, 620, 650, 652,
+    652, 668, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676,
+    676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 676, 678, 678,
+    678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678,
+    678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678,
+    678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678,
+    678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678,
+    678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678, 678,
+    678, 678, 678, 678, 678, 682, 682, 694, 700, 716, 732, 750, 766, 766, 766, 766,
+    766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766,
+    766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766, 766,
+    766, 766, 766, 766, 766, 766, 766, 766, 772, 772, 772, 772, 772, 772, 772, 772,
+    772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772,
+    772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 772, 776, 794, 794, 802, 806,
+    820,
+};
+
 #define UNICODE_ALNUM_CODEPOINTS_LENGTH 1598
 static const pm_unicode_codepoint_t unicode_alnum_codepoints[UNICODE_ALNUM_CODEPOINTS_LENGTH] = {
     0x100, 0x2C1,
@@ -1568,6 +1597,27 @@ static const pm_unicode_codepoint_t unicode_alnum_codepoints[UNICODE_ALNUM_CODEP
     0x31350, 0x33479,
 };
 
+// The same page index as unicode_alpha_pages, for the table above.
+static const uint16_t unicode_alnum_pages[257] = {
+    0, 0, 0, 10, 30, 32, 54, 70, 80, 100, 142, 200, 262, 314, 358, 390,
+    404, 420, 420, 446, 458, 458, 458, 468, 490, 498, 514, 530, 544, 564, 568, 568,
+    606, 612, 640, 640, 640, 642, 642, 642, 642, 642, 642, 642, 642, 648, 678, 680,
+    680, 696, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704,
+    704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 704, 706, 706,
+    706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706,
+    706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706,
+    706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706,
+    706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706,
+    706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706, 706,
+    706, 706, 706, 706, 706, 710, 710, 720, 726, 742, 756, 776, 794, 794, 794, 794,
+    794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794,
+    794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794, 794,
+    794, 794, 794, 794, 794, 794, 794, 794, 800, 800, 800, 800, 800, 800, 800, 800,
+    800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800,
+    800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 800, 804, 822, 822, 830, 834,
+    850,
+};
+
 #define UNICODE_ISUPPER_CODEPOINTS_LENGTH 1320
 static const pm_unicode_codepoint_t unicode_isupper_codepoints[UNICODE_ISUPPER_CODEPOINTS_LENGTH] = {
     0x100, 0x100,
@@ -2232,6 +2282,27 @@ static const pm_unicode_codepoint_t unicode_isupper_codepoints[UNICODE_ISUPPER_C
     0x1F170, 0x1F189,
 };
 
+// The same page index as unicode_alpha_pages, for the table above.
+static const uint16_t unicode_isupper_pages[257] = {
+    0, 0, 214, 282, 336, 488, 538, 538, 538, 538, 538, 538, 538, 538, 538, 538,
+    538, 544, 544, 544, 546, 546, 546, 546, 546, 546, 546, 546, 546, 552, 552, 800,
+    836, 836, 866, 866, 866, 868, 868, 868, 868, 868, 868, 868, 868, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992,
+    992, 992, 992, 992, 992, 992, 992, 1066, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226, 1226,
+    1228,
+};
+
 /**
  * Each element of the following table contains a bitfield that indicates a
  * piece of information about the corresponding unicode codepoint. Note that
@@ -2261,12 +2332,24 @@ const uint8_t pm_encoding_unicode_table[256] = {
 
 /**
  * Binary search through the given list of codepoints to see if the given
- * codepoint is in the list.
+ * codepoint is in the list. The page index narrows the search down to the
+ * ranges that overlap the codepoint's page first, which for most pages is a
+ * handful of ranges or none at all.
  */
 static bool
-pm_unicode_codepoint_match(pm_unicode_codepoint_t codepoint, const pm_unicode_codepoint_t *codepoints, size_t size) {
-    size_t start = 0;
-    size_t end = size;
+pm_unicode_codepoint_match(pm_unicode_codepoint_t codepoint, const pm_unicode_codepoint_t *codepoints, const uint16_t *pages, size_t size) {
+    size_t page = codepoint >> 8;
+    size_t start;
+    size_t end;
+
+    if (page < 256) {
+        start = pages[page];
+        end = pages[page + 1] + 2;
+        if (end > size) end = size;
+    } else {
+        start = pages[256];
+        end = size;
+    }
 
     while (start < end) {
         size_t middle = start + (end - start) / 2;
@@ -2396,7 +2479,7 @@ pm_encoding_utf_8_alpha_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & PRISM_ENCODING_ALPHABETIC_BIT) ? width : 0;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_alpha_codepoints, UNICODE_ALPHA_CODEPOINTS_LENGTH) ? width : 0;
+        return pm_unicode_codepoint_match(codepoint, unicode_alpha_codepoints, unicode_alpha_pages, UNICODE_ALPHA_CODEPOINTS_LENGTH) ? width : 0;
     }
 }
 
@@ -2420,7 +2503,7 @@ pm_encoding_utf_8_alnum_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & (PRISM_ENCODING_ALPHANUMERIC_BIT)) ? width : 0;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_alnum_codepoints, UNICODE_ALNUM_CODEPOINTS_LENGTH) ? width : 0;
+        return pm_unicode_codepoint_match(codepoint, unicode_alnum_codepoints, unicode_alnum_pages, UNICODE_ALNUM_CODEPOINTS_LENGTH) ? width : 0;
     }
 }
 
@@ -2444,7 +2527,7 @@ pm_encoding_utf_8_isupper_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & PRISM_ENCODING_UPPERCASE_BIT) ? true : false;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_isupper_codepoints, UNICODE_ISUPPER_CODEPOINTS_LENGTH) ? true : false;
+        return pm_unicode_codepoint_match(codepoint, unicode_isupper_codepoints, unicode_isupper_pages, UNICODE_ISUPPER_CODEPOINTS_LENGTH) ? true : false;
     }
 }
 
@@ -2517,7 +2600,7 @@ pm_encoding_cesu_8_alpha_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & PRISM_ENCODING_ALPHABETIC_BIT) ? width : 0;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_alpha_codepoints, UNICODE_ALPHA_CODEPOINTS_LENGTH) ? width : 0;
+        return pm_unicode_codepoint_match(codepoint, unicode_alpha_codepoints, unicode_alpha_pages, UNICODE_ALPHA_CODEPOINTS_LENGTH) ? width : 0;
     }
 }
 
@@ -2537,7 +2620,7 @@ pm_encoding_cesu_8_alnum_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & (PRISM_ENCODING_ALPHANUMERIC_BIT)) ? width : 0;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_alnum_codepoints, UNICODE_ALNUM_CODEPOINTS_LENGTH) ? width : 0;
+        return pm_unicode_codepoint_match(codepoint, unicode_alnum_codepoints, unicode_alnum_pages, UNICODE_ALNUM_CODEPOINTS_LENGTH) ? width : 0;
     }
 }
 
@@ -2557,7 +2640,7 @@ pm_encoding_cesu_8_isupper_char(const uint8_t *b, ptrdiff_t n) {
     if (codepoint <= 0xFF) {
         return (pm_encoding_unicode_table[(uint8_t) codepoint] & PRISM_ENCODING_UPPERCASE_BIT) ? true : false;
     } else {
-        return pm_unicode_codepoint_match(codepoint, unicode_isupper_codepoints, UNICODE_ISUPPER_CODEPOINTS_LENGTH) ? true : false;
+        return pm_unicode_codepoint_match(codepoint, unicode_isupper_codepoints, unicode_isupper_pages, UNICODE_ISUPPER_CODEPOINTS_LENGTH) ? true : false;
     }
 }
 
@@ -4399,6 +4482,52 @@ pm_encoding_gbk_char_width(const uint8_t *b, ptrdiff_t n) {
 
 #endif
 
+/**
+ * The two-byte characters of the Shift_JIS family whose lead and trailing
+ * bytes are all valid together.
+ */
+static const pm_encoding_double_byte_t pm_encoding_shift_jis_double_byte = {
+    .lead = { { 0x81, 0x9F }, { 0xE0, 0xFC } },
+    .trail = { { 0x40, 0x7E }, { 0x80, 0xFC } }
+};
+
+/**
+ * The two-byte characters of the EUC family, where both bytes are between 0xA1
+ * and 0xFE. This also covers the GB2312 characters of GBK.
+ */
+static const pm_encoding_double_byte_t pm_encoding_euc_double_byte = {
+    .lead = { { 0xA1, 0xFE }, { 0xA1, 0xFE } },
+    .trail = { { 0xA1, 0xFE }, { 0xA1, 0xFE } }
+};
+
+#ifndef PRISM_ENCODING_EXCLUDE_FULL
+
+/**
+ * The two-byte characters of the Big5 family.
+ */
+static const pm_encoding_double_byte_t pm_encoding_big5_double_byte = {
+    .lead = { { 0xA1, 0xFE }, { 0xA1, 0xFE } },
+    .trail = { { 0x40, 0x7E }, { 0xA1, 0xFE } }
+};
+
+/**
+ * The two-byte characters of CP949 whose trailing byte is not ASCII.
+ */
+static const pm_encoding_double_byte_t pm_encoding_cp949_double_byte = {
+    .lead = { { 0x81, 0xFE }, { 0x81, 0xFE } },
+    .trail = { { 0x81, 0xFE }, { 0x81, 0xFE } }
+};
+
+/**
+ * The two-byte characters of GB18030.
+ */
+static const pm_encoding_double_byte_t pm_encoding_gb18030_double_byte = {
+    .lead = { { 0x81, 0xFE }, { 0x81, 0xFE } },
+    .trail = { { 0x40, 0x7E }, { 0x80, 0xFE } }
+};
+
+#endif
+
 /**
  * This is the table of all of the encodings that prism supports.
  */
@@ -4433,7 +4562,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_euc_jp_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_WINDOWS_31J] = {
         .name = "Windows-31J",
@@ -4441,7 +4571,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
 
 #ifndef PRISM_ENCODING_EXCLUDE_FULL
@@ -4451,7 +4582,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_big5_double_byte
     },
     [PM_ENCODING_BIG5_HKSCS] = {
         .name = "Big5-HKSCS",
@@ -4459,7 +4591,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_big5_double_byte
     },
     [PM_ENCODING_BIG5_UAO] = {
         .name = "Big5-UAO",
@@ -4467,7 +4600,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_big5_double_byte
     },
     [PM_ENCODING_CESU_8] = {
         .name = "CESU-8",
@@ -4483,7 +4617,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_euc_jp_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_CP850] = {
         .name = "CP850",
@@ -4515,7 +4650,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_cp949_double_byte
     },
     [PM_ENCODING_CP950] = {
         .name = "CP950",
@@ -4523,7 +4659,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_big5_double_byte
     },
     [PM_ENCODING_CP951] = {
         .name = "CP951",
@@ -4531,7 +4668,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_big5_double_byte
     },
     [PM_ENCODING_EMACS_MULE] = {
         .name = "Emacs-Mule",
@@ -4547,7 +4685,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_euc_jp_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_EUC_JIS_2004] = {
         .name = "EUC-JIS-2004",
@@ -4555,7 +4694,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_euc_jp_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_EUC_KR] = {
         .name = "EUC-KR",
@@ -4563,7 +4703,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_EUC_TW] = {
         .name = "EUC-TW",
@@ -4571,7 +4712,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_GB12345] = {
         .name = "GB12345",
@@ -4579,7 +4721,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_GB18030] = {
         .name = "GB18030",
@@ -4587,7 +4730,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_gb18030_double_byte
     },
     [PM_ENCODING_GB1988] = {
         .name = "GB1988",
@@ -4603,7 +4747,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_GBK] = {
         .name = "GBK",
@@ -4611,7 +4756,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_ascii_alnum_char_7bit,
         .alpha_char = pm_encoding_ascii_alpha_char_7bit,
         .isupper_char = pm_encoding_ascii_isupper_char_7bit,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_euc_double_byte
     },
     [PM_ENCODING_IBM437] = {
         .name = "IBM437",
@@ -4915,7 +5061,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
     [PM_ENCODING_MAC_ROMAN] = {
         .name = "macRoman",
@@ -4963,7 +5110,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
     [PM_ENCODING_SJIS_DOCOMO] = {
         .name = "SJIS-DoCoMo",
@@ -4971,7 +5119,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
     [PM_ENCODING_SJIS_KDDI] = {
         .name = "SJIS-KDDI",
@@ -4979,7 +5128,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
     [PM_ENCODING_SJIS_SOFTBANK] = {
         .name = "SJIS-SoftBank",
@@ -4987,7 +5137,8 @@ const pm_encoding_t pm_encodings[] = {
         .alnum_char = pm_encoding_shift_jis_alnum_char,
         .alpha_char = pm_encoding_shift_jis_alpha_char,
         .isupper_char = pm_encoding_shift_jis_isupper_char,
-        .multibyte = true
+        .multibyte = true,
+        .double_byte = &pm_encoding_shift_jis_double_byte
     },
     [PM_ENCODING_STATELESS_ISO_2022_JP] = {
         .name = "stateless-ISO-2022-JP",
@@ -5343,3 +5494,352 @@ pm_encoding_find(const uint8_t *start, const uint8_t *end) {
     // If we didn't match any encodings, return NULL.
     return NULL;
 }
+
+/**
+ * The scanners below find the first byte that is not ASCII. They read the
+ * string in blocks and only look at individual bytes once a block contains a
+ * byte with its high bit set.
+ */
+
+#if defined(PRISM_HAS_NEON)
+#include <arm_neon.h>
+
+static PRISM_INLINE size_t
+scan_ascii(const uint8_t *source, size_t length) {
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        if (vmaxvq_u8(vld1q_u8(source + index)) >= 0x80) break;
+    }
+
+    while (index < length && source[index] < 0x80) index++;
+    return index;
+}
+
+#elif defined(PRISM_HAS_SSE2)
+#include <emmintrin.h>
+
+static PRISM_INLINE size_t
+scan_ascii(const uint8_t *source, size_t length) {
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (source + index));
+        unsigned mask = (unsigned) _mm_movemask_epi8(v);
+        if (mask != 0) return index + pm_ctzll(mask);
+    }
+
+    while (index < length && source[index] < 0x80) index++;
+    return index;
+}
+
+#else
+
+static PRISM_INLINE size_t
+scan_ascii(const uint8_t *source, size_t length) {
+    static const uint64_t highs = 0x8080808080808080ULL;
+    size_t index = 0;
+
+    // Testing the high bits of a whole word does not depend on the byte order,
+    // so this does not need PRISM_HAS_SWAR.
+    for (; index + 8 <= length; index += 8) {
+        uint64_t word;
+        memcpy(&word, source + index, 8);
+        if (word & highs) break;
+    }
+
+    while (index < length && source[index] < 0x80) index++;
+    return index;
+}
+
+#endif
+
+/**
+ * Returns the number of bytes at the start of the given string before the first
+ * byte that is not ASCII, which is the length of the string if it is entirely
+ * ASCII.
+ */
+size_t
+pm_ascii_prefix_length(const uint8_t *source, size_t length) {
+    return length == 0 ? 0 : scan_ascii(source, length);
+}
+
+/**
+ * Returns true if the given byte is within either of the given ranges.
+ */
+static PRISM_INLINE bool
+pm_encoding_double_byte_range_p(const uint8_t ranges[2][2], uint8_t byte) {
+    return (byte >= ranges[0][0] && byte <= ranges[0][1]) || (byte >= ranges[1][0] && byte <= ranges[1][1]);
+}
+
+/**
+ * The scanners below find the length of the run of two-byte characters at the
+ * start of a string 16 bytes at a time, by classifying every byte of a block as
+ * a lead byte or a trailing byte at once. A block is eight two-byte characters
+ * if every byte at an even offset is a lead byte and every byte at an odd
+ * offset is a trailing byte. They stop at the first block that is not, leaving
+ * the rest to be checked one character at a time.
+ */
+
+#if defined(PRISM_HAS_NEON)
+
+/**
+ * Returns a mask of the bytes of the given block that are within the given
+ * inclusive range. Subtracting the minimum wraps the bytes below the range
+ * around to the top, so a single comparison checks both ends.
+ */
+static PRISM_INLINE uint8x16_t
+scan_double_byte_range(uint8x16_t block, const uint8_t range[2]) {
+    return vcleq_u8(vsubq_u8(block, vdupq_n_u8(range[0])), vdupq_n_u8((uint8_t) (range[1] - range[0])));
+}
+
+static PRISM_INLINE size_t
+scan_double_byte(const pm_encoding_double_byte_t *ranges, const uint8_t *source, size_t length) {
+    static const uint8_t lead_offsets[16] = { 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0 };
+    uint8x16_t leads = vld1q_u8(lead_offsets);
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        uint8x16_t block = vld1q_u8(source + index);
+        uint8x16_t lead = vorrq_u8(scan_double_byte_range(block, ranges->lead[0]), scan_double_byte_range(block, ranges->lead[1]));
+        uint8x16_t trail = vorrq_u8(scan_double_byte_range(block, ranges->trail[0]), scan_double_byte_range(block, ranges->trail[1]));
+
+        if (vminvq_u8(vbslq_u8(leads, lead, trail)) != 0xFF) break;
+    }
+
+    return index;
+}
+
+#elif defined(PRISM_HAS_SSE2)
+
+/**
+ * Returns a mask of the bytes of the given block that are within the given
+ * inclusive range. Subtracting the minimum wraps the bytes below the range
+ * around to the top, so a single saturating subtraction checks both ends.
+ */
+static PRISM_INLINE __m128i
+scan_double_byte_range(__m128i block, const uint8_t range[2]) {
+    __m128i offset = _mm_sub_epi8(block, _mm_set1_epi8((char) range[0]));
+    __m128i excess = _mm_subs_epu8(offset, _mm_set1_epi8((char) (range[1] - range[0])));
+    return _mm_cmpeq_epi8(excess, _mm_setzero_si128());
+}
+
+static PRISM_INLINE size_t
+scan_double_byte(const pm_encoding_double_byte_t *ranges, const uint8_t *source, size_t length) {
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (source + index));
+        unsigned lead = (unsigned) _mm_movemask_epi8(_mm_or_si128(scan_double_byte_range(block, ranges->lead[0]), scan_double_byte_range(block, ranges->lead[1])));
+        unsigned trail = (unsigned) _mm_movemask_epi8(_mm_or_si128(scan_double_byte_range(block, ranges->trail[0]), scan_double_byte_range(block, ranges->trail[1])));
+
+        if ((lead & 0x5555) != 0x5555 || (trail & 0xAAAA) != 0xAAAA) break;
+    }
+
+    return index;
+}
+
+#else
+
+static PRISM_INLINE size_t
+scan_double_byte(PRISM_UNUSED const pm_encoding_double_byte_t *ranges, PRISM_UNUSED const uint8_t *source, PRISM_UNUSED size_t length) {
+    return 0;
+}
+
+#endif
+
+/**
+ * Returns the number of bytes at the start of the given string that are a run
+ * of two-byte characters matching the double_byte ranges of the given encoding.
+ */
+size_t
+pm_encoding_double_byte_length(const pm_encoding_t *encoding, const uint8_t *source, size_t length) {
+    const pm_encoding_double_byte_t *ranges = encoding->double_byte;
+    if (ranges == NULL) return 0;
+
+    size_t index = scan_double_byte(ranges, source, length);
+
+    while (index + 2 <= length && pm_encoding_double_byte_range_p(ranges->lead, source[index]) && pm_encoding_double_byte_range_p(ranges->trail, source[index + 1])) {
+        index += 2;
+    }
+
+    return index;
+}
+
+/**
+ * The scanners below find the length of the run of identifier characters at the
+ * start of a UTF-8 string 16 bytes at a time. Every byte of a block is checked
+ * against the three bytes before it, which is enough to tell whether it is the
+ * continuation byte its lead byte needs and whether the character is overlong,
+ * a surrogate, or above U+10FFFF. They return the offset of the first byte that
+ * is not an identifier byte or breaks one of those rules, which can be in the
+ * middle of a character, or the offset of the first incomplete block.
+ */
+
+#if defined(PRISM_HAS_NEON)
+
+static PRISM_INLINE size_t
+scan_utf_8_identifier(const uint8_t *source, size_t length) {
+    uint8x16_t previous = vdupq_n_u8(0);
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        uint8x16_t block = vld1q_u8(source + index);
+        uint8x16_t prev1 = vextq_u8(previous, block, 15);
+        uint8x16_t prev2 = vextq_u8(previous, block, 14);
+        uint8x16_t prev3 = vextq_u8(previous, block, 13);
+
+        // A byte must be a continuation byte exactly when one of the three
+        // bytes before it is a lead byte that needs that many.
+        uint8x16_t continuation = vceqq_u8(vandq_u8(block, vdupq_n_u8(0xC0)), vdupq_n_u8(0x80));
+        uint8x16_t required = vorrq_u8(vorrq_u8(vcgeq_u8(prev1, vdupq_n_u8(0xC0)), vcgeq_u8(prev2, vdupq_n_u8(0xE0))), vcgeq_u8(prev3, vdupq_n_u8(0xF0)));
+        uint8x16_t invalid = veorq_u8(continuation, required);
+
+        // C0, C1, and F5 through FF never appear, and the second byte after
+        // E0, ED, F0, and F4 is further restricted.
+        invalid = vorrq_u8(invalid, vceqq_u8(vandq_u8(block, vdupq_n_u8(0xFE)), vdupq_n_u8(0xC0)));
+        invalid = vorrq_u8(invalid, vcgeq_u8(block, vdupq_n_u8(0xF5)));
+        invalid = vorrq_u8(invalid, vandq_u8(vceqq_u8(prev1, vdupq_n_u8(0xE0)), vcltq_u8(block, vdupq_n_u8(0xA0))));
+        invalid = vorrq_u8(invalid, vandq_u8(vceqq_u8(prev1, vdupq_n_u8(0xED)), vcgeq_u8(block, vdupq_n_u8(0xA0))));
+        invalid = vorrq_u8(invalid, vandq_u8(vceqq_u8(prev1, vdupq_n_u8(0xF0)), vcltq_u8(block, vdupq_n_u8(0x90))));
+        invalid = vorrq_u8(invalid, vandq_u8(vceqq_u8(prev1, vdupq_n_u8(0xF4)), vcgeq_u8(block, vdupq_n_u8(0x90))));
+
+        // Everything else must be a letter, digit, underscore, or non-ASCII.
+        uint8x16_t letter = vcleq_u8(vsubq_u8(vorrq_u8(block, vdupq_n_u8(0x20)), vdupq_n_u8('a')), vdupq_n_u8('z' - 'a'));
+        uint8x16_t digit = vcleq_u8(vsubq_u8(block, vdupq_n_u8('0')), vdupq_n_u8('9' - '0'));
+        uint8x16_t identifier = vorrq_u8(vorrq_u8(letter, digit), vorrq_u8(vceqq_u8(block, vdupq_n_u8('_')), vcgeq_u8(block, vdupq_n_u8(0x80))));
+        invalid = vorrq_u8(invalid, vmvnq_u8(identifier));
+
+        if (vmaxvq_u8(invalid) != 0) {
+            // Narrow each byte of the mask to four bits to find the first one.
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(invalid), 4)), 0);
+            return index + pm_ctzll(mask) / 4;
+        }
+
+        previous = block;
+    }
+
+    return index;
+}
+
+#elif defined(PRISM_HAS_SSE2)
+
+/**
+ * Returns a mask of the bytes of the given block that are greater than or equal
+ * to the given byte, compared as unsigned.
+ */
+static PRISM_INLINE __m128i
+scan_utf_8_at_least(__m128i block, uint8_t byte) {
+    return _mm_cmpeq_epi8(_mm_max_epu8(block, _mm_set1_epi8((char) byte)), block);
+}
+
+static PRISM_INLINE size_t
+scan_utf_8_identifier(const uint8_t *source, size_t length) {
+    __m128i previous = _mm_setzero_si128();
+    size_t index = 0;
+
+    for (; index + 16 <= length; index += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (source + index));
+        __m128i prev1 = _mm_or_si128(_mm_slli_si128(block, 1), _mm_srli_si128(previous, 15));
+        __m128i prev2 = _mm_or_si128(_mm_slli_si128(block, 2), _mm_srli_si128(previous, 14));
+        __m128i prev3 = _mm_or_si128(_mm_slli_si128(block, 3), _mm_srli_si128(previous, 13));
+
+        // A byte must be a continuation byte exactly when one of the three
+        // bytes before it is a lead byte that needs that many.
+        __m128i continuation = _mm_cmpeq_epi8(_mm_and_si128(block, _mm_set1_epi8((char) 0xC0)), _mm_set1_epi8((char) 0x80));
+        __m128i required = _mm_or_si128(_mm_or_si128(scan_utf_8_at_least(prev1, 0xC0), scan_utf_8_at_least(prev2, 0xE0)), scan_utf_8_at_least(prev3, 0xF0));
+        __m128i invalid = _mm_xor_si128(continuation, required);
+
+        // C0, C1, and F5 through FF never appear, and the second byte after
+        // E0, ED, F0, and F4 is further restricted.
+        __m128i below_a0 = _mm_andnot_si128(scan_utf_8_at_least(block, 0xA0), _mm_set1_epi8((char) 0xFF));
+        __m128i below_90 = _mm_andnot_si128(scan_utf_8_at_least(block, 0x90), _mm_set1_epi8((char) 0xFF));
+
+        invalid = _mm_or_si128(invalid, _mm_cmpeq_epi8(_mm_and_si128(block, _mm_set1_epi8((char) 0xFE)), _mm_set1_epi8((char) 0xC0)));
+        invalid = _mm_or_si128(invalid, scan_utf_8_at_least(block, 0xF5));
+        invalid = _mm_or_si128(invalid, _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xE0)), below_a0));
+        invalid = _mm_or_si128(invalid, _mm_andnot_si128(below_a0, _mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xED))));
+        invalid = _mm_or_si128(invalid, _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xF0)), below_90));
+        invalid = _mm_or_si128(invalid, _mm_andnot_si128(below_90, _mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xF4))));
+
+        // Everything else must be a letter, digit, underscore, or non-ASCII.
+        // The range checks subtract the minimum so that a single saturating
+        // subtraction checks both ends.
+        __m128i zero = _mm_setzero_si128();
+        __m128i letter = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(_mm_or_si128(block, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')), _mm_set1_epi8('z' - 'a')), zero);
+        __m128i digit = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(block, _mm_set1_epi8('0')), _mm_set1_epi8('9' - '0')), zero);
+        __m128i identifier = _mm_or_si128(_mm_or_si128(letter, digit), _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('_')), scan_utf_8_at_least(block, 0x80)));
+
+        unsigned mask = ((unsigned) _mm_movemask_epi8(invalid) | ~((unsigned) _mm_movemask_epi8(identifier))) & 0xFFFF;
+        if (mask != 0) return index + pm_ctzll(mask);
+
+        previous = block;
+    }
+
+    return index;
+}
+
+#else
+
+static PRISM_INLINE size_t
+scan_utf_8_identifier(PRISM_UNUSED const uint8_t *source, PRISM_UNUSED size_t length) {
+    return 0;
+}
+
+#endif
+
+/**
+ * Returns the number of bytes at the start of the given UTF-8 string that are
+ * identifier characters: ASCII letters, digits, and underscores, and any valid
+ * multibyte character.
+ */
+size_t
+pm_encoding_utf_8_identifier_length(const uint8_t *source, size_t length) {
+    size_t index = scan_utf_8_identifier(source, length);
+
+    // The scan can stop partway through a character, either because the
+    // character is invalid or because it crosses into the next block, so back
+    // up to the start of it and check it on its own.
+    for (size_t offset = 1; offset <= 3 && offset <= index; offset++) {
+        uint8_t byte = source[index - offset];
+        if (byte < 0x80) break;
+
+        if (byte >= 0xC0) {
+            if ((byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2) > offset) index -= offset;
+            break;
+        }
+    }
+
+    while (index < length) {
+        if (source[index] < 0x80) {
+            if (source[index] != '_' && !(pm_encoding_unicode_table[source[index]] & (PRISM_ENCODING_ALPHANUMERIC_BIT))) break;
+            index++;
+        } else {
+            size_t width = pm_encoding_utf_8_char_width(source + index, (ptrdiff_t) (length - index));
+            if (width == 0) break;
+            index += width;
+        }
+    }
+
+    return index;
+}
+
+/**
+ * Returns true if the given string is entirely made up of valid UTF-8
+ * characters. This rejects the same sequences as Ruby does: overlong forms,
+ * surrogates, and codepoints above U+10FFFF.
+ */
+bool
+pm_encoding_utf_8_valid_p(const uint8_t *source, size_t length) {
+    size_t index = pm_ascii_prefix_length(source, length);
+
+    while (index < length) {
+        size_t width = pm_encoding_utf_8_char_width(source + index, (ptrdiff_t) (length - index));
+        if (width == 0) return false;
+
+        index += width;
+        index += pm_ascii_prefix_length(source + index, length - index);
+    }
+
+    return true;
+}
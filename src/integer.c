@@ -1,6 +1,8 @@
 #include "prism/internal/integer.h"
 
-#include "prism/internal/allocator.h"
+#include "prism/compiler/align.h"
+#include "prism/compiler/force_inline.h"
+#include "prism/internal/arena.h"
 #include "prism/internal/buffer.h"
 
 #include <assert.h>
@@ -11,14 +13,48 @@
 #include <string.h>
 
 /**
- * Free the internal memory of an integer. This memory will only be allocated if
- * the integer exceeds the size of a single uint32_t.
+ * The base of the values of a pm_integer_t.
  */
-static void
-pm_integer_free(pm_integer_t *integer) {
-    if (integer->values) {
-        xfree(integer->values);
-    }
+#define PM_INTEGER_BINARY_BASE ((uint64_t) 1 << 32)
+
+/**
+ * The base used while converting to and from decimal, which is the largest
+ * power of ten that fits into a uint32_t.
+ */
+#define PM_INTEGER_DECIMAL_BASE ((uint64_t) 1000000000)
+
+/**
+ * Divide a value by the given base, which must be one of the two bases above.
+ * Because both of them are constants, this compiles to a shift or to a
+ * multiplication instead of a 64-bit division.
+ */
+static PRISM_FORCE_INLINE uint64_t
+big_divide(uint64_t value, uint64_t base) {
+    return base == PM_INTEGER_BINARY_BASE ? (value >> 32) : (value / PM_INTEGER_DECIMAL_BASE);
+}
+
+/**
+ * Take a value modulo the given base, which must be one of the two bases above.
+ */
+static PRISM_FORCE_INLINE uint32_t
+big_modulo(uint64_t value, uint64_t base) {
+    return (uint32_t) (base == PM_INTEGER_BINARY_BASE ? (value & UINT32_MAX) : (value % PM_INTEGER_DECIMAL_BASE));
+}
+
+/**
+ * Allocate the values of an integer of the given length from the arena.
+ */
+static PRISM_FORCE_INLINE uint32_t *
+big_alloc(pm_arena_t *arena, size_t length) {
+    return (uint32_t *) pm_arena_alloc(arena, sizeof(uint32_t) * length, PRISM_ALIGNOF(uint32_t));
+}
+
+/**
+ * Allocate the zeroed values of an integer of the given length from the arena.
+ */
+static PRISM_FORCE_INLINE uint32_t *
+big_zalloc(pm_arena_t *arena, size_t length) {
+    return (uint32_t *) pm_arena_zalloc(arena, sizeof(uint32_t) * length, PRISM_ALIGNOF(uint32_t));
 }
 
 /**
@@ -36,10 +72,10 @@ pm_integer_free(pm_integer_t *integer) {
 
 /**
  * Adds two positive pm_integer_t with the given base.
- * Return pm_integer_t with values allocated. Not normalized.
+ * Return pm_integer_t with values allocated from the arena. Not normalized.
  */
 static void
-big_add(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint64_t base) {
+big_add(pm_arena_t *arena, pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint64_t base) {
     size_t left_length;
     uint32_t *left_values;
     INTEGER_EXTRACT(left, left_length, left_values)
@@ -49,14 +85,13 @@ big_add(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint
     INTEGER_EXTRACT(right, right_length, right_values)
 
     size_t length = left_length < right_length ? right_length : left_length;
-    uint32_t *values = (uint32_t *) xmalloc(sizeof(uint32_t) * (length + 1));
-    if (values == NULL) return;
+    uint32_t *values = big_alloc(arena, length + 1);
 
     uint64_t carry = 0;
     for (size_t index = 0; index < length; index++) {
         uint64_t sum = carry + (index < left_length ? left_values[index] : 0) + (index < right_length ? right_values[index] : 0);
-        values[index] = (uint32_t) (sum % base);
-        carry = sum / base;
+        values[index] = big_modulo(sum, base);
+        carry = big_divide(sum, base);
     }
 
     if (carry > 0) {
@@ -70,10 +105,10 @@ big_add(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint
 /**
  * Internal use for karatsuba_multiply. Calculates `a - b - c` with the given
  * base. Assume a, b, c, a - b - c all to be positive.
- * Return pm_integer_t with values allocated. Not normalized.
+ * Return pm_integer_t with values allocated from the arena. Not normalized.
  */
 static void
-big_sub2(pm_integer_t *destination, pm_integer_t *a, pm_integer_t *b, pm_integer_t *c, uint64_t base) {
+big_sub2(pm_arena_t *arena, pm_integer_t *destination, pm_integer_t *a, pm_integer_t *b, pm_integer_t *c, uint64_t base) {
     size_t a_length;
     uint32_t *a_values;
     INTEGER_EXTRACT(a, a_length, a_values)
@@ -86,7 +121,7 @@ big_sub2(pm_integer_t *destination, pm_integer_t *a, pm_integer_t *b, pm_integer
     uint32_t *c_values;
     INTEGER_EXTRACT(c, c_length, c_values)
 
-    uint32_t *values = (uint32_t*) xmalloc(sizeof(uint32_t) * a_length);
+    uint32_t *values = big_alloc(arena, a_length);
     int64_t carry = 0;
 
     for (size_t index = 0; index < a_length; index++) {
@@ -102,8 +137,8 @@ big_sub2(pm_integer_t *destination, pm_integer_t *a, pm_integer_t *b, pm_integer
             carry = 0;
         } else {
             sub += 2 * (int64_t) base;
-            values[index] = (uint32_t) ((uint64_t) sub % base);
-            carry = sub / (int64_t) base - 2;
+            values[index] = big_modulo((uint64_t) sub, base);
+            carry = (int64_t) big_divide((uint64_t) sub, base) - 2;
         }
     }
 
@@ -113,10 +148,12 @@ big_sub2(pm_integer_t *destination, pm_integer_t *a, pm_integer_t *b, pm_integer
 
 /**
  * Multiply two positive integers with the given base using karatsuba algorithm.
- * Return pm_integer_t with values allocated. Not normalized.
+ * Return pm_integer_t with values allocated from the arena. Not normalized.
+ * Intermediate products are released back to the arena before returning, so
+ * only the result remains allocated.
  */
 static void
-karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint64_t base) {
+karatsuba_multiply(pm_arena_t *arena, pm_integer_t *destination, pm_integer_t *left, pm_integer_t *right, uint64_t base) {
     size_t left_length;
     uint32_t *left_values;
     INTEGER_EXTRACT(left, left_length, left_values)
@@ -135,17 +172,16 @@ karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *
         right_values = temporary_values;
     }
 
-    if (left_length <= 10) {
+    if (left_length <= 32) {
         size_t length = left_length + right_length;
-        uint32_t *values = (uint32_t *) xcalloc(length, sizeof(uint32_t));
-        if (values == NULL) return;
+        uint32_t *values = big_zalloc(arena, length);
 
         for (size_t left_index = 0; left_index < left_length; left_index++) {
             uint32_t carry = 0;
             for (size_t right_index = 0; right_index < right_length; right_index++) {
                 uint64_t product = (uint64_t) left_values[left_index] * right_values[right_index] + values[left_index + right_index] + carry;
-                values[left_index + right_index] = (uint32_t) (product % base);
-                carry = (uint32_t) (product / base);
+                values[left_index + right_index] = big_modulo(product, base);
+                carry = (uint32_t) big_divide(product, base);
             }
             values[left_index + right_length] = carry;
         }
@@ -156,7 +192,7 @@ karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *
     }
 
     if (left_length * 2 <= right_length) {
-        uint32_t *values = (uint32_t *) xcalloc(left_length + right_length, sizeof(uint32_t));
+        uint32_t *values = big_zalloc(arena, left_length + right_length);
 
         for (size_t start_offset = 0; start_offset < right_length; start_offset += left_length) {
             size_t end_offset = start_offset + left_length;
@@ -176,24 +212,29 @@ karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *
                 .negative = false
             };
 
+            pm_arena_mark_t mark = pm_arena_mark(arena);
             pm_integer_t product;
-            karatsuba_multiply(&product, &sliced_left, &sliced_right, base);
+            karatsuba_multiply(arena, &product, &sliced_left, &sliced_right, base);
 
             uint32_t carry = 0;
             for (size_t index = 0; index < product.length; index++) {
                 uint64_t sum = (uint64_t) values[start_offset + index] + product.values[index] + carry;
-                values[start_offset + index] = (uint32_t) (sum % base);
-                carry = (uint32_t) (sum / base);
+                values[start_offset + index] = big_modulo(sum, base);
+                carry = (uint32_t) big_divide(sum, base);
             }
 
             if (carry > 0) values[start_offset + product.length] += carry;
-            pm_integer_free(&product);
+            pm_arena_rewind(arena, mark);
         }
 
         *destination = (pm_integer_t) { left_length + right_length, values, 0, false };
         return;
     }
 
+    size_t length = left_length + right_length;
+    uint32_t *values = big_zalloc(arena, length);
+    pm_arena_mark_t mark = pm_arena_mark(arena);
+
     size_t half = left_length / 2;
     pm_integer_t x0 = { half, left_values, 0, false };
     pm_integer_t x1 = { left_length - half, left_values + half, 0, false };
@@ -201,27 +242,24 @@ karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *
     pm_integer_t y1 = { right_length - half, right_values + half, 0, false };
 
     pm_integer_t z0 = { 0 };
-    karatsuba_multiply(&z0, &x0, &y0, base);
+    karatsuba_multiply(arena, &z0, &x0, &y0, base);
 
     pm_integer_t z2 = { 0 };
-    karatsuba_multiply(&z2, &x1, &y1, base);
+    karatsuba_multiply(arena, &z2, &x1, &y1, base);
 
     // For simplicity to avoid considering negative values,
     // use `z1 = (x0 + x1) * (y0 + y1) - z0 - z2` instead of original karatsuba algorithm.
     pm_integer_t x01 = { 0 };
-    big_add(&x01, &x0, &x1, base);
+    big_add(arena, &x01, &x0, &x1, base);
 
     pm_integer_t y01 = { 0 };
-    big_add(&y01, &y0, &y1, base);
+    big_add(arena, &y01, &y0, &y1, base);
 
     pm_integer_t xy = { 0 };
-    karatsuba_multiply(&xy, &x01, &y01, base);
+    karatsuba_multiply(arena, &xy, &x01, &y01, base);
 
     pm_integer_t z1;
-    big_sub2(&z1, &xy, &z0, &z2, base);
-
-    size_t length = left_length + right_length;
-    uint32_t *values = (uint32_t*) xcalloc(length, sizeof(uint32_t));
+    big_sub2(arena, &z1, &xy, &z0, &z2, base);
 
     assert(z0.values != NULL);
     memcpy(values, z0.values, sizeof(uint32_t) * z0.length);
@@ -232,23 +270,18 @@ karatsuba_multiply(pm_integer_t *destination, pm_integer_t *left, pm_integer_t *
     uint32_t carry = 0;
     for(size_t index = 0; index < z1.length; index++) {
         uint64_t sum = (uint64_t) carry + values[index + half] + z1.values[index];
-        values[index + half] = (uint32_t) (sum % base);
-        carry = (uint32_t) (sum / base);
+        values[index + half] = big_modulo(sum, base);
+        carry = (uint32_t) big_divide(sum, base);
     }
 
     for(size_t index = half + z1.length; carry > 0; index++) {
         uint64_t sum = (uint64_t) carry + values[index];
-        values[index] = (uint32_t) (sum % base);
-        carry = (uint32_t) (sum / base);
+        values[index] = big_modulo(sum, base);
+        carry = (uint32_t) big_divide(sum, base);
     }
 
     while (length > 1 && values[length - 1] == 0) length--;
-    pm_integer_free(&z0);
-    pm_integer_free(&z1);
-    pm_integer_free(&z2);
-    pm_integer_free(&x01);
-    pm_integer_free(&y01);
-    pm_integer_free(&xy);
+    pm_arena_rewind(arena, mark);
 
     *destination = (pm_integer_t) { length, values, 0, false };
 }
@@ -296,7 +329,7 @@ pm_integer_parse_digit(const uint8_t character) {
  * the memory for the pm_integer_t pointer has been zeroed.
  */
 static void
-pm_integer_from_uint64(pm_integer_t *integer, uint64_t value, uint64_t base) {
+pm_integer_from_uint64(pm_arena_t *arena, pm_integer_t *integer, uint64_t value, uint64_t base) {
     if (value < base) {
         integer->value = (uint32_t) value;
         return;
@@ -306,15 +339,13 @@ pm_integer_from_uint64(pm_integer_t *integer, uint64_t value, uint64_t base) {
     uint64_t length_value = value;
     while (length_value > 0) {
         length++;
-        length_value /= base;
+        length_value = big_divide(length_value, base);
     }
 
-    uint32_t *values = (uint32_t *) xmalloc(sizeof(uint32_t) * length);
-    if (values == NULL) return;
-
+    uint32_t *values = big_alloc(arena, length);
     for (size_t value_index = 0; value_index < length; value_index++) {
-        values[value_index] = (uint32_t) (value % base);
-        value /= base;
+        values[value_index] = big_modulo(value, base);
+        value = big_divide(value, base);
     }
 
     integer->length = length;
@@ -342,17 +373,22 @@ pm_integer_normalize(pm_integer_t *integer) {
 
     uint32_t value = integer->values[0];
     bool negative = integer->negative && value != 0;
-
-    pm_integer_free(integer);
     *integer = (pm_integer_t) { .values = NULL, .value = value, .length = 0, .negative = negative };
 }
 
 /**
  * Convert base of the integer.
  * In practice, it converts 10**9 to 1<<32 or 1<<32 to 10**9.
+ *
+ * Adjacent pairs of values are combined level by level, multiplying the upper
+ * one of each pair by base_from raised to the size of the lower one, so that
+ * with karatsuba multiplication the conversion is subquadratic.
  */
 static void
-pm_integer_convert_base(pm_integer_t *destination, const pm_integer_t *source, uint64_t base_from, uint64_t base_to) {
+pm_integer_convert_base(pm_arena_t *arena, pm_integer_t *destination, const pm_integer_t *source, uint64_t base_from, uint64_t base_to) {
+    assert(base_from == PM_INTEGER_BINARY_BASE || base_from == PM_INTEGER_DECIMAL_BASE);
+    assert(base_to == PM_INTEGER_BINARY_BASE || base_to == PM_INTEGER_DECIMAL_BASE);
+
     size_t source_length;
     const uint32_t *source_values;
     INTEGER_EXTRACT(source, source_length, source_values)
@@ -360,42 +396,34 @@ pm_integer_convert_base(pm_integer_t *destination, const pm_integer_t *source, u
     size_t bigints_length = (source_length + 1) / 2;
     assert(bigints_length > 0);
 
-    pm_integer_t *bigints = (pm_integer_t *) xcalloc(bigints_length, sizeof(pm_integer_t));
-    if (bigints == NULL) return;
+    pm_integer_t *bigints = (pm_integer_t *) pm_arena_zalloc(arena, bigints_length * sizeof(pm_integer_t), PRISM_ALIGNOF(pm_integer_t));
 
     for (size_t index = 0; index < source_length; index += 2) {
         uint64_t value = source_values[index] + base_from * (index + 1 < source_length ? source_values[index + 1] : 0);
-        pm_integer_from_uint64(&bigints[index / 2], value, base_to);
+        pm_integer_from_uint64(arena, &bigints[index / 2], value, base_to);
     }
 
     pm_integer_t base = { 0 };
-    pm_integer_from_uint64(&base, base_from, base_to);
+    pm_integer_from_uint64(arena, &base, base_from, base_to);
 
     while (bigints_length > 1) {
         pm_integer_t next_base;
-        karatsuba_multiply(&next_base, &base, &base, base_to);
-
-        pm_integer_free(&base);
+        karatsuba_multiply(arena, &next_base, &base, &base, base_to);
         base = next_base;
 
         size_t next_length = (bigints_length + 1) / 2;
-        pm_integer_t *next_bigints = (pm_integer_t *) xcalloc(next_length, sizeof(pm_integer_t));
+        pm_integer_t *next_bigints = (pm_integer_t *) pm_arena_zalloc(arena, next_length * sizeof(pm_integer_t), PRISM_ALIGNOF(pm_integer_t));
 
         for (size_t bigints_index = 0; bigints_index < bigints_length; bigints_index += 2) {
             if (bigints_index + 1 == bigints_length) {
                 next_bigints[bigints_index / 2] = bigints[bigints_index];
             } else {
                 pm_integer_t multiplied = { 0 };
-                karatsuba_multiply(&multiplied, &base, &bigints[bigints_index + 1], base_to);
-
-                big_add(&next_bigints[bigints_index / 2], &bigints[bigints_index], &multiplied, base_to);
-                pm_integer_free(&bigints[bigints_index]);
-                pm_integer_free(&bigints[bigints_index + 1]);
-                pm_integer_free(&multiplied);
+                karatsuba_multiply(arena, &multiplied, &base, &bigints[bigints_index + 1], base_to);
+                big_add(arena, &next_bigints[bigints_index / 2], &bigints[bigints_index], &multiplied, base_to);
             }
         }
 
-        xfree_sized(bigints, bigints_length * sizeof(pm_integer_t));
         bigints = next_bigints;
         bigints_length = next_length;
     }
@@ -403,9 +431,6 @@ pm_integer_convert_base(pm_integer_t *destination, const pm_integer_t *source, u
     *destination = bigints[0];
     destination->negative = source->negative;
     pm_integer_normalize(destination);
-
-    xfree_sized(bigints, bigints_length * sizeof(pm_integer_t));
-    pm_integer_free(&base);
 }
 
 #undef INTEGER_EXTRACT
@@ -414,12 +439,12 @@ pm_integer_convert_base(pm_integer_t *destination, const pm_integer_t *source, u
  * Convert digits to integer with the given power-of-two base.
  */
 static void
-pm_integer_parse_powof2(pm_integer_t *integer, uint32_t base, const uint8_t *digits, size_t digits_length) {
+pm_integer_parse_powof2(pm_arena_t *arena, pm_integer_t *integer, uint32_t base, const uint8_t *digits, size_t digits_length) {
     size_t bit = 1;
     while (base > (uint32_t) (1 << bit)) bit++;
 
     size_t length = (digits_length * bit + 31) / 32;
-    uint32_t *values = (uint32_t *) xcalloc(length, sizeof(uint32_t));
+    uint32_t *values = big_zalloc(arena, length);
 
     for (size_t digit_index = 0; digit_index < digits_length; digit_index++) {
         size_t bit_position = bit * (digits_length - digit_index - 1);
@@ -441,11 +466,11 @@ pm_integer_parse_powof2(pm_integer_t *integer, uint32_t base, const uint8_t *dig
  * Convert decimal digits to pm_integer_t.
  */
 static void
-pm_integer_parse_decimal(pm_integer_t *integer, const uint8_t *digits, size_t digits_length) {
+pm_integer_parse_decimal(pm_arena_t *arena, pm_integer_t *integer, const uint8_t *digits, size_t digits_length) {
     const size_t batch = 9;
     const size_t length = (digits_length + batch - 1) / batch;
 
-    uint32_t *values = (uint32_t *) xcalloc(length, sizeof(uint32_t));
+    uint32_t *values = big_zalloc(arena, length);
     uint32_t value = 0;
 
     for (size_t digits_index = 0; digits_index < digits_length; digits_index++) {
@@ -459,18 +484,21 @@ pm_integer_parse_decimal(pm_integer_t *integer, const uint8_t *digits, size_t di
     }
 
     // Convert base from 10**9 to 1<<32.
-    pm_integer_convert_base(integer, &((pm_integer_t) { .length = length, .values = values,  .value = 0, .negative = false }), 1000000000, ((uint64_t) 1 << 32));
-    xfree_sized(values, length * sizeof(uint32_t));
+    pm_integer_convert_base(arena, integer, &((pm_integer_t) { .length = length, .values = values,  .value = 0, .negative = false }), PM_INTEGER_DECIMAL_BASE, PM_INTEGER_BINARY_BASE);
 }
 
 /**
- * Parse a large integer from a string that does not fit into uint32_t.
+ * Parse a large integer from a string that does not fit into uint32_t. Only
+ * the values of the result are allocated from the given arena. The digits and
+ * every intermediate result of the conversion are allocated from a scratch
+ * arena that is released all at once at the end.
  */
 static void
-pm_integer_parse_big(pm_integer_t *integer, uint32_t multiplier, const uint8_t *start, const uint8_t *end) {
+pm_integer_parse_big(pm_arena_t *arena, pm_integer_t *integer, uint32_t multiplier, const uint8_t *start, const uint8_t *end) {
+    pm_arena_t scratch = { 0 };
+
     // Allocate an array to store digits.
-    const size_t digits_capa = sizeof(uint8_t) * (size_t) (end - start);
-    uint8_t *digits = xmalloc(digits_capa);
+    uint8_t *digits = (uint8_t *) pm_arena_alloc(&scratch, (size_t) (end - start), 1);
     size_t digits_length = 0;
 
     for (; start < end; start++) {
@@ -479,13 +507,19 @@ pm_integer_parse_big(pm_integer_t *integer, uint32_t multiplier, const uint8_t *
     }
 
     // Construct pm_integer_t from the digits.
+    pm_integer_t result = { 0 };
     if (multiplier == 10) {
-        pm_integer_parse_decimal(integer, digits, digits_length);
+        pm_integer_parse_decimal(&scratch, &result, digits, digits_length);
     } else {
-        pm_integer_parse_powof2(integer, multiplier, digits, digits_length);
+        pm_integer_parse_powof2(&scratch, &result, multiplier, digits, digits_length);
+    }
+
+    *integer = result;
+    if (result.values != NULL) {
+        integer->values = (uint32_t *) pm_arena_memdup(arena, result.values, sizeof(uint32_t) * result.length, PRISM_ALIGNOF(uint32_t));
     }
 
-    xfree_sized(digits, digits_capa);
+    pm_arena_cleanup(&scratch);
 }
 
 /**
@@ -494,7 +528,7 @@ pm_integer_parse_big(pm_integer_t *integer, uint32_t multiplier, const uint8_t *
  * here.
  */
 void
-pm_integer_parse(pm_integer_t *integer, pm_integer_base_t base, const uint8_t *start, const uint8_t *end) {
+pm_integer_parse(pm_arena_t *arena, pm_integer_t *integer, pm_integer_base_t base, const uint8_t *start, const uint8_t *end) {
     // Ignore unary +. Unary - is parsed differently and will not end up here.
     // Instead, it will modify the parsed integer later.
     if (*start == '+') start++;
@@ -550,7 +584,7 @@ pm_integer_parse(pm_integer_t *integer, pm_integer_base_t base, const uint8_t *s
         if (value > UINT32_MAX) {
             // If the integer is too large to fit into a single uint32_t, then
             // we'll parse it as a big integer.
-            pm_integer_parse_big(integer, multiplier, start, end);
+            pm_integer_parse_big(arena, integer, multiplier, start, end);
             return;
         }
     }
@@ -646,20 +680,21 @@ pm_integer_string(pm_buffer_t *buffer, const pm_integer_t *integer) {
         return;
     }
 
-    // Otherwise, first we'll convert the base from 1<<32 to 10**9.
+    // Otherwise, first we'll convert the base from 1<<32 to 10**9. Everything
+    // allocated along the way lives in a scratch arena freed at the end.
+    pm_arena_t scratch = { 0 };
     pm_integer_t converted = { 0 };
-    pm_integer_convert_base(&converted, integer, (uint64_t) 1 << 32, 1000000000);
+    pm_integer_convert_base(&scratch, &converted, integer, PM_INTEGER_BINARY_BASE, PM_INTEGER_DECIMAL_BASE);
 
     if (converted.values == NULL) {
         pm_buffer_append_format(buffer, "%" PRIu32, converted.value);
-        pm_integer_free(&converted);
+        pm_arena_cleanup(&scratch);
         return;
     }
 
     // Allocate a buffer that we'll copy the decimal digits into.
     const size_t digits_length = converted.length * 9;
-    char *digits = xcalloc(digits_length, sizeof(char));
-    if (digits == NULL) return;
+    char *digits = (char *) pm_arena_alloc(&scratch, digits_length, 1);
 
     // Pack bigdecimal to digits.
     for (size_t value_index = 0; value_index < converted.length; value_index++) {
@@ -674,8 +709,7 @@ pm_integer_string(pm_buffer_t *buffer, const pm_integer_t *integer) {
     size_t start_offset = 0;
     while (start_offset < digits_length - 1 && digits[start_offset] == '0') start_offset++;
 
-    // Finally, append the string to the buffer and free the digits.
+    // Finally, append the string to the buffer and free the scratch arena.
     pm_buffer_append_string(buffer, digits + start_offset, digits_length - start_offset);
-    xfree_sized(digits, sizeof(char) * digits_length);
-    pm_integer_free(&converted);
+    pm_arena_cleanup(&scratch);
 }
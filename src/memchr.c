@@ -10,6 +10,11 @@
  * We need to roll our own memchr to handle cases where the encoding changes and
  * we need to search for a character in a buffer that could be the trailing byte
  * of a multibyte character.
+ *
+ * Runs of ASCII are searched with memchr, since an ASCII byte that starts a
+ * character is always a whole character, and runs of two-byte characters that
+ * the encoding can recognize many bytes at a time are skipped as a whole. Only
+ * the remaining characters are walked one at a time.
  */
 const void *
 pm_memchr(const void *memory, int character, size_t number, bool encoding_changed, const pm_encoding_t *encoding) {
@@ -18,6 +23,14 @@ pm_memchr(const void *memory, int character, size_t number, bool encoding_change
         size_t index = 0;
 
         while (index < number) {
+            size_t ascii = pm_ascii_prefix_length(source + index, number - index);
+            const void *match = memchr(source + index, character, ascii);
+            if (match != NULL) return match;
+
+            index += ascii;
+            index += pm_encoding_double_byte_length(encoding, source + index, number - index);
+            if (index >= number) break;
+
             if (source[index] == character) {
                 return (void *) (source + index);
             }
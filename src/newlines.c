@@ -0,0 +1,222 @@
+#include "prism/internal/node.h"
+
+#include "prism/compiler/unused.h"
+
+#include "prism/internal/allocator.h"
+#include "prism/internal/line_offset_list.h"
+
+#include <stdlib.h>
+
+/**
+ * A line that was marked within a block or lambda, along with the mark that it
+ * had before, so that the enclosing scope can be restored when the block or
+ * lambda is finished.
+ */
+typedef struct {
+    /** The index of the line. */
+    uint32_t line;
+
+    /** The mark that the line had before. */
+    uint32_t mark;
+} pm_newlines_undo_t;
+
+/**
+ * The state of the newline marking pass.
+ */
+typedef struct {
+    /** The line offsets of the source, used to find the line of each node. */
+    const pm_line_offset_list_t *line_offsets;
+
+    /**
+     * For each line, the scope that last marked it. A line is marked in the
+     * current scope if this is equal to scope.
+     */
+    uint32_t *marks;
+
+    /** The current scope. Each block and lambda gets a new one. */
+    uint32_t scope;
+
+    /** The number of scopes that have been created. */
+    uint32_t scopes;
+
+    /** The lines marked within blocks and lambdas, to be restored on exit. */
+    pm_newlines_undo_t *undo;
+
+    /** The number of entries in the undo log. */
+    size_t undo_size;
+
+    /** The number of entries the undo log has room for. */
+    size_t undo_capacity;
+} pm_newlines_t;
+
+/**
+ * Mark the line of the given node, returning true if the line had not already
+ * been marked in the current scope.
+ */
+static bool
+pm_newlines_mark(pm_newlines_t *newlines, const pm_node_t *node) {
+    uint32_t line = (uint32_t) pm_line_offset_list_line(newlines->line_offsets, node->location.start, 0);
+    uint32_t mark = newlines->marks[line];
+    if (mark == newlines->scope) return false;
+
+    // Within a block or lambda, remember the previous mark so that it can be
+    // restored when the block or lambda is finished.
+    if (newlines->scope != 1) {
+        if (newlines->undo_size == newlines->undo_capacity) {
+            size_t capacity = newlines->undo_capacity == 0 ? 64 : newlines->undo_capacity * 2;
+            pm_newlines_undo_t *undo = (pm_newlines_undo_t *) xrealloc_sized(newlines->undo, capacity * sizeof(pm_newlines_undo_t), newlines->undo_capacity * sizeof(pm_newlines_undo_t));
+            if (undo == NULL) abort();
+
+            newlines->undo = undo;
+            newlines->undo_capacity = capacity;
+        }
+
+        newlines->undo[newlines->undo_size++] = (pm_newlines_undo_t) { .line = line, .mark = mark };
+    }
+
+    newlines->marks[line] = newlines->scope;
+    return true;
+}
+
+/**
+ * Set the newline flag on the given node if it is the first on its line. Some
+ * nodes defer to one of their children instead, since those are the nodes that
+ * CRuby fires the :line event for.
+ */
+static void
+pm_newlines_flag(pm_newlines_t *newlines, pm_node_t *node) {
+    while (node != NULL) {
+        switch (PM_NODE_TYPE(node)) {
+            case PM_BEGIN_NODE:
+            case PM_PARENTHESES_NODE:
+                return;
+            case PM_IF_NODE:
+                node = ((pm_if_node_t *) node)->predicate;
+                break;
+            case PM_UNLESS_NODE:
+                node = ((pm_unless_node_t *) node)->predicate;
+                break;
+            case PM_UNTIL_NODE:
+                node = ((pm_until_node_t *) node)->predicate;
+                break;
+            case PM_WHILE_NODE:
+                node = ((pm_while_node_t *) node)->predicate;
+                break;
+            case PM_RESCUE_MODIFIER_NODE:
+                node = ((pm_rescue_modifier_node_t *) node)->expression;
+                break;
+            case PM_INTERPOLATED_MATCH_LAST_LINE_NODE: {
+                const pm_node_list_t *parts = &((pm_interpolated_match_last_line_node_t *) node)->parts;
+                node = parts->size > 0 ? parts->nodes[0] : NULL;
+                break;
+            }
+            case PM_INTERPOLATED_REGULAR_EXPRESSION_NODE: {
+                const pm_node_list_t *parts = &((pm_interpolated_regular_expression_node_t *) node)->parts;
+                node = parts->size > 0 ? parts->nodes[0] : NULL;
+                break;
+            }
+            case PM_INTERPOLATED_STRING_NODE: {
+                const pm_node_list_t *parts = &((pm_interpolated_string_node_t *) node)->parts;
+                node = parts->size > 0 ? parts->nodes[0] : NULL;
+                break;
+            }
+            case PM_INTERPOLATED_SYMBOL_NODE: {
+                const pm_node_list_t *parts = &((pm_interpolated_symbol_node_t *) node)->parts;
+                node = parts->size > 0 ? parts->nodes[0] : NULL;
+                break;
+            }
+            case PM_INTERPOLATED_X_STRING_NODE: {
+                const pm_node_list_t *parts = &((pm_interpolated_x_string_node_t *) node)->parts;
+                node = parts->size > 0 ? parts->nodes[0] : NULL;
+                break;
+            }
+            default:
+                if (pm_newlines_mark(newlines, node)) node->flags |= PM_NODE_FLAG_NEWLINE;
+                return;
+        }
+    }
+}
+
+/**
+ * Clear the newline flag that was set while parsing from every node.
+ */
+static bool
+pm_newlines_clear(const pm_node_t *node, PRISM_UNUSED void *data) {
+    ((pm_node_t *) node)->flags &= (pm_node_flags_t) ~PM_NODE_FLAG_NEWLINE;
+    return true;
+}
+
+/**
+ * Called for each node in the tree. If and unless nodes are flagged themselves,
+ * as are the statements within statements lists.
+ */
+static bool
+pm_newlines_visit(const pm_node_t *node, void *data) {
+    pm_newlines_t *newlines = (pm_newlines_t *) data;
+
+    switch (PM_NODE_TYPE(node)) {
+        case PM_BLOCK_NODE:
+        case PM_LAMBDA_NODE: {
+            // Blocks and lambdas can mark lines that were already marked
+            // outside of them.
+            uint32_t scope = newlines->scope;
+            size_t undo_size = newlines->undo_size;
+            newlines->scope = ++newlines->scopes;
+
+            pm_visit_child_nodes(node, pm_newlines_visit, data);
+
+            while (newlines->undo_size > undo_size) {
+                const pm_newlines_undo_t *undo = &newlines->undo[--newlines->undo_size];
+                newlines->marks[undo->line] = undo->mark;
+            }
+
+            newlines->scope = scope;
+            return false;
+        }
+        case PM_IF_NODE:
+        case PM_UNLESS_NODE:
+            pm_newlines_flag(newlines, (pm_node_t *) node);
+            return true;
+        case PM_STATEMENTS_NODE: {
+            const pm_node_list_t *body = &((const pm_statements_node_t *) node)->body;
+            for (size_t index = 0; index < body->size; index++) {
+                pm_newlines_flag(newlines, body->nodes[index]);
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+/**
+ * Replace the newline flags set while parsing with ones that mark the first
+ * node on each line that would fire a :line tracepoint event. The Ruby and Java
+ * libraries read these flags rather than computing them. Any node other than a
+ * program is treated as a statement, with its own line marked first.
+ */
+void
+pm_node_mark_newlines(pm_node_t *node, const pm_line_offset_list_t *line_offsets) {
+    pm_visit_node(node, pm_newlines_clear, NULL);
+
+    uint32_t *marks = (uint32_t *) xcalloc(line_offsets->size, sizeof(uint32_t));
+    if (marks == NULL) abort();
+
+    pm_newlines_t newlines = {
+        .line_offsets = line_offsets,
+        .marks = marks,
+        .scope = 1,
+        .scopes = 1,
+        .undo = NULL,
+        .undo_size = 0,
+        .undo_capacity = 0
+    };
+
+    // Any node other than a program is marked as a statement in its own right,
+    // which is what it is when a single definition is parsed again.
+    if (!PM_NODE_TYPE_P(node, PM_PROGRAM_NODE)) pm_newlines_flag(&newlines, node);
+    pm_visit_node(node, pm_newlines_visit, &newlines);
+
+    xfree_sized(newlines.undo, newlines.undo_capacity * sizeof(pm_newlines_undo_t));
+    xfree_sized(marks, line_offsets->size * sizeof(uint32_t));
+}
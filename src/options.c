@@ -243,6 +243,118 @@ pm_options_freeze_set(pm_options_t *options, bool freeze) {
     options->freeze = freeze;
 }
 
+/**
+ * Get the attach comments option on the given options struct.
+ */
+bool
+pm_options_attach_comments(const pm_options_t *options) {
+    return options->attach_comments;
+}
+
+/**
+ * Set the attach comments option on the given options struct.
+ */
+void
+pm_options_attach_comments_set(pm_options_t *options, bool attach_comments) {
+    options->attach_comments = attach_comments;
+}
+
+/**
+ * Get the mark newlines option on the given options struct.
+ */
+bool
+pm_options_mark_newlines(const pm_options_t *options) {
+    return options->mark_newlines;
+}
+
+/**
+ * Set the mark newlines option on the given options struct.
+ */
+void
+pm_options_mark_newlines_set(pm_options_t *options, bool mark_newlines) {
+    options->mark_newlines = mark_newlines;
+}
+
+/**
+ * Get the shared constant pool option on the given options struct.
+ */
+const pm_shared_constant_pool_t *
+pm_options_shared_constant_pool(const pm_options_t *options) {
+    return options->shared_constant_pool;
+}
+
+/**
+ * Set the shared constant pool option on the given options struct.
+ */
+void
+pm_options_shared_constant_pool_set(pm_options_t *options, const pm_shared_constant_pool_t *shared_constant_pool) {
+    options->shared_constant_pool = shared_constant_pool;
+}
+
+/**
+ * Get the source strings option on the given options struct.
+ */
+bool
+pm_options_source_strings(const pm_options_t *options) {
+    return options->source_strings;
+}
+
+/**
+ * Set the source strings option on the given options struct.
+ */
+void
+pm_options_source_strings_set(pm_options_t *options, bool source_strings) {
+    options->source_strings = source_strings;
+}
+
+/**
+ * Get the discard comments option on the given options struct.
+ */
+bool
+pm_options_discard_comments(const pm_options_t *options) {
+    return options->discard_comments;
+}
+
+/**
+ * Set the discard comments option on the given options struct.
+ */
+void
+pm_options_discard_comments_set(pm_options_t *options, bool discard_comments) {
+    options->discard_comments = discard_comments;
+}
+
+/**
+ * Get the error limit option on the given options struct.
+ */
+uint32_t
+pm_options_error_limit(const pm_options_t *options) {
+    return options->error_limit;
+}
+
+/**
+ * Set the error limit option on the given options struct.
+ */
+void
+pm_options_error_limit_set(pm_options_t *options, uint32_t error_limit) {
+    options->error_limit = error_limit;
+}
+
+/**
+ * Get the syntax check option on the given options struct.
+ */
+bool
+pm_options_syntax_check(const pm_options_t *options) {
+    return options->syntax_check;
+}
+
+/**
+ * Set the syntax check option on the given options struct.
+ */
+void
+pm_options_syntax_check_set(pm_options_t *options, bool syntax_check) {
+    options->syntax_check = syntax_check;
+}
+
 /**
  * Get the raise_error option on the given options struct.
  */
@@ -401,6 +513,15 @@ pm_options_read(pm_options_t *options, const char *data) {
     options->main_script = ((uint8_t) *data++) > 0;
     options->partial_script = ((uint8_t) *data++) > 0;
     options->freeze = ((uint8_t) *data++) > 0;
+    options->attach_comments = ((uint8_t) *data++) > 0;
+    options->mark_newlines = ((uint8_t) *data++) > 0;
+    options->source_strings = ((uint8_t) *data++) > 0;
+    options->discard_comments = ((uint8_t) *data++) > 0;
+
+    options->error_limit = pm_options_read_u32(data);
+    data += 4;
+
+    options->syntax_check = ((uint8_t) *data++) > 0;
 
     uint32_t scopes_count = pm_options_read_u32(data);
     data += 4;
@@ -1,13 +1,27 @@
+#ifdef PRISM_STATS
+/* Expose clock_gettime, which is used to time the phases of the parser. */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 199309L
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+#endif
+
 #include "prism/internal/parser.h"
 
 #include "prism/internal/allocator.h"
+#include "prism/internal/arena.h"
 #include "prism/internal/comments.h"
 #include "prism/internal/diagnostic.h"
 #include "prism/internal/encoding.h"
 #include "prism/internal/magic_comments.h"
+#include "prism/reparse.h"
 
 #include <stdlib.h>
 
+#ifdef PRISM_STATS
+#include <time.h>
+#endif
+
 /**
  * Register a callback that will be called whenever prism changes the encoding
  * it is using to parse based on the magic comment.
@@ -103,6 +117,15 @@ pm_parser_constant_find(const pm_parser_t *parser, const uint8_t *start, size_t
     return pm_constant_pool_find(&parser->constant_pool, start, length);
 }
 
+/**
+ * Returns the shared constant pool that was given to the parser through its
+ * options, or NULL if none was given.
+ */
+const pm_shared_constant_pool_t *
+pm_parser_shared_constant_pool(const pm_parser_t *parser) {
+    return parser->shared_constant_pool;
+}
+
 /**
  * Returns the frozen string literal value of the parser.
  */
@@ -131,6 +154,15 @@ pm_parser_data_loc(const pm_parser_t *parser) {
     return &parser->data_loc;
 }
 
+/**
+ * Returns the location of the part of the source that was parsed the last time
+ * the given parser parsed anything.
+ */
+const pm_location_t *
+pm_parser_reparsed_loc(const pm_parser_t *parser) {
+    return &parser->reparsed_loc;
+}
+
 /**
  * Returns whether the given parser is continuable, meaning that it could become
  * valid if more input were appended, as opposed to being definitively invalid.
@@ -140,6 +172,60 @@ pm_parser_continuable(const pm_parser_t *parser) {
     return parser->continuable;
 }
 
+/**
+ * Find the first byte in the source that is not ASCII and whether the source is
+ * valid in its final encoding, the first time either is requested, and cache
+ * the results on the parser.
+ */
+static void
+pm_parser_encoding_scan(pm_parser_t *parser) {
+    if (parser->encoding_scanned) return;
+
+    size_t length = (size_t) (parser->end - parser->start);
+    size_t ascii = pm_ascii_prefix_length(parser->start, length);
+    parser->first_non_ascii = (uint32_t) ascii;
+
+    if (ascii == length) {
+        parser->encoding_validity = PM_ENCODING_VALIDITY_VALID;
+    } else if (parser->encoding == PM_ENCODING_UTF_8_ENTRY) {
+        bool valid = pm_encoding_utf_8_valid_p(parser->start + ascii, length - ascii);
+        parser->encoding_validity = valid ? PM_ENCODING_VALIDITY_VALID : PM_ENCODING_VALIDITY_INVALID;
+    } else if (parser->encoding == PM_ENCODING_US_ASCII_ENTRY) {
+        parser->encoding_validity = PM_ENCODING_VALIDITY_INVALID;
+    } else {
+        parser->encoding_validity = PM_ENCODING_VALIDITY_UNKNOWN;
+    }
+
+    parser->encoding_scanned = true;
+}
+
+/**
+ * Returns the offset of the first byte in the source that is not ASCII, or the
+ * length of the source if every byte is ASCII.
+ */
+uint32_t
+pm_parser_first_non_ascii(pm_parser_t *parser) {
+    pm_parser_encoding_scan(parser);
+    return parser->first_non_ascii;
+}
+
+/**
+ * Returns whether every byte in the source is ASCII.
+ */
+bool
+pm_parser_ascii_only(pm_parser_t *parser) {
+    return pm_parser_first_non_ascii(parser) == (uint32_t) (parser->end - parser->start);
+}
+
+/**
+ * Returns whether the source is valid in the encoding that it was parsed with.
+ */
+pm_encoding_validity_t
+pm_parser_encoding_validity(pm_parser_t *parser) {
+    pm_parser_encoding_scan(parser);
+    return parser->encoding_validity;
+}
+
 /**
  * Returns the lex state of the parser. Note that this is an internal detail,
  * and we are purposefully not returning an instance of the internal enum that
@@ -277,7 +363,7 @@ pm_parser_warnings_each(const pm_parser_t *parser, pm_diagnostic_callback_t call
  */
 size_t
 pm_parser_constants_size(const pm_parser_t *parser) {
-    return parser->constant_pool.size;
+    return pm_constant_pool_total_size(&parser->constant_pool);
 }
 
 /**
@@ -286,9 +372,10 @@ pm_parser_constants_size(const pm_parser_t *parser) {
  */
 void
 pm_parser_constants_each(const pm_parser_t *parser, pm_constant_callback_t callback, void *data) {
-    for (uint32_t index = 0; index < parser->constant_pool.size; index++) {
-        const pm_constant_t *constant = &parser->constant_pool.constants[index];
-        callback(constant, data);
+    uint32_t size = pm_constant_pool_total_size(&parser->constant_pool);
+
+    for (uint32_t id = 1; id <= size; id++) {
+        callback(pm_constant_pool_id_to_constant(&parser->constant_pool, id), data);
     }
 }
 
@@ -300,3 +387,53 @@ const pm_constant_t *
 pm_parser_constant(const pm_parser_t *parser, pm_constant_id_t constant_id) {
     return pm_constant_pool_id_to_constant(&parser->constant_pool, constant_id);
 }
+
+#ifdef PRISM_STATS
+
+/**
+ * Return a monotonic timestamp in nanoseconds. If there is no monotonic clock,
+ * processor time is used instead.
+ */
+uint64_t
+pm_parser_stats_time(void) {
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec) * 1000000000 + (uint64_t) now.tv_nsec;
+#else
+    return (uint64_t) ((double) clock() * (1e9 / CLOCKS_PER_SEC));
+#endif
+}
+
+/**
+ * Add the number of blocks in the given arena and the number of bytes used in
+ * them to the given counters.
+ */
+static void
+pm_parser_stats_arena(const pm_arena_t *arena, size_t *blocks, size_t *bytes) {
+    *blocks += arena->block_count;
+
+    for (const pm_arena_block_t *block = arena->current; block != NULL; block = block->prev) {
+        *bytes += block->used;
+    }
+}
+
+/**
+ * Copy the statistics gathered by the given parser into the given stats struct.
+ */
+void
+pm_parser_stats(const pm_parser_t *parser, pm_parser_stats_t *stats) {
+    *stats = parser->stats;
+
+    pm_parser_stats_arena(parser->arena, &stats->ast_arena_blocks, &stats->ast_arena_bytes);
+    pm_parser_stats_arena(&parser->metadata_arena, &stats->metadata_arena_blocks, &stats->metadata_arena_bytes);
+
+    stats->constant_inserts = parser->constant_pool.stats_inserts;
+    stats->constant_collisions = parser->constant_pool.stats_collisions;
+    stats->constant_resizes = parser->constant_pool.stats_resizes;
+
+    stats->errors = parser->error_list.size;
+    stats->warnings = parser->warning_list.size;
+}
+
+#endif
@@ -0,0 +1,705 @@
+#include "prism/pattern.h"
+
+#include "prism/internal/allocator.h"
+#include "prism/internal/arena.h"
+#include "prism/internal/node.h"
+
+#include "prism/arena.h"
+#include "prism/constant_pool.h"
+#include "prism/stringy.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of words in a set of node types. */
+#define PM_PATTERN_TYPES_SIZE ((PM_SCOPE_NODE >> 6) + 1)
+
+/** The prefix that is added to a query to parse it as a pattern. */
+#define PM_PATTERN_PREFIX "case nil\nin "
+
+/** The suffix that is added to a query to parse it as a pattern. */
+#define PM_PATTERN_SUFFIX "\nend"
+
+/**
+ * The operations that a compiled pattern is made up of. Instructions are laid
+ * out in prefix order, so the operands of an instruction directly follow it.
+ */
+typedef enum {
+    /** Matches nil, a missing node, or a missing constant. */
+    PM_PATTERN_OPCODE_NIL,
+
+    /** Matches a node whose type is in the set of types. */
+    PM_PATTERN_OPCODE_TYPES,
+
+    /** Matches against a constant that is not a node class. */
+    PM_PATTERN_OPCODE_CONSTANT,
+
+    /** Matches against a regular expression. */
+    PM_PATTERN_OPCODE_REGEXP,
+
+    /** Matches a string field with the same contents. */
+    PM_PATTERN_OPCODE_STRING,
+
+    /** Matches a constant field with the same name. */
+    PM_PATTERN_OPCODE_SYMBOL,
+
+    /** Matches if either of the two operands match. */
+    PM_PATTERN_OPCODE_ALTERNATION,
+
+    /**
+     * Matches if the optional constant operand matches and each of the
+     * element operands match the deconstructed value.
+     */
+    PM_PATTERN_OPCODE_ARRAY,
+
+    /**
+     * Matches if the optional constant operand matches and each of the key
+     * operands match the deconstructed value.
+     */
+    PM_PATTERN_OPCODE_HASH,
+
+    /** Matches if the field with the given name matches the operand. */
+    PM_PATTERN_OPCODE_KEY
+} pm_pattern_opcode_t;
+
+/**
+ * A single instruction in a compiled pattern.
+ */
+typedef struct {
+    /** The operation that this instruction performs. */
+    pm_pattern_opcode_t opcode;
+
+    /** The number of instructions taken up by this instruction and its operands. */
+    uint32_t length;
+
+    /** The number of element or key operands of an array or hash instruction. */
+    uint32_t count;
+
+    /** Whether an array or hash instruction has a constant operand. */
+    bool constant;
+
+    /** Whether the bytes of a string or symbol instruction are all ASCII. */
+    bool ascii;
+
+    /** The bytes of a string, symbol, or key instruction. */
+    const uint8_t *bytes;
+
+    /** The number of bytes of a string, symbol, or key instruction. */
+    size_t size;
+
+    /** The constant id of a symbol instruction in the tree being scanned. */
+    pm_constant_id_t constant_id;
+
+    /** The index of the field of each type of node for a key instruction. */
+    int8_t *fields;
+
+    /** The set of node types for a types instruction. */
+    uint64_t types[PM_PATTERN_TYPES_SIZE];
+} pm_pattern_instruction_t;
+
+/**
+ * A compiled pattern.
+ */
+struct pm_pattern_t {
+    /** The arena that holds the bytes and field tables of the instructions. */
+    pm_arena_t *arena;
+
+    /** The instructions of the pattern. */
+    pm_pattern_instruction_t *instructions;
+
+    /** The number of instructions in the pattern. */
+    uint32_t size;
+
+    /** The number of instructions that have been allocated. */
+    uint32_t capacity;
+
+    /** Whether the pattern contains no constant or regexp instructions. */
+    bool complete;
+
+    /**
+     * Whether the type of a node is enough to reject it, in which case the
+     * types field holds the set of types that can match.
+     */
+    bool filtered;
+
+    /** The set of node types that can match the pattern, if filtered. */
+    uint64_t types[PM_PATTERN_TYPES_SIZE];
+};
+
+/**
+ * Returns whether the given type is in the given set of types.
+ */
+static inline bool
+pm_pattern_types_p(const uint64_t *types, pm_node_type_t type) {
+    return (types[type >> 6] & (((uint64_t) 1) << (type & 63))) != 0;
+}
+
+/**
+ * Add the given type to the given set of types.
+ */
+static inline void
+pm_pattern_types_add(uint64_t *types, pm_node_type_t type) {
+    types[type >> 6] |= ((uint64_t) 1) << (type & 63);
+}
+
+/**
+ * Append a new instruction to the pattern and return its index.
+ */
+static uint32_t
+pm_pattern_push(pm_pattern_t *pattern, pm_pattern_opcode_t opcode) {
+    if (pattern->size == pattern->capacity) {
+        uint32_t capacity = pattern->capacity == 0 ? 8 : pattern->capacity * 2;
+        pattern->instructions = (pm_pattern_instruction_t *) xrealloc_sized(pattern->instructions, sizeof(pm_pattern_instruction_t) * capacity, sizeof(pm_pattern_instruction_t) * pattern->capacity);
+        if (pattern->instructions == NULL) abort();
+        pattern->capacity = capacity;
+    }
+
+    uint32_t index = pattern->size++;
+    pattern->instructions[index] = (pm_pattern_instruction_t) { .opcode = opcode, .length = 1 };
+    return index;
+}
+
+/**
+ * Set the bytes of the given instruction to a copy of the given bytes.
+ */
+static void
+pm_pattern_bytes_set(pm_pattern_t *pattern, uint32_t index, const uint8_t *bytes, size_t size) {
+    uint8_t *copy = (uint8_t *) pm_arena_alloc(pattern->arena, size == 0 ? 1 : size, 1);
+    if (size > 0) memcpy(copy, bytes, size);
+
+    bool ascii = true;
+    for (size_t offset = 0; offset < size; offset++) {
+        if (bytes[offset] >= 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+
+    pm_pattern_instruction_t *instruction = &pattern->instructions[index];
+    instruction->bytes = copy;
+    instruction->size = size;
+    instruction->ascii = ascii;
+}
+
+static bool pm_pattern_compile_node(pm_pattern_t *pattern, const pm_parser_t *parser, const pm_node_t *node);
+
+/**
+ * Compile a reference to the constant with the given name. Node classes (and
+ * Prism::Node itself) are compiled into a set of types, and everything else is
+ * left for the caller to check.
+ */
+static bool
+pm_pattern_compile_constant(pm_pattern_t *pattern, const pm_parser_t *parser, pm_constant_id_t name) {
+    if (name == 0) return false;
+
+    const pm_constant_t *constant = pm_parser_constant(parser, name);
+    const uint8_t *start = pm_constant_start(constant);
+    size_t length = pm_constant_length(constant);
+
+    uint32_t index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_TYPES);
+    pm_node_type_t type = pm_node_type_find(start, length);
+
+    if (type != 0) {
+        pm_pattern_types_add(pattern->instructions[index].types, type);
+    } else if (length == 4 && memcmp(start, "Node", 4) == 0) {
+        for (pm_node_type_t type = 1; type < PM_SCOPE_NODE; type++) {
+            pm_pattern_types_add(pattern->instructions[index].types, type);
+        }
+    } else {
+        pattern->instructions[index].opcode = PM_PATTERN_OPCODE_CONSTANT;
+        pm_pattern_bytes_set(pattern, index, start, length);
+        pattern->complete = false;
+    }
+
+    return true;
+}
+
+/**
+ * Compile the optional constant of an array or hash pattern.
+ */
+static bool
+pm_pattern_compile_optional(pm_pattern_t *pattern, const pm_parser_t *parser, uint32_t index, const pm_node_t *constant) {
+    if (constant == NULL) return true;
+
+    pattern->instructions[index].constant = true;
+    return pm_pattern_compile_node(pattern, parser, constant);
+}
+
+/**
+ * Compile the given node from the pattern into instructions, mirroring the
+ * compile_* methods of Prism::Pattern. Returns false if the node uses syntax
+ * that is not supported.
+ */
+static bool
+pm_pattern_compile_node(pm_pattern_t *pattern, const pm_parser_t *parser, const pm_node_t *node) {
+    if (node == NULL) return false;
+
+    uint32_t index;
+    switch (PM_NODE_TYPE(node)) {
+        case PM_ALTERNATION_PATTERN_NODE: {
+            const pm_alternation_pattern_node_t *cast = (const pm_alternation_pattern_node_t *) node;
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_ALTERNATION);
+
+            if (!pm_pattern_compile_node(pattern, parser, cast->left)) return false;
+            if (!pm_pattern_compile_node(pattern, parser, cast->right)) return false;
+            break;
+        }
+        case PM_ARRAY_PATTERN_NODE: {
+            const pm_array_pattern_node_t *cast = (const pm_array_pattern_node_t *) node;
+            if (cast->rest != NULL || cast->posts.size > 0) return false;
+
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_ARRAY);
+            pattern->instructions[index].count = (uint32_t) cast->requireds.size;
+            if (!pm_pattern_compile_optional(pattern, parser, index, cast->constant)) return false;
+
+            for (size_t required = 0; required < cast->requireds.size; required++) {
+                if (!pm_pattern_compile_node(pattern, parser, cast->requireds.nodes[required])) return false;
+            }
+            break;
+        }
+        case PM_CONSTANT_PATH_NODE: {
+            const pm_constant_path_node_t *cast = (const pm_constant_path_node_t *) node;
+            const pm_node_t *parent = cast->parent;
+
+            if (parent == NULL || !PM_NODE_TYPE_P(parent, PM_CONSTANT_READ_NODE)) return false;
+            if (parent->location.length != 5 || memcmp(pm_parser_start(parser) + parent->location.start, "Prism", 5) != 0) return false;
+
+            return pm_pattern_compile_constant(pattern, parser, cast->name);
+        }
+        case PM_CONSTANT_READ_NODE:
+            return pm_pattern_compile_constant(pattern, parser, ((const pm_constant_read_node_t *) node)->name);
+        case PM_HASH_PATTERN_NODE: {
+            const pm_hash_pattern_node_t *cast = (const pm_hash_pattern_node_t *) node;
+            if (cast->rest != NULL) return false;
+
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_HASH);
+            pattern->instructions[index].count = (uint32_t) cast->elements.size;
+            if (!pm_pattern_compile_optional(pattern, parser, index, cast->constant)) return false;
+
+            for (size_t element_index = 0; element_index < cast->elements.size; element_index++) {
+                const pm_node_t *element = cast->elements.nodes[element_index];
+                if (!PM_NODE_TYPE_P(element, PM_ASSOC_NODE)) return false;
+
+                const pm_assoc_node_t *assoc = (const pm_assoc_node_t *) element;
+                if (!PM_NODE_TYPE_P(assoc->key, PM_SYMBOL_NODE)) return false;
+
+                const pm_string_t *key = &((const pm_symbol_node_t *) assoc->key)->unescaped;
+                uint32_t key_index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_KEY);
+                pm_pattern_bytes_set(pattern, key_index, pm_string_source(key), pm_string_length(key));
+
+                int8_t *fields = (int8_t *) pm_arena_alloc(pattern->arena, PM_SCOPE_NODE + 1, 1);
+                for (pm_node_type_t type = 0; type <= PM_SCOPE_NODE; type++) {
+                    fields[type] = (int8_t) pm_node_field_find(type, pm_string_source(key), pm_string_length(key));
+                }
+                pattern->instructions[key_index].fields = fields;
+
+                if (!pm_pattern_compile_node(pattern, parser, assoc->value)) return false;
+                pattern->instructions[key_index].length = pattern->size - key_index;
+            }
+            break;
+        }
+        case PM_NIL_NODE:
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_NIL);
+            break;
+        case PM_REGULAR_EXPRESSION_NODE:
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_REGEXP);
+            pattern->complete = false;
+            break;
+        case PM_STRING_NODE: {
+            const pm_string_t *unescaped = &((const pm_string_node_t *) node)->unescaped;
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_STRING);
+            pm_pattern_bytes_set(pattern, index, pm_string_source(unescaped), pm_string_length(unescaped));
+            break;
+        }
+        case PM_SYMBOL_NODE: {
+            const pm_string_t *unescaped = &((const pm_symbol_node_t *) node)->unescaped;
+            index = pm_pattern_push(pattern, PM_PATTERN_OPCODE_SYMBOL);
+            pm_pattern_bytes_set(pattern, index, pm_string_source(unescaped), pm_string_length(unescaped));
+            break;
+        }
+        default:
+            return false;
+    }
+
+    pattern->instructions[index].length = pattern->size - index;
+    return true;
+}
+
+/**
+ * Compute the set of node types that can match the instruction at the given
+ * index when matched against a node. Returns false if any type may match.
+ */
+static bool
+pm_pattern_filter(const pm_pattern_t *pattern, uint32_t index, uint64_t *types) {
+    const pm_pattern_instruction_t *instruction = &pattern->instructions[index];
+
+    switch (instruction->opcode) {
+        case PM_PATTERN_OPCODE_TYPES:
+            for (size_t word = 0; word < PM_PATTERN_TYPES_SIZE; word++) types[word] |= instruction->types[word];
+            return true;
+        case PM_PATTERN_OPCODE_NIL:
+        case PM_PATTERN_OPCODE_REGEXP:
+        case PM_PATTERN_OPCODE_STRING:
+        case PM_PATTERN_OPCODE_SYMBOL:
+            return true;
+        case PM_PATTERN_OPCODE_ALTERNATION: {
+            uint32_t right = index + 1 + pattern->instructions[index + 1].length;
+            return pm_pattern_filter(pattern, index + 1, types) && pm_pattern_filter(pattern, right, types);
+        }
+        case PM_PATTERN_OPCODE_ARRAY:
+        case PM_PATTERN_OPCODE_HASH:
+            return instruction->constant && pm_pattern_filter(pattern, index + 1, types);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Compile the given query into a pattern.
+ */
+pm_pattern_t *
+pm_pattern_new(const uint8_t *query, size_t length) {
+    size_t prefix_length = sizeof(PM_PATTERN_PREFIX) - 1;
+    size_t suffix_length = sizeof(PM_PATTERN_SUFFIX) - 1;
+    size_t source_length = prefix_length + length + suffix_length;
+
+    uint8_t *source = (uint8_t *) xmalloc(source_length);
+    if (source == NULL) abort();
+
+    memcpy(source, PM_PATTERN_PREFIX, prefix_length);
+    memcpy(source + prefix_length, query, length);
+    memcpy(source + prefix_length + length, PM_PATTERN_SUFFIX, suffix_length);
+
+    pm_arena_t *arena = pm_arena_new();
+    pm_parser_t *parser = pm_parser_new(arena, source, source_length, NULL);
+    const pm_program_node_t *program = (const pm_program_node_t *) pm_parse(parser);
+
+    pm_pattern_t *pattern = (pm_pattern_t *) xcalloc(1, sizeof(pm_pattern_t));
+    if (pattern == NULL) abort();
+
+    pattern->arena = pm_arena_new();
+    pattern->complete = true;
+
+    const pm_node_list_t *body = &program->statements->body;
+    const pm_node_t *statement = body->size == 0 ? NULL : body->nodes[body->size - 1];
+    bool compiled = false;
+
+    if (statement != NULL && PM_NODE_TYPE_P(statement, PM_CASE_MATCH_NODE)) {
+        const pm_node_list_t *conditions = &((const pm_case_match_node_t *) statement)->conditions;
+        const pm_node_t *condition = conditions->size == 0 ? NULL : conditions->nodes[conditions->size - 1];
+
+        if (condition != NULL && PM_NODE_TYPE_P(condition, PM_IN_NODE)) {
+            compiled = pm_pattern_compile_node(pattern, parser, ((const pm_in_node_t *) condition)->pattern);
+        }
+    }
+
+    pm_parser_free(parser);
+    pm_arena_free(arena);
+    xfree_sized(source, source_length);
+
+    if (!compiled) {
+        pm_pattern_free(pattern);
+        return NULL;
+    }
+
+    pattern->filtered = pm_pattern_filter(pattern, 0, pattern->types);
+    return pattern;
+}
+
+/**
+ * Free the given pattern.
+ */
+void
+pm_pattern_free(pm_pattern_t *pattern) {
+    if (pattern->instructions != NULL) {
+        xfree_sized(pattern->instructions, sizeof(pm_pattern_instruction_t) * pattern->capacity);
+    }
+
+    pm_arena_free(pattern->arena);
+    xfree_sized(pattern, sizeof(pm_pattern_t));
+}
+
+/**
+ * Returns whether every part of the given pattern can be checked natively.
+ */
+bool
+pm_pattern_complete(const pm_pattern_t *pattern) {
+    return pattern->complete;
+}
+
+/**
+ * The smaller of two match results, used to combine results that must all
+ * match.
+ */
+static inline pm_pattern_match_t
+pm_pattern_match_and(pm_pattern_match_t left, pm_pattern_match_t right) {
+    return left < right ? left : right;
+}
+
+/**
+ * The larger of two match results, used to combine results of which any may
+ * match.
+ */
+static inline pm_pattern_match_t
+pm_pattern_match_or(pm_pattern_match_t left, pm_pattern_match_t right) {
+    return left > right ? left : right;
+}
+
+/**
+ * The result of matching a string or symbol whose bytes are the same as the
+ * instruction's bytes. Non-ASCII strings in different encodings may still
+ * compare differently in Ruby, so those are left to the caller.
+ */
+static inline pm_pattern_match_t
+pm_pattern_match_bytes(const pm_pattern_instruction_t *instruction) {
+    return instruction->ascii ? PM_PATTERN_MATCH_EXACT : PM_PATTERN_MATCH_MAYBE;
+}
+
+static pm_pattern_match_t pm_pattern_match(const pm_pattern_t *pattern, uint32_t index, const pm_node_field_t *value);
+
+/**
+ * Match the element operands that start at the given index against the values
+ * that #deconstruct returns for the given value.
+ */
+static pm_pattern_match_t
+pm_pattern_match_elements(const pm_pattern_t *pattern, uint32_t index, uint32_t count, const pm_node_field_t *value) {
+    pm_pattern_match_t result = PM_PATTERN_MATCH_EXACT;
+
+    switch (value->type) {
+        case PM_NODE_FIELD_NODE: {
+            const pm_node_t *node = value->as.node;
+            if (node == NULL) return PM_PATTERN_MATCH_MAYBE;
+
+            // Node#deconstruct returns the child nodes, including nil for
+            // missing optional nodes.
+            pm_node_field_t field;
+            size_t size = 0;
+
+            for (int field_index = 0; pm_node_field(node, field_index, &field); field_index++) {
+                if (field.type == PM_NODE_FIELD_NODE) {
+                    size++;
+                } else if (field.type == PM_NODE_FIELD_NODE_LIST) {
+                    size += field.as.node_list->size;
+                }
+            }
+
+            if (size != count) return PM_PATTERN_MATCH_NONE;
+
+            for (int field_index = 0; pm_node_field(node, field_index, &field); field_index++) {
+                if (field.type == PM_NODE_FIELD_NODE) {
+                    result = pm_pattern_match_and(result, pm_pattern_match(pattern, index, &field));
+                    if (result == PM_PATTERN_MATCH_NONE) return result;
+                    index += pattern->instructions[index].length;
+                } else if (field.type == PM_NODE_FIELD_NODE_LIST) {
+                    const pm_node_list_t *list = field.as.node_list;
+
+                    for (size_t list_index = 0; list_index < list->size; list_index++) {
+                        pm_node_field_t element = { .type = PM_NODE_FIELD_NODE, .as.node = list->nodes[list_index] };
+                        result = pm_pattern_match_and(result, pm_pattern_match(pattern, index, &element));
+                        if (result == PM_PATTERN_MATCH_NONE) return result;
+                        index += pattern->instructions[index].length;
+                    }
+                }
+            }
+
+            return result;
+        }
+        case PM_NODE_FIELD_NODE_LIST: {
+            const pm_node_list_t *list = value->as.node_list;
+            if (list->size != count) return PM_PATTERN_MATCH_NONE;
+
+            for (size_t list_index = 0; list_index < list->size; list_index++) {
+                pm_node_field_t element = { .type = PM_NODE_FIELD_NODE, .as.node = list->nodes[list_index] };
+                result = pm_pattern_match_and(result, pm_pattern_match(pattern, index, &element));
+                if (result == PM_PATTERN_MATCH_NONE) return result;
+                index += pattern->instructions[index].length;
+            }
+
+            return result;
+        }
+        case PM_NODE_FIELD_CONSTANT_LIST: {
+            const pm_constant_id_list_t *list = value->as.constant_list;
+            if (list->size != count) return PM_PATTERN_MATCH_NONE;
+
+            for (size_t list_index = 0; list_index < list->size; list_index++) {
+                pm_node_field_t element = { .type = PM_NODE_FIELD_CONSTANT, .as.constant = list->ids[list_index] };
+                result = pm_pattern_match_and(result, pm_pattern_match(pattern, index, &element));
+                if (result == PM_PATTERN_MATCH_NONE) return result;
+                index += pattern->instructions[index].length;
+            }
+
+            return result;
+        }
+        default:
+            // Anything else either does not respond to #deconstruct or is not
+            // known natively.
+            return PM_PATTERN_MATCH_MAYBE;
+    }
+}
+
+/**
+ * Match the key operands that start at the given index against the values that
+ * #deconstruct_keys returns for the given value.
+ */
+static pm_pattern_match_t
+pm_pattern_match_keys(const pm_pattern_t *pattern, uint32_t index, uint32_t count, const pm_node_field_t *value) {
+    if (value->type != PM_NODE_FIELD_NODE || value->as.node == NULL) return PM_PATTERN_MATCH_MAYBE;
+
+    const pm_node_t *node = value->as.node;
+    pm_pattern_match_t result = PM_PATTERN_MATCH_EXACT;
+
+    for (uint32_t key = 0; key < count; key++) {
+        const pm_pattern_instruction_t *instruction = &pattern->instructions[index];
+        int field_index = instruction->fields[PM_NODE_TYPE(node)];
+        pm_node_field_t field = { .type = PM_NODE_FIELD_OTHER };
+
+        if (field_index == PM_NODE_FIELD_INDEX_NONE) return PM_PATTERN_MATCH_NONE;
+        if (field_index != PM_NODE_FIELD_INDEX_OTHER) pm_node_field(node, field_index, &field);
+
+        result = pm_pattern_match_and(result, pm_pattern_match(pattern, index + 1, &field));
+        if (result == PM_PATTERN_MATCH_NONE) return result;
+
+        index += instruction->length;
+    }
+
+    return result;
+}
+
+/**
+ * Match the instruction at the given index against the given value.
+ */
+static pm_pattern_match_t
+pm_pattern_match(const pm_pattern_t *pattern, uint32_t index, const pm_node_field_t *value) {
+    const pm_pattern_instruction_t *instruction = &pattern->instructions[index];
+
+    // Fields that cannot be read natively may match anything but
+    // alternations, which may still be decided by their other side.
+    if (value->type == PM_NODE_FIELD_OTHER && instruction->opcode != PM_PATTERN_OPCODE_ALTERNATION) {
+        return PM_PATTERN_MATCH_MAYBE;
+    }
+
+    switch (instruction->opcode) {
+        case PM_PATTERN_OPCODE_NIL:
+            switch (value->type) {
+                case PM_NODE_FIELD_NODE: return value->as.node == NULL ? PM_PATTERN_MATCH_EXACT : PM_PATTERN_MATCH_NONE;
+                case PM_NODE_FIELD_CONSTANT: return value->as.constant == 0 ? PM_PATTERN_MATCH_EXACT : PM_PATTERN_MATCH_NONE;
+                default: return PM_PATTERN_MATCH_NONE;
+            }
+        case PM_PATTERN_OPCODE_TYPES:
+            if (value->type != PM_NODE_FIELD_NODE || value->as.node == NULL) return PM_PATTERN_MATCH_NONE;
+            return pm_pattern_types_p(instruction->types, PM_NODE_TYPE(value->as.node)) ? PM_PATTERN_MATCH_EXACT : PM_PATTERN_MATCH_NONE;
+        case PM_PATTERN_OPCODE_CONSTANT:
+            return PM_PATTERN_MATCH_MAYBE;
+        case PM_PATTERN_OPCODE_REGEXP:
+            // Regexp#=== only matches strings and symbols.
+            if (value->type == PM_NODE_FIELD_STRING) return PM_PATTERN_MATCH_MAYBE;
+            if (value->type == PM_NODE_FIELD_CONSTANT && value->as.constant != 0) return PM_PATTERN_MATCH_MAYBE;
+            return PM_PATTERN_MATCH_NONE;
+        case PM_PATTERN_OPCODE_STRING:
+            if (value->type != PM_NODE_FIELD_STRING) return PM_PATTERN_MATCH_NONE;
+            if (pm_string_length(value->as.string) != instruction->size) return PM_PATTERN_MATCH_NONE;
+            if (instruction->size > 0 && memcmp(pm_string_source(value->as.string), instruction->bytes, instruction->size) != 0) return PM_PATTERN_MATCH_NONE;
+            return pm_pattern_match_bytes(instruction);
+        case PM_PATTERN_OPCODE_SYMBOL:
+            if (value->type != PM_NODE_FIELD_CONSTANT || value->as.constant == 0) return PM_PATTERN_MATCH_NONE;
+            return value->as.constant == instruction->constant_id ? pm_pattern_match_bytes(instruction) : PM_PATTERN_MATCH_NONE;
+        case PM_PATTERN_OPCODE_ALTERNATION: {
+            pm_pattern_match_t left = pm_pattern_match(pattern, index + 1, value);
+            if (left == PM_PATTERN_MATCH_EXACT) return left;
+
+            uint32_t right = index + 1 + pattern->instructions[index + 1].length;
+            return pm_pattern_match_or(left, pm_pattern_match(pattern, right, value));
+        }
+        case PM_PATTERN_OPCODE_ARRAY:
+        case PM_PATTERN_OPCODE_HASH: {
+            pm_pattern_match_t result = PM_PATTERN_MATCH_EXACT;
+            uint32_t operand = index + 1;
+
+            if (instruction->constant) {
+                result = pm_pattern_match(pattern, operand, value);
+                if (result == PM_PATTERN_MATCH_NONE) return result;
+                operand += pattern->instructions[operand].length;
+            }
+
+            if (instruction->opcode == PM_PATTERN_OPCODE_ARRAY) {
+                return pm_pattern_match_and(result, pm_pattern_match_elements(pattern, operand, instruction->count, value));
+            } else {
+                return pm_pattern_match_and(result, pm_pattern_match_keys(pattern, operand, instruction->count, value));
+            }
+        }
+        case PM_PATTERN_OPCODE_KEY:
+            break;
+    }
+
+    return PM_PATTERN_MATCH_MAYBE;
+}
+
+/**
+ * A queue of nodes that have yet to be visited by pm_pattern_scan.
+ */
+typedef struct {
+    /** The nodes in the queue. */
+    const pm_node_t **nodes;
+
+    /** The number of nodes that have been added to the queue. */
+    size_t size;
+
+    /** The number of nodes that have been allocated. */
+    size_t capacity;
+} pm_pattern_queue_t;
+
+/**
+ * Add the given node to the end of the queue. This is used as the visitor
+ * callback for pm_visit_child_nodes, so it does not descend any further.
+ */
+static bool
+pm_pattern_queue_push(const pm_node_t *node, void *data) {
+    pm_pattern_queue_t *queue = (pm_pattern_queue_t *) data;
+
+    if (queue->size == queue->capacity) {
+        size_t capacity = queue->capacity == 0 ? 64 : queue->capacity * 2;
+        queue->nodes = (const pm_node_t **) xrealloc_sized(queue->nodes, sizeof(const pm_node_t *) * capacity, sizeof(const pm_node_t *) * queue->capacity);
+        if (queue->nodes == NULL) abort();
+        queue->capacity = capacity;
+    }
+
+    queue->nodes[queue->size++] = node;
+    return false;
+}
+
+/**
+ * Walk the given tree breadth-first and call the callback for each node that
+ * matches or may match the pattern.
+ */
+void
+pm_pattern_scan(pm_pattern_t *pattern, const pm_parser_t *parser, const pm_node_t *node, pm_pattern_callback_t callback, void *data) {
+    // Symbols are compared by constant id, so resolve them against the
+    // constant pool of this tree. Symbols that are not in the pool cannot
+    // match anything.
+    for (uint32_t index = 0; index < pattern->size; index++) {
+        pm_pattern_instruction_t *instruction = &pattern->instructions[index];
+
+        if (instruction->opcode == PM_PATTERN_OPCODE_SYMBOL) {
+            instruction->constant_id = pm_parser_constant_find(parser, instruction->bytes, instruction->size);
+        }
+    }
+
+    pm_pattern_queue_t queue = { 0 };
+    pm_pattern_queue_push(node, &queue);
+
+    for (size_t index = 0; index < queue.size; index++) {
+        const pm_node_t *current = queue.nodes[index];
+
+        if (!pattern->filtered || pm_pattern_types_p(pattern->types, PM_NODE_TYPE(current))) {
+            pm_node_field_t value = { .type = PM_NODE_FIELD_NODE, .as.node = current };
+            pm_pattern_match_t match = pm_pattern_match(pattern, 0, &value);
+            if (match != PM_PATTERN_MATCH_NONE) callback(current, match, data);
+        }
+
+        pm_visit_child_nodes(current, pm_pattern_queue_push, &queue);
+    }
+
+    if (queue.nodes != NULL) {
+        xfree_sized(queue.nodes, sizeof(const pm_node_t *) * queue.capacity);
+    }
+}
@@ -30,6 +30,7 @@
 #include "prism/internal/tokens.h"
 
 #include "prism/excludes.h"
+#include "prism/reparse.h"
 #include "prism/serialize.h"
 #include "prism/stream.h"
 #include "prism/version.h"
@@ -39,6 +40,7 @@
 #include <limits.h>
 #include <locale.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -51,6 +53,15 @@
     #define PRISM_DEPTH_MAXIMUM 10000
 #endif
 
+/**
+ * Inputs of at least this many bytes have their line feeds counted before
+ * parsing so that the line offset list can be allocated at its exact size.
+ * Smaller inputs use an estimate based on their size.
+ */
+#ifndef PRISM_LINE_OFFSET_PRESCAN_SIZE
+    #define PRISM_LINE_OFFSET_PRESCAN_SIZE (64 * 1024)
+#endif
+
 /**
  * A simple utility macro to concatenate two tokens together, necessary when one
  * of the tokens is itself a macro.
@@ -210,6 +221,9 @@ lex_mode_terminator(const uint8_t start) {
  */
 static bool
 lex_mode_push(pm_parser_t *parser, pm_lex_mode_t lex_mode) {
+    PM_PARSER_STATS_INCREMENT(parser, lex_mode_pushes);
+    if (lex_mode.mode == PM_LEX_HEREDOC) PM_PARSER_STATS_INCREMENT(parser, heredocs);
+
     lex_mode.prev = parser->lex_modes.current;
     parser->lex_modes.index++;
 
@@ -391,6 +405,10 @@ lex_mode_pop(pm_parser_t *parser) {
         xfree_sized(parser->lex_modes.current, sizeof(pm_lex_mode_t));
         parser->lex_modes.current = prev;
     }
+
+    if (parser->lex_modes.index < parser->lex_modes.floor) {
+        parser->lex_modes.floor = parser->lex_modes.index;
+    }
 }
 
 /**
@@ -714,7 +732,9 @@ pm_parser_scope_push(pm_parser_t *parser, bool closed) {
         .parameters = PM_SCOPE_PARAMETERS_NONE,
         .implicit_parameters = { 0 },
         .shareable_constant = parser->current_scope == NULL ? PM_SCOPE_SHAREABLE_CONSTANT_NONE : parser->current_scope->shareable_constant,
-        .closed = closed
+        .closed = closed,
+        .toplevel = parser->current_scope == NULL || (!closed && parser->current_scope->toplevel),
+        .visible_bloom = (parser->current_scope == NULL || closed) ? 0 : parser->current_scope->visible_bloom
     };
 
     parser->current_scope = scope;
@@ -727,15 +747,7 @@ pm_parser_scope_push(pm_parser_t *parser, bool closed) {
  */
 static bool
 pm_parser_scope_toplevel_p(pm_parser_t *parser) {
-    pm_scope_t *scope = parser->current_scope;
-
-    do {
-        if (scope->previous == NULL) return true;
-        if (scope->closed) return false;
-    } while ((scope = scope->previous) != NULL);
-
-    assert(false && "unreachable");
-    return true;
+    return parser->current_scope->toplevel;
 }
 
 /**
@@ -1359,14 +1371,24 @@ pm_check_value_expression(pm_parser_t *parser, pm_node_t *node) {
                 node = UP(cast->statements);
                 break;
             }
-            case PM_AND_NODE: {
-                pm_and_node_t *cast = (pm_and_node_t *) node;
-                node = cast->left;
-                break;
-            }
+            case PM_AND_NODE:
             case PM_OR_NODE: {
-                pm_or_node_t *cast = (pm_or_node_t *) node;
-                node = cast->left;
+                pm_node_t *left = PM_NODE_TYPE_P(node, PM_AND_NODE) ? ((pm_and_node_t *) node)->left : ((pm_or_node_t *) node)->left;
+
+                // The result for an and/or node is the result for its
+                // left-hand side, so without any void node found so far we
+                // can check that once and remember it for the next link in
+                // the chain.
+                if (void_node == NULL) {
+                    if (node == parser->value_expression.node) return parser->value_expression.void_node;
+
+                    pm_node_t *vn = pm_check_value_expression(parser, left);
+                    parser->value_expression.node = node;
+                    parser->value_expression.void_node = vn;
+                    return vn;
+                }
+
+                node = left;
                 break;
             }
             case PM_LOCAL_VARIABLE_WRITE_NODE: {
@@ -2308,25 +2330,12 @@ pm_statements_node_body_append(pm_parser_t *parser, pm_statements_node_t *node,
 static size_t
 pm_statements_node_body_length(pm_statements_node_t *node);
 
-/**
- * Move an integer's values array into the arena. If the integer has heap-
- * allocated values, copy them to the arena and free the original.
- */
-static PRISM_INLINE void
-pm_integer_arena_move(pm_arena_t *arena, pm_integer_t *integer) {
-    if (integer->values != NULL) {
-        size_t byte_size = integer->length * sizeof(uint32_t);
-        uint32_t *old_values = integer->values;
-        integer->values = (uint32_t *) pm_arena_memdup(arena, old_values, byte_size, PRISM_ALIGNOF(uint32_t));
-        xfree(old_values);
-    }
-}
-
 /**
  * Allocate a new ErrorRecoveryNode node with no unexpected child.
  */
 static pm_error_recovery_node_t *
 pm_error_recovery_node_create(pm_parser_t *parser, uint32_t start, uint32_t length) {
+    PM_PARSER_STATS_INCREMENT(parser, error_recovery_nodes);
     return pm_error_recovery_node_new(
         parser->arena,
         ++parser->node_id,
@@ -2341,6 +2350,7 @@ pm_error_recovery_node_create(pm_parser_t *parser, uint32_t start, uint32_t leng
  */
 static pm_error_recovery_node_t *
 pm_error_recovery_node_create_unexpected(pm_parser_t *parser, pm_node_t *unexpected) {
+    PM_PARSER_STATS_INCREMENT(parser, error_recovery_nodes);
     return pm_error_recovery_node_new(
         parser->arena,
         ++parser->node_id,
@@ -3226,7 +3236,7 @@ pm_call_write_read_name_init(pm_parser_t *parser, pm_constant_id_t *read_name, p
     if (write_constant->length > 0) {
         size_t length = write_constant->length - 1;
 
-        uint8_t *memory = (uint8_t *) pm_arena_alloc(parser->arena, length, 1);
+        uint8_t *memory = (uint8_t *) pm_arena_alloc(&parser->metadata_arena, length, 1);
         memcpy(memory, write_constant->start, length);
 
         *read_name = pm_constant_pool_insert_owned(&parser->metadata_arena, &parser->constant_pool, memory, length);
@@ -4285,7 +4295,7 @@ pm_float_node_rational_create(pm_parser_t *parser, const pm_token_t *token) {
 
     memcpy(digits, start, (unsigned long) (point - start));
     memcpy(digits + (point - start), point + 1, (unsigned long) (end - point - 1));
-    pm_integer_parse(&node->numerator, PM_INTEGER_BASE_DEFAULT, digits, digits + length - 1);
+    pm_integer_parse(parser->arena, &node->numerator, PM_INTEGER_BASE_DEFAULT, digits, digits + length - 1);
 
     size_t fract_length = 0;
     for (const uint8_t *fract = point; fract < end; ++fract) {
@@ -4293,12 +4303,10 @@ pm_float_node_rational_create(pm_parser_t *parser, const pm_token_t *token) {
     }
     digits[0] = '1';
     if (fract_length > 1) memset(digits + 1, '0', fract_length - 1);
-    pm_integer_parse(&node->denominator, PM_INTEGER_BASE_DEFAULT, digits, digits + fract_length);
+    pm_integer_parse(parser->arena, &node->denominator, PM_INTEGER_BASE_DEFAULT, digits, digits + fract_length);
     xfree_sized(digits, length);
 
     pm_integers_reduce(&node->numerator, &node->denominator);
-    pm_integer_arena_move(parser->arena, &node->numerator);
-    pm_integer_arena_move(parser->arena, &node->denominator);
     return node;
 }
 
@@ -4808,8 +4816,7 @@ pm_integer_node_create(pm_parser_t *parser, pm_node_flags_t base, const pm_token
             default: assert(false && "unreachable"); break;
         }
 
-        pm_integer_parse(&node->value, integer_base, token->start, token->end);
-        pm_integer_arena_move(parser->arena, &node->value);
+        pm_integer_parse(parser->arena, &node->value, integer_base, token->start, token->end);
     }
 
     return node;
@@ -4862,8 +4869,7 @@ pm_integer_node_rational_create(pm_parser_t *parser, pm_node_flags_t base, const
         default: assert(false && "unreachable"); break;
     }
 
-    pm_integer_parse(&node->numerator, integer_base, token->start, token->end - 1);
-    pm_integer_arena_move(parser->arena, &node->numerator);
+    pm_integer_parse(parser->arena, &node->numerator, integer_base, token->start, token->end - 1);
 
     return node;
 }
@@ -7247,6 +7253,8 @@ pm_yield_node_create(pm_parser_t *parser, const pm_token_t *keyword, const pm_lo
 static int
 pm_parser_local_depth_constant_id(pm_parser_t *parser, pm_constant_id_t constant_id) {
     pm_scope_t *scope = parser->current_scope;
+    if (scope == NULL || !(scope->visible_bloom & (1u << (constant_id & 31)))) return -1;
+
     int depth = 0;
 
     while (scope != NULL) {
@@ -7276,6 +7284,7 @@ pm_parser_local_depth(pm_parser_t *parser, pm_token_t *token) {
 static PRISM_INLINE void
 pm_parser_local_add(pm_parser_t *parser, pm_constant_id_t constant_id, const uint8_t *start, const uint8_t *end, uint32_t reads) {
     pm_locals_write(&parser->current_scope->locals, constant_id, U32(start - parser->start), U32(end - start), reads);
+    parser->current_scope->visible_bloom |= parser->current_scope->locals.bloom;
 }
 
 /**
@@ -7554,6 +7563,156 @@ next_newline(const uint8_t *cursor, ptrdiff_t length) {
     return memchr(cursor, '\n', (size_t) length);
 }
 
+/**
+ * Finish the search for the end of a comment one byte at a time, once fewer
+ * than a block's worth of bytes remain.
+ */
+static PRISM_INLINE const uint8_t *
+next_comment_newline_tail(const uint8_t *cursor, const uint8_t *end, bool found, bool *magic) {
+    for (; cursor < end; cursor++) {
+        if (*cursor == '\n') {
+            *magic = found;
+            return cursor;
+        }
+
+        if (*cursor == ':' || *cursor == '*') found = true;
+    }
+
+    *magic = found;
+    return NULL;
+}
+
+#if defined(PRISM_HAS_NEON)
+
+/**
+ * Find the newline that ends the comment starting at the given cursor, or NULL
+ * if the comment runs to the end of the source. Every magic comment contains a
+ * ':' between its key and value or a '*' in the middle of an emacs-style -*-
+ * marker, so the same pass also checks for those. If neither appears before
+ * the newline, magic is set to false and the comment does not need to be
+ * checked for being a magic comment.
+ *
+ * Like next_newline, this looks at bytes rather than characters. A ':' or '*'
+ * that is part of a multibyte character only costs an unnecessary check.
+ *
+ * This variant checks 16 bytes at a time with NEON.
+ */
+static PRISM_INLINE const uint8_t *
+next_comment_newline(const uint8_t *cursor, const uint8_t *end, bool *magic) {
+    bool found = false;
+
+    for (; cursor + 16 <= end; cursor += 16) {
+        uint8x16_t block = vld1q_u8(cursor);
+        uint8x16_t newline = vceqq_u8(block, vdupq_n_u8('\n'));
+        uint8x16_t marker = vorrq_u8(vceqq_u8(block, vdupq_n_u8(':')), vceqq_u8(block, vdupq_n_u8('*')));
+
+        if (vmaxvq_u8(newline) != 0) {
+            // Narrow each byte of the masks to four bits to find the newline
+            // and whether a marker comes before it.
+            uint64_t newlines = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(newline), 4)), 0);
+            uint64_t markers = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(marker), 4)), 0);
+            unsigned index = pm_ctzll(newlines);
+
+            *magic = found || (markers & ((1ULL << index) - 1)) != 0;
+            return cursor + index / 4;
+        }
+
+        found |= vmaxvq_u8(marker) != 0;
+    }
+
+    return next_comment_newline_tail(cursor, end, found, magic);
+}
+
+#elif defined(PRISM_HAS_SSE2)
+#include <emmintrin.h>
+
+/**
+ * Find the newline that ends the comment starting at the given cursor, or NULL
+ * if the comment runs to the end of the source, and set magic to whether a ':'
+ * or '*' appears before it. This variant checks 16 bytes at a time with SSE2.
+ */
+static PRISM_INLINE const uint8_t *
+next_comment_newline(const uint8_t *cursor, const uint8_t *end, bool *magic) {
+    bool found = false;
+
+    for (; cursor + 16 <= end; cursor += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) cursor);
+        unsigned newlines = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+        unsigned markers = (unsigned) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(':')), _mm_cmpeq_epi8(block, _mm_set1_epi8('*'))));
+
+        if (newlines != 0) {
+            unsigned index = pm_ctzll(newlines);
+
+            *magic = found || (markers & ((1U << index) - 1)) != 0;
+            return cursor + index;
+        }
+
+        found |= markers != 0;
+    }
+
+    return next_comment_newline_tail(cursor, end, found, magic);
+}
+
+#elif defined(PRISM_HAS_SWAR)
+
+/**
+ * Returns a word with the high bit of each byte set if and only if that byte of
+ * the given word is equal to the given byte. Unlike the cheaper "has zero byte"
+ * idiom, this cannot produce false positives from borrows, so the positions of
+ * the bits can be compared.
+ */
+static PRISM_INLINE uint64_t
+next_comment_newline_match(uint64_t word, uint8_t byte) {
+    static const uint64_t lows = 0x7F7F7F7F7F7F7F7FULL;
+    uint64_t xored = word ^ (0x0101010101010101ULL * byte);
+    return ~(((xored & lows) + lows) | xored | lows);
+}
+
+/**
+ * Find the newline that ends the comment starting at the given cursor, or NULL
+ * if the comment runs to the end of the source, and set magic to whether a ':'
+ * or '*' appears before it. This variant checks 8 bytes at a time with SWAR.
+ */
+static PRISM_INLINE const uint8_t *
+next_comment_newline(const uint8_t *cursor, const uint8_t *end, bool *magic) {
+    bool found = false;
+
+    for (; cursor + 8 <= end; cursor += 8) {
+        uint64_t word;
+        memcpy(&word, cursor, 8);
+
+        uint64_t newlines = next_comment_newline_match(word, '\n');
+        uint64_t markers = next_comment_newline_match(word, ':') | next_comment_newline_match(word, '*');
+
+        if (newlines != 0) {
+            unsigned index = pm_ctzll(newlines);
+
+            *magic = found || (markers & ((1ULL << index) - 1)) != 0;
+            return cursor + index / 8;
+        }
+
+        found |= markers != 0;
+    }
+
+    return next_comment_newline_tail(cursor, end, found, magic);
+}
+
+#else
+
+/**
+ * Find the newline that ends the comment starting at the given cursor, or NULL
+ * if the comment runs to the end of the source. Without SIMD or a
+ * little-endian word layout the search is left to memchr, and every comment is
+ * checked for being a magic comment.
+ */
+static PRISM_INLINE const uint8_t *
+next_comment_newline(const uint8_t *cursor, const uint8_t *end, bool *magic) {
+    *magic = true;
+    return next_newline(cursor, end - cursor);
+}
+
+#endif
+
 /**
  * This is equivalent to the predicate of warn_balanced in CRuby.
  */
@@ -8573,7 +8732,13 @@ lex_identifier(pm_parser_t *parser, bool previous_command_start) {
         // Fast path: scan ASCII identifier bytes using wide operations.
         current_end += scan_identifier_ascii(current_end, end);
 
-        // Byte-at-a-time fallback for the tail and any UTF-8 sequences.
+        // Identifiers with multibyte characters in them are validated in
+        // blocks as well, which also covers any ASCII that follows them.
+        if (current_end < end && *current_end >= 0x80) {
+            current_end += pm_encoding_utf_8_identifier_length(current_end, (size_t) (end - current_end));
+        }
+
+        // Byte-at-a-time fallback for the tail of ASCII identifiers.
         while ((width = char_is_identifier_utf8(current_end, end - current_end)) > 0) {
             current_end += width;
         }
@@ -9656,6 +9821,8 @@ lex_at_variable(pm_parser_t *parser) {
  */
 static PRISM_INLINE void
 parser_lex_callback(pm_parser_t *parser) {
+    PM_PARSER_STATS_INCREMENT(parser, tokens[parser->current.type]);
+
     if (parser->lex_callback.callback) {
         parser->lex_callback.callback(parser, &parser->current, parser->lex_callback.data);
     }
@@ -9696,9 +9863,10 @@ lex_embdoc(pm_parser_t *parser) {
     parser->current.type = PM_TOKEN_EMBDOC_BEGIN;
     parser_lex_callback(parser);
 
-    // Now, create a comment that is going to be attached to the parser.
+    // Now, create a comment that is going to be attached to the parser, unless
+    // the parser is discarding comments.
     const uint8_t *comment_start = parser->current.start;
-    pm_comment_t *comment = parser_comment(parser, PM_COMMENT_EMBDOC);
+    pm_comment_t *comment = parser->discard_comments ? NULL : parser_comment(parser, PM_COMMENT_EMBDOC);
 
     // Now, loop until we find the end of the embedded documentation or the end
     // of the file.
@@ -9729,8 +9897,10 @@ lex_embdoc(pm_parser_t *parser) {
             parser->current.type = PM_TOKEN_EMBDOC_END;
             parser_lex_callback(parser);
 
-            comment->location.length = (uint32_t) (parser->current.end - comment_start);
-            pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+            if (comment != NULL) {
+                comment->location.length = (uint32_t) (parser->current.end - comment_start);
+                pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+            }
 
             return PM_TOKEN_EMBDOC_END;
         }
@@ -9752,8 +9922,10 @@ lex_embdoc(pm_parser_t *parser) {
 
     pm_parser_err_current(parser, PM_ERR_EMBDOC_TERM);
 
-    comment->location.length = (uint32_t) (parser->current.end - comment_start);
-    pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+    if (comment != NULL) {
+        comment->location.length = (uint32_t) (parser->current.end - comment_start);
+        pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+    }
 
     return PM_TOKEN_EOF;
 }
@@ -10076,6 +10248,11 @@ pm_lex_percent_delimiter(pm_parser_t *parser) {
  */
 #define LEX(token_type) parser->current.type = token_type; parser_lex_callback(parser); return
 
+#if defined(PRISM_STATS) && defined(PRISM_STATS_LEX_TIME)
+/* When timing the lexer, it is wrapped so that each token can be timed. */
+#define parser_lex parser_lex_untimed
+#endif
+
 /**
  * Called when the parser requires a new token. The parser maintains a moving
  * window of two tokens at a time: parser.previous and parser.current. This
@@ -10087,6 +10264,15 @@ parser_lex(pm_parser_t *parser) {
     assert(parser->current.end <= parser->end);
     parser->previous = parser->current;
 
+    // Once enough errors have been found, skip to the end of the source so that
+    // every open construct is closed as if the source ended here. This is
+    // checked on every token, since closing a heredoc moves the lexer back.
+    if (parser->error_limit != 0 && parser->error_list.size >= parser->error_limit) {
+        parser->current.end = parser->end;
+        parser->next_start = NULL;
+        parser->heredoc_end = NULL;
+    }
+
     // This value mirrors cmd_state from CRuby.
     bool previous_command_start = parser->command_start;
     parser->command_start = false;
@@ -10219,21 +10405,24 @@ parser_lex(pm_parser_t *parser) {
                     LEX(PM_TOKEN_EOF);
 
                 case '#': { // comments
-                    const uint8_t *ending = next_newline(parser->current.end, parser->end - parser->current.end);
+                    bool magic;
+                    const uint8_t *ending = next_comment_newline(parser->current.end, parser->end, &magic);
                     parser->current.end = ending == NULL ? parser->end : ending;
 
                     // If we found a comment while lexing, then we're going to
                     // add it to the list of comments in the file and keep
                     // lexing.
-                    pm_comment_t *comment = parser_comment(parser, PM_COMMENT_INLINE);
-                    pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+                    if (!parser->discard_comments) {
+                        pm_comment_t *comment = parser_comment(parser, PM_COMMENT_INLINE);
+                        pm_list_append(&parser->comment_list, (pm_list_node_t *) comment);
+                    }
 
                     parser->current.type = PM_TOKEN_COMMENT;
                     parser_lex_callback(parser);
 
                     // Here, parse the comment to see if it's a magic comment
                     // and potentially change state on the parser.
-                    if (!parser_lex_magic_comment(parser, semantic_token_seen) && (parser->current.start == parser->encoding_comment_start)) {
+                    if (!(magic && parser_lex_magic_comment(parser, semantic_token_seen)) && (parser->current.start == parser->encoding_comment_start)) {
                         ptrdiff_t length = parser->current.end - parser->current.start;
 
                         // If we didn't find a magic comment within the first
@@ -12565,6 +12754,20 @@ parser_lex(pm_parser_t *parser) {
 
 #undef LEX
 
+#if defined(PRISM_STATS) && defined(PRISM_STATS_LEX_TIME)
+#undef parser_lex
+
+/**
+ * Lex the next token, adding the time it took to the parser's statistics.
+ */
+static void
+parser_lex(pm_parser_t *parser) {
+    uint64_t start = pm_parser_stats_time();
+    parser_lex_untimed(parser);
+    parser->stats.lex_time += pm_parser_stats_time() - start;
+}
+#endif
+
 /******************************************************************************/
 /* Parse functions                                                            */
 /******************************************************************************/
@@ -13132,7 +13335,7 @@ parse_write_name(pm_parser_t *parser, pm_constant_id_t *name_field) {
     // append an =.
     pm_constant_t *constant = pm_constant_pool_id_to_constant(&parser->constant_pool, *name_field);
     size_t length = constant->length;
-    uint8_t *name = (uint8_t *) pm_arena_alloc(parser->arena, length + 1, 1);
+    uint8_t *name = (uint8_t *) pm_arena_alloc(&parser->metadata_arena, length + 1, 1);
 
     memcpy(name, constant->start, length);
     name[length] = '=';
@@ -13652,6 +13855,72 @@ parse_targets_validate(pm_parser_t *parser, pm_node_t *first_target, pm_binding_
     return result;
 }
 
+/**
+ * Returns true if the given statement ends the flow of control through a list
+ * of statements, so that the statement after it is unreachable.
+ */
+static PRISM_INLINE bool
+pm_statement_jump_p(const pm_node_t *node) {
+    switch (PM_NODE_TYPE(node)) {
+        case PM_BREAK_NODE:
+        case PM_NEXT_NODE:
+        case PM_REDO_NODE:
+        case PM_RETRY_NODE:
+        case PM_RETURN_NODE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * When only checking syntax, the last statement that was appended to the given
+ * list can be released once another statement is known to follow it, as long
+ * as nothing outside of it can still refer to its nodes. The first statement is
+ * always kept so that the list still tells one statement from several, and the
+ * list itself must not have been moved by the append, since the move happened
+ * after the given nodes were read.
+ */
+static bool
+parse_statements_releasable(const pm_parser_t *parser, const pm_statements_node_t *statements, pm_node_t *const *nodes) {
+    if (!parser->syntax_check || statements->body.size < 2 || statements->body.nodes != nodes) return false;
+
+    // The statement after a jump is warned about as unreachable when it is
+    // appended, which needs the jump to still be the one before it.
+    if (pm_statement_jump_p(nodes[statements->body.size - 1]) || pm_statement_jump_p(nodes[statements->body.size - 2])) return false;
+
+    // Block exits and implicit parameters are checked when the block or loop
+    // that contains them closes, so they must stay until then.
+    if (parser->current_block_exits != NULL && parser->current_block_exits->size > 0) return false;
+    if (parser->current_scope->implicit_parameters.size > 0) return false;
+
+    // The token after the statement has already been lexed, and its unescaped
+    // contents may have been copied out of the source after the statement.
+    const uint8_t *contents = pm_string_source(&parser->current_string);
+    return pm_string_length(&parser->current_string) == 0 || (contents >= parser->start && contents <= parser->end);
+}
+
+/**
+ * Release the last statement in the given list, which was parsed after the
+ * given mark was taken. It is checked as a statement whose value is unused
+ * first, since it will not be in the list when the list is checked.
+ */
+static void
+parse_statements_release(pm_parser_t *parser, pm_statements_node_t *statements, pm_arena_mark_t mark) {
+    pm_void_statement_check(parser, statements->body.nodes[--statements->body.size]);
+    pm_arena_rewind(parser->arena, mark);
+
+    // Any of these may have been allocated while the statement was parsed, and
+    // are empty now that it is done, so they are dropped instead of rewound.
+    if (parser->current_block_exits != NULL) *parser->current_block_exits = (pm_node_list_t) { 0 };
+    parser->current_scope->implicit_parameters = (pm_node_list_t) { 0 };
+
+    // Released nodes can be handed out again, so forget any cached results
+    // that are keyed on them.
+    parser->value_expression.node = NULL;
+    parser->command_call_value.node = NULL;
+}
+
 /**
  * Parse a list of statements separated by newlines or semicolons.
  */
@@ -13671,6 +13940,9 @@ parse_statements(pm_parser_t *parser, pm_context_t context, uint16_t depth) {
     context_push(parser, context);
 
     while (true) {
+        pm_arena_mark_t mark = pm_arena_mark(parser->arena);
+        pm_node_t *const *nodes = statements->body.nodes;
+
         pm_node_t *node = parse_expression(parser, PM_BINDING_POWER_STATEMENT, PM_PARSE_ACCEPTS_COMMAND_CALL | PM_PARSE_ACCEPTS_DO_BLOCK, PM_ERR_CANNOT_PARSE_EXPRESSION, (uint16_t) (depth + 1));
         pm_statements_node_body_append(parser, statements, node, true);
 
@@ -13691,6 +13963,9 @@ parse_statements(pm_parser_t *parser, pm_context_t context, uint16_t depth) {
             while (accept2(parser, PM_TOKEN_NEWLINE, PM_TOKEN_SEMICOLON));
             if (context_terminator(context, &parser->current)) break;
 
+            // Another statement follows, so this one is done.
+            if (parse_statements_releasable(parser, statements, nodes)) parse_statements_release(parser, statements, mark);
+
             // Now we can continue parsing the list of statements.
             continue;
         }
@@ -13719,6 +13994,7 @@ parse_statements(pm_parser_t *parser, pm_context_t context, uint16_t depth) {
             // recovering, as we know that EOF closes the top-level context, and
             // then break out of the loop.
             if (match1(parser, PM_TOKEN_EOF)) {
+                PM_PARSER_STATS_INCREMENT(parser, recoveries);
                 parser->recovering = true;
                 break;
             }
@@ -13990,13 +14266,15 @@ pm_constant_path_command_call_p(const pm_parser_t *parser, const pm_call_node_t
     );
 }
 
+static bool
+pm_command_call_value_p(pm_parser_t *parser, const pm_node_t *node);
+
 /**
- * Returns true if the given node is a command-style call (a method call without
- * parentheses that has arguments), excluding operator calls (e.g., a + b) which
- * satisfy the same structural criteria but are not commands.
+ * Check whether the given node is a command call value, without consulting or
+ * updating the cached result for the last node that was checked.
  */
 static bool
-pm_command_call_value_p(const pm_parser_t *parser, const pm_node_t *node) {
+pm_command_call_value_check(pm_parser_t *parser, const pm_node_t *node) {
     switch (PM_NODE_TYPE(node)) {
         case PM_CALL_NODE: {
             const pm_call_node_t *call = (const pm_call_node_t *) node;
@@ -14015,6 +14293,7 @@ pm_command_call_value_p(const pm_parser_t *parser, const pm_node_t *node) {
             /* A `!` or `not` prefix wrapping a command call (e.g., `!foo bar`,
              * `not foo bar`) is also a command-call value. */
             if (call->receiver != NULL && call->arguments == NULL && call->opening_loc.length == 0 && call->call_operator_loc.length == 0) {
+                if (call->receiver == parser->command_call_value.node) return parser->command_call_value.value;
                 return pm_command_call_value_p(parser, call->receiver);
             }
 
@@ -14051,6 +14330,21 @@ pm_command_call_value_p(const pm_parser_t *parser, const pm_node_t *node) {
     }
 }
 
+/**
+ * Returns true if the given node is a command-style call (a method call without
+ * parentheses that has arguments), excluding operator calls (e.g., a + b) which
+ * satisfy the same structural criteria but are not commands. The result is
+ * remembered for the node so that a chain of unary operators wrapping it does
+ * not need to walk back down to it.
+ */
+static bool
+pm_command_call_value_p(pm_parser_t *parser, const pm_node_t *node) {
+    bool value = pm_command_call_value_check(parser, node);
+    parser->command_call_value.node = node;
+    parser->command_call_value.value = value;
+    return value;
+}
+
 /**
  * Returns true if the given node is a block call: a command
  * with a do-block, or any call chained (via `.`, `::`, `&.`) from such a node.
@@ -16349,6 +16643,7 @@ parse_symbol(pm_parser_t *parser, pm_lex_mode_t *lex_mode, pm_lex_state_t next_s
     if (match1(parser, PM_TOKEN_STRING_CONTENT)) {
         content = parser->current;
         unescaped = parser->current_string;
+        parser->current_string = PM_STRING_EMPTY;
         parser_lex(parser);
 
         // If we have two string contents in a row, then the content of this
@@ -16636,7 +16931,7 @@ parse_heredoc_dedent(pm_parser_t *parser, pm_node_list_t *nodes, size_t common_w
 
     // Iterate over all nodes, and trim whitespace accordingly. We're going to
     // keep around two indices: a read and a write.
-    size_t write_index = 0;
+    pm_node_list_size_t write_index = 0;
 
     pm_node_t *node;
     PM_NODE_LIST_FOREACH(nodes, read_index, node) {
@@ -16725,6 +17020,7 @@ parse_strings(pm_parser_t *parser, pm_node_t *current, bool accepts_label, uint1
                 content = (pm_token_t) { .type = PM_TOKEN_STRING_CONTENT, .start = parser->start, .end = parser->start };
             } else {
                 unescaped = parser->current_string;
+                parser->current_string = PM_STRING_EMPTY;
                 expect1(parser, PM_TOKEN_STRING_CONTENT, PM_ERR_EXPECT_STRING_CONTENT);
                 content = parser->previous;
             }
@@ -16774,6 +17070,7 @@ parse_strings(pm_parser_t *parser, pm_node_t *current, bool accepts_label, uint1
             // plain string) or if it's not then it has interpolation.
             pm_token_t content = parser->current;
             pm_string_t unescaped = parser->current_string;
+            parser->current_string = PM_STRING_EMPTY;
             const pm_encoding_t *explicit_encoding = parser->explicit_encoding;
             parser_lex(parser);
 
@@ -16890,22 +17187,20 @@ parse_strings(pm_parser_t *parser, pm_node_t *current, bool accepts_label, uint1
 #define PM_PARSE_PATTERN_MULTI 2
 
 static pm_node_t *
-parse_pattern(pm_parser_t *parser, pm_constant_id_list_t *captures, uint8_t flags, pm_diagnostic_id_t diag_id, uint16_t depth);
+parse_pattern(pm_parser_t *parser, pm_constant_id_set_t *captures, uint8_t flags, pm_diagnostic_id_t diag_id, uint16_t depth);
 
 /**
- * Add the newly created local to the list of captures for this pattern matching
+ * Add the newly created local to the set of captures for this pattern matching
  * expression. If it is duplicated from a previous local, then we'll need to add
  * an error to the parser.
  */
 static void
-parse_pattern_capture(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_constant_id_t capture, const pm_location_t *location) {
+parse_pattern_capture(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_constant_id_t capture, const pm_location_t *location) {
     // Skip this capture if it starts with an underscore.
     if (peek_at(parser, parser->start + location->start) == '_') return;
 
-    if (pm_constant_id_list_includes(captures, capture)) {
+    if (!pm_constant_id_set_add(&parser->metadata_arena, captures, capture)) {
         pm_parser_err(parser, location->start, location->length, PM_ERR_PATTERN_CAPTURE_DUPLICATE);
-    } else {
-        pm_constant_id_list_append(parser->arena, captures, capture);
     }
 }
 
@@ -16913,7 +17208,7 @@ parse_pattern_capture(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_c
  * Accept any number of constants joined by :: delimiters.
  */
 static pm_node_t *
-parse_pattern_constant_path(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_node_t *node, uint16_t depth) {
+parse_pattern_constant_path(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_node_t *node, uint16_t depth) {
     // Now, if there are any :: operators that follow, parse them as constant
     // path nodes.
     while (accept1(parser, PM_TOKEN_COLON_COLON)) {
@@ -17033,7 +17328,7 @@ parse_pattern_constant_path(pm_parser_t *parser, pm_constant_id_list_t *captures
  * Parse a rest pattern.
  */
 static pm_splat_node_t *
-parse_pattern_rest(pm_parser_t *parser, pm_constant_id_list_t *captures) {
+parse_pattern_rest(pm_parser_t *parser, pm_constant_id_set_t *captures) {
     assert(parser->previous.type == PM_TOKEN_USTAR);
     pm_token_t operator = parser->previous;
     pm_node_t *name = NULL;
@@ -17067,7 +17362,7 @@ parse_pattern_rest(pm_parser_t *parser, pm_constant_id_list_t *captures) {
  * Parse a keyword rest node.
  */
 static pm_node_t *
-parse_pattern_keyword_rest(pm_parser_t *parser, pm_constant_id_list_t *captures) {
+parse_pattern_keyword_rest(pm_parser_t *parser, pm_constant_id_set_t *captures) {
     assert(parser->current.type == PM_TOKEN_USTAR_STAR);
     parser_lex(parser);
 
@@ -17131,7 +17426,7 @@ pm_slice_is_valid_local(const pm_parser_t *parser, const uint8_t *start, const u
  * value. This will use an implicit local variable target.
  */
 static pm_node_t *
-parse_pattern_hash_implicit_value(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_symbol_node_t *key) {
+parse_pattern_hash_implicit_value(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_symbol_node_t *key) {
     const pm_location_t *value_loc = &((pm_symbol_node_t *) key)->value_loc;
     const uint8_t *start = parser->start + PM_LOCATION_START(value_loc);
     const uint8_t *end = parser->start + PM_LOCATION_END(value_loc);
@@ -17179,7 +17474,7 @@ parse_pattern_hash_key(pm_parser_t *parser, pm_static_literals_t *keys, pm_node_
  * Parse a hash pattern.
  */
 static pm_hash_pattern_node_t *
-parse_pattern_hash(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_node_t *first_node, uint16_t depth) {
+parse_pattern_hash(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_node_t *first_node, uint16_t depth) {
     pm_node_list_t assocs = { 0 };
     pm_static_literals_t keys = { 0 };
     pm_node_t *rest = NULL;
@@ -17322,7 +17617,7 @@ parse_pattern_hash(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_node
  * Parse a pattern expression primitive.
  */
 static pm_node_t *
-parse_pattern_primitive(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_diagnostic_id_t diag_id, uint16_t depth) {
+parse_pattern_primitive(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_diagnostic_id_t diag_id, uint16_t depth) {
     switch (parser->current.type) {
         case PM_TOKEN_IDENTIFIER:
         case PM_TOKEN_METHOD_NAME: {
@@ -17607,7 +17902,7 @@ parse_pattern_alternation_error(pm_parser_t *parser, const pm_node_t *node) {
  * assignment.
  */
 static pm_node_t *
-parse_pattern_primitives(pm_parser_t *parser, pm_constant_id_list_t *captures, pm_node_t *first_node, pm_diagnostic_id_t diag_id, uint16_t depth) {
+parse_pattern_primitives(pm_parser_t *parser, pm_constant_id_set_t *captures, pm_node_t *first_node, pm_diagnostic_id_t diag_id, uint16_t depth) {
     pm_node_t *node = first_node;
     bool alternation = false;
 
@@ -17706,7 +18001,7 @@ parse_pattern_primitives(pm_parser_t *parser, pm_constant_id_list_t *captures, p
  * Parse a pattern matching expression.
  */
 static pm_node_t *
-parse_pattern(pm_parser_t *parser, pm_constant_id_list_t *captures, uint8_t flags, pm_diagnostic_id_t diag_id, uint16_t depth) {
+parse_pattern(pm_parser_t *parser, pm_constant_id_set_t *captures, uint8_t flags, pm_diagnostic_id_t diag_id, uint16_t depth) {
     pm_node_t *node = NULL;
 
     bool leading_rest = false;
@@ -18240,7 +18535,7 @@ parse_case(pm_parser_t *parser, uint8_t flags, uint16_t depth) {
 
             pm_token_t in_keyword = parser->previous;
 
-            pm_constant_id_list_t captures = { 0 };
+            pm_constant_id_set_t captures = { 0 };
             pm_node_t *pattern = parse_pattern(parser, &captures, PM_PARSE_PATTERN_TOP | PM_PARSE_PATTERN_MULTI, PM_ERR_PATTERN_EXPRESSION_AFTER_IN, (uint16_t) (depth + 1));
 
             parser->pattern_matching_newlines = previous_pattern_matching_newlines;
@@ -19803,7 +20098,12 @@ parse_expression_prefix(pm_parser_t *parser, pm_binding_power_t binding_power, u
             pm_heredoc_lex_mode_t lex_mode = parser->lex_modes.current->as.heredoc.base;
 
             size_t common_whitespace = (size_t) -1;
-            parser->lex_modes.current->as.heredoc.common_whitespace = &common_whitespace;
+            pm_lex_mode_t *whitespace_mode = parser->lex_modes.current;
+            whitespace_mode->as.heredoc.common_whitespace = &common_whitespace;
+
+            size_t whitespace_index = parser->lex_modes.index;
+            size_t whitespace_floor = parser->lex_modes.floor;
+            parser->lex_modes.floor = whitespace_index;
 
             parser_lex(parser);
             pm_token_t opening = parser->previous;
@@ -19906,14 +20206,18 @@ parse_expression_prefix(pm_parser_t *parser, pm_binding_power_t binding_power, u
             /* If a missing terminator left this heredoc's lex mode on the
              * stack, it still points at our stack-local common_whitespace.
              * Clear the pointer so that subsequent lexing cannot read from
-             * this function's dead stack frame. */
-            pm_lex_mode_t *whitespace_mode = parser->lex_modes.current;
-            do {
-                if (whitespace_mode->mode == PM_LEX_HEREDOC && whitespace_mode->as.heredoc.common_whitespace == &common_whitespace) {
-                    whitespace_mode->as.heredoc.common_whitespace = NULL;
-                }
-                whitespace_mode = whitespace_mode->prev;
-            } while (whitespace_mode != NULL);
+             * this function's dead stack frame. Only the lex mode that was
+             * current when we started can hold it, and it is still on the
+             * stack exactly when the stack has not been popped below it. This
+             * avoids walking the stack, which would make deeply nested
+             * heredocs quadratic. */
+            if (parser->lex_modes.floor >= whitespace_index && whitespace_mode->as.heredoc.common_whitespace == &common_whitespace) {
+                whitespace_mode->as.heredoc.common_whitespace = NULL;
+            }
+
+            if (whitespace_floor < parser->lex_modes.floor) {
+                parser->lex_modes.floor = whitespace_floor;
+            }
 
             if (match1(parser, PM_TOKEN_STRING_BEGIN)) {
                 return parse_strings(parser, node, false, (uint16_t) (depth + 1));
@@ -20600,6 +20904,7 @@ parse_expression_prefix(pm_parser_t *parser, pm_binding_power_t binding_power, u
                 // following token is the end (in which case we can return a plain
                 // regular expression) or if it's not then it has interpolation.
                 pm_string_t unescaped = parser->current_string;
+                parser->current_string = PM_STRING_EMPTY;
                 pm_token_t content = parser->current;
                 parser_lex(parser);
 
@@ -20691,6 +20996,7 @@ parse_expression_prefix(pm_parser_t *parser, pm_binding_power_t binding_power, u
                 // following token is the end (in which case we can return a
                 // plain string) or if it's not then it has interpolation.
                 pm_string_t unescaped = parser->current_string;
+                parser->current_string = PM_STRING_EMPTY;
                 pm_token_t content = parser->current;
                 parser_lex(parser);
 
@@ -20946,6 +21252,7 @@ parse_expression_prefix(pm_parser_t *parser, pm_binding_power_t binding_power, u
             pm_context_t recoverable = context_recoverable(parser, &parser->current);
 
             if (recoverable != PM_CONTEXT_NONE) {
+                PM_PARSER_STATS_INCREMENT(parser, recoveries);
                 parser->recovering = true;
 
                 // If the given error is not the generic one, then we'll add it
@@ -21403,7 +21710,7 @@ pm_named_capture_escape(pm_parser_t *parser, pm_buffer_t *unescaped, const uint8
 static void
 parse_regular_expression_named_capture(pm_parser_t *parser, const pm_string_t *capture, bool shared, pm_regexp_name_data_t *callback_data) {
     pm_call_node_t *call = callback_data->call;
-    pm_constant_id_list_t *names = &callback_data->names;
+    pm_constant_id_set_t *names = &callback_data->names;
 
     const uint8_t *source = pm_string_source(capture);
     size_t length = pm_string_length(capture);
@@ -21447,16 +21754,14 @@ parse_regular_expression_named_capture(pm_parser_t *parser, const pm_string_t *c
         start = parser->start + PM_NODE_START(call->receiver);
         end = parser->start + PM_NODE_END(call->receiver);
 
-        uint8_t *memory = (uint8_t *) pm_arena_alloc(parser->arena, length, 1);
+        uint8_t *memory = (uint8_t *) pm_arena_alloc(&parser->metadata_arena, length, 1);
         memcpy(memory, source, length);
         name = pm_parser_constant_id_owned(parser, memory, length);
     }
 
     // Add this name to the list of constants if it is valid, not duplicated,
     // and not a keyword.
-    if (name != 0 && !pm_constant_id_list_includes(names, name)) {
-        pm_constant_id_list_append(parser->arena, names, name);
-
+    if (name != 0 && pm_constant_id_set_add(&parser->metadata_arena, names, name)) {
         int depth;
         if ((depth = pm_parser_local_depth_constant_id(parser, name)) == -1) {
             // If the local is not already a local but it is a keyword, then we
@@ -22402,7 +22707,7 @@ parse_expression_infix(pm_parser_t *parser, pm_node_t *node, pm_binding_power_t
             lex_state_set(parser, PM_LEX_STATE_BEG | PM_LEX_STATE_LABEL);
             parser_lex(parser);
 
-            pm_constant_id_list_t captures = { 0 };
+            pm_constant_id_set_t captures = { 0 };
             pm_node_t *pattern = parse_pattern(parser, &captures, PM_PARSE_PATTERN_TOP | PM_PARSE_PATTERN_MULTI, PM_ERR_PATTERN_EXPRESSION_AFTER_IN, (uint16_t) (depth + 1));
 
             parser->pattern_matching_newlines = previous_pattern_matching_newlines;
@@ -22418,7 +22723,7 @@ parse_expression_infix(pm_parser_t *parser, pm_node_t *node, pm_binding_power_t
             lex_state_set(parser, PM_LEX_STATE_BEG | PM_LEX_STATE_LABEL);
             parser_lex(parser);
 
-            pm_constant_id_list_t captures = { 0 };
+            pm_constant_id_set_t captures = { 0 };
             pm_node_t *pattern = parse_pattern(parser, &captures, PM_PARSE_PATTERN_TOP | PM_PARSE_PATTERN_MULTI, PM_ERR_PATTERN_EXPRESSION_AFTER_HROCKET, (uint16_t) (depth + 1));
 
             parser->pattern_matching_newlines = previous_pattern_matching_newlines;
@@ -22898,6 +23203,7 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
         .accepts_block_stack = 0,
         .lex_modes = {
             .index = 0,
+            .floor = 0,
             .stack = {{ .mode = PM_LEX_DEFAULT }},
             .current = &parser->lex_modes.stack[0],
         },
@@ -22908,18 +23214,25 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
         .next_start = NULL,
         .heredoc_end = NULL,
         .data_loc = { 0 },
+        .reparsed_loc = { .start = 0, .length = U32(size) },
+        .reparsed_size = 0,
         .comment_list = { 0 },
         .magic_comment_list = { 0 },
         .warning_list = { 0 },
         .error_list = { 0 },
+        .error_limit = 0,
         .current_scope = NULL,
         .current_context = NULL,
+        .current_hash_keys = NULL,
+        .value_expression = { 0 },
+        .command_call_value = { 0 },
         .encoding = PM_ENCODING_UTF_8_ENTRY,
         .encoding_changed_callback = NULL,
         .encoding_comment_start = source,
         .lex_callback = { 0 },
         .filepath = { 0 },
         .constant_pool = { 0 },
+        .shared_constant_pool = NULL,
         .line_offsets = { 0 },
         .integer = { 0 },
         .current_string = PM_STRING_EMPTY,
@@ -22928,9 +23241,17 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
         .command_line = 0,
         .parsing_eval = false,
         .partial_script = false,
+        .attach_comments = false,
+        .mark_newlines = false,
+        .source_strings = false,
+        .discard_comments = false,
+        .syntax_check = false,
         .command_start = true,
         .recovering = false,
         .continuable = true,
+        .first_non_ascii = 0,
+        .encoding_validity = PM_ENCODING_VALIDITY_UNKNOWN,
+        .encoding_scanned = false,
         .encoding_locked = false,
         .encoding_changed = false,
         .pattern_matching_newlines = false,
@@ -22945,8 +23266,10 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
      * allocations (and the kernel page zeroing they trigger). The ratios were
      * measured empirically: AST arena ~3.3x input, metadata arena ~1.1x input.
      * The reserve call is a no-op when the capacity is at or below the default
-     * arena block size, so small inputs don't waste an extra allocation. */
-    if (size <= SIZE_MAX / 4) pm_arena_reserve(arena, size * 4);
+     * arena block size, so small inputs don't waste an extra allocation. When
+     * only checking syntax, the AST arena is reused statement by statement, so
+     * it is not pre-sized. */
+    if ((options == NULL || !options->syntax_check) && size <= SIZE_MAX / 4) pm_arena_reserve(arena, size * 4);
     if (size <= SIZE_MAX / 5 * 4) pm_arena_reserve(&parser->metadata_arena, size + size / 4);
 
     /* Initialize the constant pool. Measured across 1532 Ruby stdlib files, the
@@ -22959,8 +23282,11 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
 
     /* Initialize the line offset list. Similar to the constant pool, we are
      * going to estimate the number of newlines that we will need based on the
-     * size of the input. */
-    size_t newline_size = size / 22;
+     * size of the input. For large inputs, the estimate can be far off (think
+     * of generated files with very long or very short lines) and every miss
+     * copies the whole list, so instead we count the line feeds up front. The
+     * count is vectorized and costs a small fraction of the parse. */
+    size_t newline_size = (size >= PRISM_LINE_OFFSET_PRESCAN_SIZE) ? pm_newline_count(source, size) + 1 : size / 22;
     pm_line_offset_list_init(&parser->metadata_arena, &parser->line_offsets, newline_size < 4 ? 4 : newline_size);
 
     // If options were provided to this parse, establish them here.
@@ -22993,6 +23319,31 @@ pm_parser_init(pm_arena_t *arena, pm_parser_t *parser, const uint8_t *source, si
         // partial_script
         parser->partial_script = options->partial_script;
 
+        // attach_comments option
+        parser->attach_comments = options->attach_comments;
+
+        // mark_newlines option
+        parser->mark_newlines = options->mark_newlines;
+
+        // source_strings option
+        parser->source_strings = options->source_strings;
+
+        // discard_comments option, which attaching comments overrides
+        parser->discard_comments = options->discard_comments && !options->attach_comments;
+
+        // error_limit option
+        parser->error_limit = options->error_limit;
+
+        // syntax_check option
+        parser->syntax_check = options->syntax_check;
+
+        // shared_constant_pool option
+        if (options->shared_constant_pool != NULL) {
+            assert(parser->constant_pool.size == 0);
+            parser->shared_constant_pool = options->shared_constant_pool;
+            parser->constant_pool.base = &options->shared_constant_pool->pool;
+        }
+
         // scopes option
         parser->parsing_eval = options->scopes_count > 0;
         if (parser->parsing_eval) parser->warn_mismatched_indentation = false;
@@ -23351,8 +23702,35 @@ pm_parse_continuable(pm_parser_t *parser) {
  */
 pm_node_t *
 pm_parse(pm_parser_t *parser) {
+#ifdef PRISM_STATS
+    uint64_t start = pm_parser_stats_time();
+#endif
+
     pm_node_t *node = parse_program(parser);
+
+    // Closing everything at the error limit reports errors of its own, which
+    // are dropped so that only the ones found in the source are kept.
+    if (parser->error_limit != 0 && parser->error_list.size > parser->error_limit) {
+        pm_list_node_t *last = parser->error_list.head;
+        for (uint32_t index = 1; index < parser->error_limit; index++) last = last->next;
+
+        last->next = NULL;
+        parser->error_list.tail = last;
+        parser->error_list.size = parser->error_limit;
+    }
+
     pm_parse_continuable(parser);
+
+    // The encoding may have changed while parsing, so anything that was asked
+    // about the encoding of the source beforehand is forgotten.
+    parser->encoding_scanned = false;
+
+    if (parser->mark_newlines) pm_node_mark_newlines(node, &parser->line_offsets);
+
+#ifdef PRISM_STATS
+    parser->stats.parse_time += pm_parser_stats_time() - start;
+#endif
+
     return node;
 }
 
@@ -23383,6 +23761,642 @@ pm_parse_stream(pm_parser_t **parser, pm_arena_t *arena, pm_source_t *source, co
     return node;
 }
 
+/**
+ * The definition that pm_reparse parses again, along with the single range of
+ * the previous source that the edits replaced.
+ */
+typedef struct {
+    /* The source that the tree was parsed from. */
+    const uint8_t *source;
+
+    /* The size of the source that the tree was parsed from. */
+    size_t size;
+
+    /* The offset where the edited range starts, which is the same in both. */
+    uint32_t edit_start;
+
+    /* The offset where the edited range ends in the previous source. */
+    uint32_t edit_end;
+
+    /* The difference in size between the new source and the previous one. */
+    int64_t delta;
+
+    /* Whether the search has descended into a method definition. */
+    bool in_def;
+
+    /* The statements node whose body holds the definition, if one was found. */
+    pm_statements_node_t *statements;
+
+    /* The index of the definition within the body of the statements node. */
+    size_t index;
+} pm_reparse_t;
+
+/**
+ * Combine the given edits, each of which is in terms of the source after the
+ * ones before it, into the single range of the previous source that they
+ * replaced. Returns false if there are no edits or if they do not add up to the
+ * size of the new source.
+ */
+static bool
+pm_reparse_edits(pm_reparse_t *reparse, size_t size, const pm_edit_t *edits, size_t edits_count) {
+    if (edits_count == 0 || reparse->size >= UINT32_MAX || size >= UINT32_MAX) return false;
+
+    uint64_t current_size = reparse->size;
+    uint64_t start = UINT64_MAX;
+    uint64_t old_end = 0;
+    uint64_t new_end = 0;
+
+    for (size_t index = 0; index < edits_count; index++) {
+        const pm_edit_t *edit = &edits[index];
+        uint64_t edit_end = (uint64_t) edit->start + edit->old_length;
+        if (edit_end > current_size) return false;
+
+        if (start == UINT64_MAX) {
+            start = edit->start;
+            old_end = edit_end;
+            new_end = edit_end;
+        } else {
+            if (edit->start < start) start = edit->start;
+
+            // Bytes between the changed range and the end of this edit were
+            // unchanged until now, so they map straight back to the previous
+            // source.
+            if (edit_end > new_end) {
+                old_end += edit_end - new_end;
+                new_end = edit_end;
+            }
+        }
+
+        new_end = new_end + edit->new_length - edit->old_length;
+        current_size = current_size + edit->new_length - edit->old_length;
+    }
+
+    if (current_size != size) return false;
+
+    reparse->edit_start = (uint32_t) start;
+    reparse->edit_end = (uint32_t) old_end;
+    reparse->delta = (int64_t) size - (int64_t) reparse->size;
+    return true;
+}
+
+/**
+ * Returns true if the given node is a constant or a path made of constants.
+ */
+static bool
+pm_reparse_constant_p(const pm_node_t *node) {
+    while (PM_NODE_TYPE_P(node, PM_CONSTANT_PATH_NODE)) {
+        node = ((const pm_constant_path_node_t *) node)->parent;
+        if (node == NULL) return true;
+    }
+
+    return PM_NODE_TYPE_P(node, PM_CONSTANT_READ_NODE);
+}
+
+/**
+ * Returns true if the given node is a definition that can be parsed on its own
+ * without any of the state of the parser around it. Methods cannot be endless
+ * and can only be defined on self or a constant, and classes and modules can
+ * only be named by constants, since anything else would be parsed in the scope
+ * around them. Classes and modules within methods are errors, which depends on
+ * the context around them, so they are never reparsed there.
+ */
+static bool
+pm_reparse_definition_p(const pm_node_t *node, bool in_def) {
+    const pm_location_t *end_keyword_loc;
+
+    switch (PM_NODE_TYPE(node)) {
+        case PM_DEF_NODE: {
+            const pm_def_node_t *cast = (const pm_def_node_t *) node;
+            if (cast->receiver != NULL && !PM_NODE_TYPE_P(cast->receiver, PM_SELF_NODE) && !PM_NODE_TYPE_P(cast->receiver, PM_CONSTANT_READ_NODE)) return false;
+            end_keyword_loc = &cast->end_keyword_loc;
+            break;
+        }
+        case PM_CLASS_NODE: {
+            const pm_class_node_t *cast = (const pm_class_node_t *) node;
+            if (in_def || !pm_reparse_constant_p(cast->constant_path)) return false;
+            if (cast->superclass != NULL && !pm_reparse_constant_p(cast->superclass)) return false;
+            end_keyword_loc = &cast->end_keyword_loc;
+            break;
+        }
+        case PM_MODULE_NODE: {
+            const pm_module_node_t *cast = (const pm_module_node_t *) node;
+            if (in_def || !pm_reparse_constant_p(cast->constant_path)) return false;
+            end_keyword_loc = &cast->end_keyword_loc;
+            break;
+        }
+        case PM_SINGLETON_CLASS_NODE: {
+            const pm_singleton_class_node_t *cast = (const pm_singleton_class_node_t *) node;
+            if (in_def || !PM_NODE_TYPE_P(cast->expression, PM_SELF_NODE)) return false;
+            end_keyword_loc = &cast->end_keyword_loc;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // The definition must be closed, and closing it must be the end of it.
+    return end_keyword_loc->length == 3 && end_keyword_loc->start + 3 == node->location.start + node->location.length;
+}
+
+/**
+ * Find the furthest offset that anything within the given target reaches,
+ * which can be past the end of its node for the bodies of heredocs.
+ */
+static void
+pm_reparse_extent(const pm_node_t *target, const pm_location_t *location, void *data) {
+    uint32_t *extent = (uint32_t *) data;
+
+    if (location == NULL) {
+        location = &target->location;
+        pm_node_comment_targets_each(target, pm_reparse_extent, data);
+    }
+
+    if (location->start + location->length > *extent) *extent = location->start + location->length;
+}
+
+/**
+ * Returns true if the given definition takes up whole lines of the given
+ * source, so that it starts and ends where a statement does no matter what is
+ * around it.
+ */
+static bool
+pm_reparse_lines_p(const pm_node_t *node, const uint8_t *source, size_t size) {
+    const uint8_t *cursor = source + node->location.start;
+    while (cursor > source && (cursor[-1] == ' ' || cursor[-1] == '\t')) cursor--;
+    if (cursor != source && cursor[-1] != '\n') return false;
+
+    const uint8_t *end = source + size;
+    cursor = source + node->location.start + node->location.length;
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t')) cursor++;
+    return cursor == end || *cursor == '\n' || *cursor == '#' || (*cursor == '\r' && cursor + 1 < end && cursor[1] == '\n');
+}
+
+/**
+ * Search the tree for the innermost definition that is an entry of a list of
+ * statements and strictly contains the edited range, only descending into
+ * nodes that contain all of it.
+ */
+static bool
+pm_reparse_search(const pm_node_t *node, void *data) {
+    pm_reparse_t *reparse = (pm_reparse_t *) data;
+    if (node->location.start > reparse->edit_start || node->location.start + node->location.length < reparse->edit_end) return false;
+
+    if (PM_NODE_TYPE_P(node, PM_STATEMENTS_NODE)) {
+        const pm_node_list_t *body = &((const pm_statements_node_t *) node)->body;
+
+        for (size_t index = 0; index < body->size; index++) {
+            const pm_node_t *statement = body->nodes[index];
+
+            if (
+                statement->location.start < reparse->edit_start &&
+                statement->location.start + statement->location.length > reparse->edit_end &&
+                pm_reparse_definition_p(statement, reparse->in_def) &&
+                pm_reparse_lines_p(statement, reparse->source, reparse->size)
+            ) {
+                reparse->statements = (pm_statements_node_t *) node;
+                reparse->index = index;
+                break;
+            }
+        }
+    } else if (PM_NODE_TYPE_P(node, PM_DEF_NODE)) {
+        reparse->in_def = true;
+    }
+
+    return true;
+}
+
+/**
+ * Returns true if the given magic comment changes how the rest of the source
+ * is parsed from wherever it appears, which reparsing a definition on its own
+ * would not take into account.
+ */
+static bool
+pm_reparse_magic_comment_p(const uint8_t *source, const pm_magic_comment_t *magic_comment) {
+    static const char *keys[] = { "warn_indent", "shareable_constant_value" };
+    const uint8_t *key = source + magic_comment->key.start;
+
+    for (size_t index = 0; index < sizeof(keys) / sizeof(keys[0]); index++) {
+        size_t length = strlen(keys[index]);
+        if (magic_comment->key.length != length) continue;
+
+        size_t cursor = 0;
+        for (; cursor < length; cursor++) {
+            uint8_t byte = key[cursor] == '-' ? '_' : key[cursor];
+            if (byte >= 'A' && byte <= 'Z') byte = (uint8_t) (byte + ('a' - 'A'));
+            if (byte != (uint8_t) keys[index][cursor]) break;
+        }
+
+        if (cursor == length) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Returns true if any of the magic comments in the given list change how the
+ * rest of the source is parsed.
+ */
+static bool
+pm_reparse_magic_comments_p(const uint8_t *source, const pm_list_t *list) {
+    for (const pm_list_node_t *node = list->head; node != NULL; node = node->next) {
+        if (pm_reparse_magic_comment_p(source, (const pm_magic_comment_t *) node)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Move a location that was outside of the reparsed definition across the edit,
+ * in the same way that pm_node_rebase does.
+ */
+static PRISM_INLINE void
+pm_reparse_location(pm_location_t *location, uint32_t end, int64_t delta) {
+    if (location->start >= end) {
+        location->start = (uint32_t) (location->start + delta);
+    } else if (location->start + location->length >= end) {
+        location->length = (uint32_t) (location->length + delta);
+    }
+}
+
+/**
+ * Put the entries of a list that were found in the reparsed definition in place
+ * of the ones that were found there before. The list holds the entries that
+ * were just found, and the previous list holds all of the ones from before.
+ * Each entry holds the given number of locations at the given offset, the first
+ * of which determines where the entry is.
+ *
+ * Entries are kept in the order they were found, and the new entries take the
+ * place of the first of the old entries within the definition. If there were
+ * none, they go before the first entry after it, which is not always where a
+ * parse from scratch would have put them for diagnostics.
+ */
+static void
+pm_reparse_list(pm_list_t *list, const pm_list_t *previous, size_t offset, size_t count, uint32_t start, uint32_t end, int64_t delta) {
+    pm_list_t added = *list;
+    *list = (pm_list_t) { 0 };
+
+    for (pm_list_node_t *node = previous->head, *next; node != NULL; node = next) {
+        next = node->next;
+
+        pm_location_t *locations = (pm_location_t *) ((uint8_t *) node + offset);
+        bool within = locations[0].start >= start && locations[0].start < end;
+
+        if (added.head != NULL && (within || locations[0].start >= end)) {
+            if (list->head == NULL) {
+                list->head = added.head;
+            } else {
+                list->tail->next = added.head;
+            }
+
+            list->tail = added.tail;
+            list->size += added.size;
+            added = (pm_list_t) { 0 };
+        }
+
+        if (within) continue;
+        for (size_t index = 0; index < count; index++) pm_reparse_location(&locations[index], end, delta);
+
+        node->next = NULL;
+        pm_list_append(list, node);
+    }
+
+    for (pm_list_node_t *node = added.head, *next; node != NULL; node = next) {
+        next = node->next;
+        node->next = NULL;
+        pm_list_append(list, node);
+    }
+}
+
+/**
+ * Move the warning that the statements around the definition gave for it being
+ * unreachable, if there is one, from the previous warnings over to the ones
+ * that were just found. It depends only on the statement before the definition,
+ * so parsing the definition on its own cannot find it again.
+ */
+static void
+pm_reparse_unreachable(pm_list_t *list, pm_list_t *previous, uint32_t start, uint32_t end, uint32_t next_end) {
+    for (pm_list_node_t *node = previous->head, *prior = NULL; node != NULL; prior = node, node = node->next) {
+        pm_diagnostic_t *diagnostic = (pm_diagnostic_t *) node;
+        if (diagnostic->diag_id != PM_WARN_UNREACHABLE_STATEMENT || diagnostic->location.start != start || diagnostic->location.length != end - start) continue;
+
+        if (prior == NULL) {
+            previous->head = node->next;
+        } else {
+            prior->next = node->next;
+        }
+
+        if (previous->tail == node) previous->tail = prior;
+        previous->size--;
+
+        diagnostic->location.length = next_end - start;
+        node->next = NULL;
+        pm_list_append(list, node);
+        return;
+    }
+}
+
+/**
+ * Work out the encoding validity of the new source from the one of the
+ * previous source, which only changed within the given definition. Since the
+ * definition is surrounded by ASCII bytes, multibyte characters cannot cross
+ * its boundaries, so only its own bytes have to be checked unless the previous
+ * source had problems or its first non-ASCII byte was within the definition.
+ * In those cases, or if it was never requested for the previous source, it is
+ * left to be computed when it is next requested.
+ */
+static void
+pm_reparse_encoding_validity(pm_parser_t *parser, uint32_t start, uint32_t end, uint32_t next_end, int64_t delta) {
+    if (!parser->encoding_scanned) return;
+    uint32_t first_non_ascii = parser->first_non_ascii;
+
+    if (parser->encoding_validity != PM_ENCODING_VALIDITY_VALID || (first_non_ascii >= start && first_non_ascii < end)) {
+        parser->encoding_scanned = false;
+        return;
+    }
+
+    const uint8_t *definition = parser->start + start;
+    size_t length = next_end - start;
+    size_t ascii = pm_ascii_prefix_length(definition, length);
+
+    if (first_non_ascii >= end) {
+        parser->first_non_ascii = ascii < length ? (uint32_t) (start + ascii) : (uint32_t) (first_non_ascii + delta);
+    }
+
+    if (ascii < length) {
+        if (parser->encoding == PM_ENCODING_UTF_8_ENTRY) {
+            bool valid = pm_encoding_utf_8_valid_p(definition + ascii, length - ascii);
+            parser->encoding_validity = valid ? PM_ENCODING_VALIDITY_VALID : PM_ENCODING_VALIDITY_INVALID;
+        } else if (parser->encoding == PM_ENCODING_US_ASCII_ENTRY) {
+            parser->encoding_validity = PM_ENCODING_VALIDITY_INVALID;
+        } else {
+            parser->encoding_validity = PM_ENCODING_VALIDITY_UNKNOWN;
+        }
+    }
+}
+
+/**
+ * Parse the single definition that contains all of the edits again, and move
+ * the rest of the tree and the parser across the edits. Returns NULL without
+ * changing anything visible if the edits cannot be handled this way, and also
+ * returns NULL if the definition did not parse cleanly on its own, in which
+ * case the parser is left partway through and can only be freed.
+ */
+static pm_node_t *
+pm_reparse_definition(pm_parser_t *parser, pm_node_t *node, const uint8_t *source, size_t size, const pm_edit_t *edits, size_t edits_count) {
+    // Options that change how the whole source is parsed, and parses that did
+    // not finish cleanly, are only handled by parsing from scratch.
+    if (parser->syntax_check || parser->error_limit != 0 || parser->command_line != 0 || parser->lex_callback.callback != NULL) return NULL;
+    if (parser->lex_modes.index != 0 || parser->current_context != NULL || !PM_NODE_TYPE_P(node, PM_PROGRAM_NODE)) return NULL;
+
+    const uint8_t *previous_source = parser->start;
+    pm_reparse_t reparse = { .source = previous_source, .size = (size_t) (parser->end - parser->start) };
+
+    if (!pm_reparse_edits(&reparse, size, edits, edits_count)) return NULL;
+    if (pm_reparse_magic_comments_p(previous_source, &parser->magic_comment_list)) return NULL;
+
+    pm_visit_node(node, pm_reparse_search, &reparse);
+    if (reparse.statements == NULL) return NULL;
+
+    pm_node_t *definition = reparse.statements->body.nodes[reparse.index];
+    uint32_t start = definition->location.start;
+    uint32_t end = start + definition->location.length;
+    uint32_t next_end = (uint32_t) (end + reparse.delta);
+
+    // Heredocs can have their bodies after the end of the definition, in which
+    // case they would not be parsed again with it. This walks the whole
+    // definition, so it is only done for the innermost one.
+    uint32_t extent = 0;
+    pm_reparse_extent(definition, NULL, &extent);
+    if (extent != end) return NULL;
+
+    // The definition being replaced stays in the arena, so once as much has
+    // been parsed again as the source holds, parse from scratch to reclaim it.
+    if (parser->reparsed_size + (next_end - start) > size) return NULL;
+
+    // Errors can leave the parser in a state that carries on past the end of
+    // the definition, so the definition must not have had any.
+    for (const pm_list_node_t *error = parser->error_list.head; error != NULL; error = error->next) {
+        uint32_t error_start = ((const pm_diagnostic_t *) error)->location.start;
+        if (error_start >= start && error_start < end) return NULL;
+    }
+
+    pm_list_t comments = parser->comment_list;
+    pm_list_t magic_comments = parser->magic_comment_list;
+    pm_list_t warnings = parser->warning_list;
+    pm_list_t errors = parser->error_list;
+    pm_location_t data_loc = parser->data_loc;
+    size_t encoding_comment_start = (size_t) (parser->encoding_comment_start - previous_source);
+
+    parser->comment_list = (pm_list_t) { 0 };
+    parser->magic_comment_list = (pm_list_t) { 0 };
+    parser->warning_list = (pm_list_t) { 0 };
+    parser->error_list = (pm_list_t) { 0 };
+    parser->data_loc = (pm_location_t) { 0 };
+
+    // Keep the line offsets up to the start of the definition and set aside
+    // the ones after it, so that the offsets of the lines within it can be
+    // appended by the lexer as it goes.
+    pm_line_offset_list_t *line_offsets = &parser->line_offsets;
+    size_t head = (size_t) pm_line_offset_list_line(line_offsets, start, 0) + 1;
+    size_t tail = (size_t) pm_line_offset_list_line(line_offsets, end, 0) + 1;
+    size_t tail_size = line_offsets->size - tail;
+
+    uint32_t *tail_offsets = (uint32_t *) xmalloc(tail_size * sizeof(uint32_t));
+    if (tail_offsets == NULL && tail_size > 0) abort();
+
+    memcpy(tail_offsets, line_offsets->offsets + tail, tail_size * sizeof(uint32_t));
+    line_offsets->size = head;
+
+    // Reset the lexer and the parser to the state they are in at the start of
+    // a statement, and parse only the bytes that the definition now spans.
+    parser->start = source;
+    parser->end = source + next_end;
+    parser->previous = (pm_token_t) { .type = PM_TOKEN_EOF, .start = source + start, .end = source + start };
+    parser->current = parser->previous;
+    parser->next_start = NULL;
+    parser->heredoc_end = NULL;
+    parser->lex_state = PM_LEX_STATE_BEG;
+    parser->enclosure_nesting = 0;
+    parser->lambda_enclosure_nesting = -1;
+    parser->brace_nesting = 0;
+    parser->do_loop_stack = 0;
+    parser->accepts_block_stack = 0;
+    parser->lex_modes.index = 0;
+    parser->lex_modes.floor = 0;
+    parser->lex_modes.stack[0] = (pm_lex_mode_t) { .mode = PM_LEX_DEFAULT };
+    parser->lex_modes.current = &parser->lex_modes.stack[0];
+    parser->constant_cache.start = NULL;
+    parser->constant_cache.end = NULL;
+    parser->current_hash_keys = NULL;
+    parser->value_expression.node = NULL;
+    parser->value_expression.void_node = NULL;
+    parser->command_call_value.node = NULL;
+    parser->command_call_value.value = false;
+    parser->integer.lexed = false;
+    parser->current_string = PM_STRING_EMPTY;
+    parser->explicit_encoding = NULL;
+    parser->encoding_comment_start = source;
+    parser->command_start = true;
+    parser->in_endless_def_body = false;
+    parser->recovering = false;
+    parser->pattern_matching_newlines = false;
+    parser->in_keyword_arg = false;
+    parser->semantic_token_seen = true;
+    pm_accepts_block_stack_push(parser, true);
+
+    pm_constant_id_t constants = pm_constant_pool_total_size(&parser->constant_pool);
+    pm_parser_scope_push(parser, true);
+
+    pm_node_list_t current_block_exits = { 0 };
+    pm_node_list_t *previous_block_exits = push_block_exits(parser, &current_block_exits);
+
+    parser_lex(parser);
+    pm_statements_node_t *statements = parse_statements(parser, PM_CONTEXT_MAIN, 0);
+
+    // The definition has to have parsed into exactly the same kind of node,
+    // spanning the same bytes, with nothing left over and nothing to report
+    // outside of it.
+    bool parsed = (
+        statements != NULL &&
+        statements->body.size == 1 &&
+        parser->current.type == PM_TOKEN_EOF &&
+        parser->current.start == parser->end &&
+        parser->lex_modes.index == 0 &&
+        !parser->recovering &&
+        parser->error_list.size == 0 &&
+        parser->data_loc.length == 0 &&
+        parser->current_scope->locals.size == 0 &&
+        current_block_exits.size == 0
+    );
+
+    pm_parser_scope_pop(parser);
+    parser->current_block_exits = previous_block_exits;
+
+    pm_node_t *next = parsed ? statements->body.nodes[0] : NULL;
+
+    if (
+        next == NULL ||
+        PM_NODE_TYPE(next) != PM_NODE_TYPE(definition) ||
+        next->location.start != start ||
+        next->location.start + next->location.length != next_end ||
+        !pm_reparse_definition_p(next, false) ||
+        pm_reparse_magic_comments_p(source, &parser->magic_comment_list)
+    ) {
+        xfree_sized(tail_offsets, tail_size * sizeof(uint32_t));
+        return NULL;
+    }
+
+    for (const pm_list_node_t *warning = parser->warning_list.head; warning != NULL; warning = warning->next) {
+        const pm_location_t *location = &((const pm_diagnostic_t *) warning)->location;
+
+        if (location->start < start || location->start + location->length > next_end) {
+            xfree_sized(tail_offsets, tail_size * sizeof(uint32_t));
+            return NULL;
+        }
+    }
+
+    // A few warnings name the line of an earlier token in their message, which
+    // cannot be moved along with their location if lines were added or removed.
+    if (line_offsets->size - head != tail - head) {
+        for (const pm_list_node_t *warning = warnings.head; warning != NULL; warning = warning->next) {
+            const pm_diagnostic_t *diagnostic = (const pm_diagnostic_t *) warning;
+            if (diagnostic->location.start < end) continue;
+
+            switch (diagnostic->diag_id) {
+                case PM_WARN_DUPLICATED_HASH_KEY:
+                case PM_WARN_DUPLICATED_WHEN_CLAUSE:
+                case PM_WARN_INDENTATION_MISMATCH:
+                    xfree_sized(tail_offsets, tail_size * sizeof(uint32_t));
+                    return NULL;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Splice the new definition into the tree, and move everything else over
+    // to the new source.
+    next->flags = (pm_node_flags_t) ((next->flags & ~PM_NODE_FLAG_NEWLINE) | (definition->flags & PM_NODE_FLAG_NEWLINE));
+    reparse.statements->body.nodes[reparse.index] = next;
+
+    pm_node_rebase_t rebase = {
+        .skip = next,
+        .old_source = previous_source,
+        .old_size = reparse.size,
+        .new_source = source,
+        .end = end,
+        .delta = reparse.delta
+    };
+
+    pm_node_rebase(node, &rebase);
+    pm_constant_pool_rebase(&parser->metadata_arena, &parser->constant_pool, constants, previous_source, reparse.size, source, start, end, reparse.delta);
+
+    pm_reparse_list(&parser->comment_list, &comments, offsetof(pm_comment_t, location), 1, start, end, reparse.delta);
+    pm_reparse_list(&parser->magic_comment_list, &magic_comments, offsetof(pm_magic_comment_t, key), 2, start, end, reparse.delta);
+    pm_reparse_unreachable(&parser->warning_list, &warnings, start, end, next_end);
+    pm_reparse_list(&parser->warning_list, &warnings, offsetof(pm_diagnostic_t, location), 1, start, end, reparse.delta);
+    pm_reparse_list(&parser->error_list, &errors, offsetof(pm_diagnostic_t, location), 1, start, end, reparse.delta);
+
+    for (size_t index = 0; index < tail_size; index++) {
+        pm_line_offset_list_append(&parser->metadata_arena, line_offsets, (uint32_t) (tail_offsets[index] + reparse.delta));
+    }
+    xfree_sized(tail_offsets, tail_size * sizeof(uint32_t));
+
+    pm_reparse_location(&data_loc, end, reparse.delta);
+    parser->data_loc = data_loc;
+
+    if (encoding_comment_start >= end) encoding_comment_start = (size_t) ((int64_t) encoding_comment_start + reparse.delta);
+    parser->encoding_comment_start = source + encoding_comment_start;
+
+    parser->end = source + size;
+    parser->previous = (pm_token_t) { .type = PM_TOKEN_EOF, .start = parser->end, .end = parser->end };
+    parser->current = parser->previous;
+
+    parser->continuable = true;
+    pm_parse_continuable(parser);
+    pm_reparse_encoding_validity(parser, start, end, next_end, reparse.delta);
+
+    if (parser->mark_newlines) {
+        pm_node_mark_newlines(next, line_offsets);
+        next->flags = (pm_node_flags_t) ((next->flags & ~PM_NODE_FLAG_NEWLINE) | (definition->flags & PM_NODE_FLAG_NEWLINE));
+    }
+
+    parser->reparsed_loc = (pm_location_t) { .start = start, .length = next_end - start };
+    parser->reparsed_size += next_end - start;
+
+    return node;
+}
+
+/**
+ * Parse the source again after it has been changed by the given edits. If all
+ * of the edits fall within a definition that can be parsed on its own, only
+ * that definition is parsed, and the rest of the tree is kept. Otherwise the
+ * new source is parsed from scratch, continuing on from the node ids of the
+ * previous parse so that none are reused.
+ */
+pm_node_t *
+pm_reparse(pm_parser_t **parser, pm_arena_t *arena, pm_node_t *node, const uint8_t *source, size_t size, const pm_edit_t *edits, size_t edits_count, const pm_options_t *options) {
+#ifdef PRISM_STATS
+    uint64_t start = pm_parser_stats_time();
+#endif
+
+    pm_node_t *result = pm_reparse_definition(*parser, node, source, size, edits, edits_count);
+
+#ifdef PRISM_STATS
+    (*parser)->stats.parse_time += pm_parser_stats_time() - start;
+#endif
+
+    if (result != NULL) return result;
+
+    uint32_t node_id = (*parser)->node_id;
+    pm_parser_free(*parser);
+    pm_arena_cleanup(arena);
+
+    *parser = pm_parser_new(arena, source, size, options);
+    (*parser)->node_id = node_id;
+    return pm_parse(*parser);
+}
+
 #undef PM_CASE_KEYWORD
 #undef PM_CASE_OPERATOR
 #undef PM_CASE_WRITABLE
@@ -23393,13 +24407,18 @@ pm_parse_stream(pm_parser_t **parser, pm_arena_t *arena, pm_source_t *source, co
 // PRISM_EXCLUDE_SERIALIZATION define.
 #ifndef PRISM_EXCLUDE_SERIALIZATION
 
+/**
+ * Serialize the header. The byte after the version is a set of flags: bit 0 is
+ * set if only semantics fields are serialized, and bit 1 is set if string
+ * fields may be serialized as offsets into the source.
+ */
 static PRISM_INLINE void
-pm_serialize_header(pm_buffer_t *buffer) {
+pm_serialize_header(const pm_parser_t *parser, pm_buffer_t *buffer) {
     pm_buffer_append_string(buffer, "PRISM", 5);
     pm_buffer_append_byte(buffer, PRISM_VERSION_MAJOR);
     pm_buffer_append_byte(buffer, PRISM_VERSION_MINOR);
     pm_buffer_append_byte(buffer, PRISM_VERSION_PATCH);
-    pm_buffer_append_byte(buffer, PRISM_SERIALIZE_ONLY_SEMANTICS_FIELDS ? 1 : 0);
+    pm_buffer_append_byte(buffer, (uint8_t) ((PRISM_SERIALIZE_ONLY_SEMANTICS_FIELDS ? 0x1 : 0) | (parser->source_strings ? 0x2 : 0)));
 }
 
 /**
@@ -23407,7 +24426,7 @@ pm_serialize_header(pm_buffer_t *buffer) {
  */
 void
 pm_serialize(pm_parser_t *parser, pm_node_t *node, pm_buffer_t *buffer) {
-    pm_serialize_header(buffer);
+    pm_serialize_header(parser, buffer);
     pm_serialize_content(parser, node, buffer);
     pm_buffer_append_byte(buffer, '\0');
 }
@@ -23427,7 +24446,7 @@ pm_serialize_parse(pm_buffer_t *buffer, const uint8_t *source, size_t size, cons
 
     pm_node_t *node = pm_parse(&parser);
 
-    pm_serialize_header(buffer);
+    pm_serialize_header(&parser, buffer);
     pm_serialize_content(&parser, node, buffer);
     pm_buffer_append_byte(buffer, '\0');
 
@@ -23448,7 +24467,7 @@ pm_serialize_parse_stream(pm_buffer_t *buffer, pm_source_t *source, const char *
     pm_options_read(&options, data);
 
     pm_node_t *node = pm_parse_stream(&parser, &arena, source, &options);
-    pm_serialize_header(buffer);
+    pm_serialize_header(parser, buffer);
     pm_serialize_content(parser, node, buffer);
     pm_buffer_append_byte(buffer, '\0');
 
@@ -23469,6 +24488,8 @@ int8_t
 pm_serialize_parse_errors_format(pm_buffer_t *buffer, const uint8_t *source, size_t size, const char *data, pm_errors_format_type_t format_type) {
     pm_options_t options = { 0 };
     pm_options_read(&options, data);
+    pm_options_discard_comments_set(&options, true);
+    pm_options_syntax_check_set(&options, true);
 
     pm_arena_t arena = { 0 };
     pm_parser_t parser;
@@ -23505,7 +24526,7 @@ pm_serialize_parse_comments(pm_buffer_t *buffer, const uint8_t *source, size_t s
     pm_parser_init(&arena, &parser, source, size, &options);
 
     pm_parse(&parser);
-    pm_serialize_header(buffer);
+    pm_serialize_header(&parser, buffer);
     pm_serialize_encoding(parser.encoding, buffer);
     pm_buffer_append_varsint(buffer, parser.start_line);
     pm_serialize_line_offset_list(&parser.line_offsets, buffer);
@@ -1608,6 +1608,8 @@ pm_regexp_validate_encoding(pm_regexp_parser_t *parser, bool ascii_only, pm_node
  */
 pm_node_flags_t
 pm_regexp_parse(pm_parser_t *parser, pm_regular_expression_node_t *node, pm_regexp_name_callback_t name_callback, pm_regexp_name_data_t *name_data) {
+    PM_PARSER_STATS_INCREMENT(parser, regexp_validations);
+
     const uint8_t *source = parser->start + node->content_loc.start;
     size_t size = node->content_loc.length;
     bool extended_mode = PM_NODE_FLAG_P(node, PM_REGULAR_EXPRESSION_FLAGS_EXTENDED);
@@ -320,7 +320,10 @@ pm_strpbrk_ascii_8bit(pm_parser_t *parser, const uint8_t *source, const uint8_t
 }
 
 /**
- * This is the slow path that does care about the encoding.
+ * This is the slow path that does care about the encoding. Runs of two-byte
+ * characters that the encoding can recognize many bytes at a time are skipped
+ * as a whole, since none of their bytes can be a breakpoint, and runs of ASCII
+ * after them go back to the fast scanner.
  */
 static PRISM_INLINE const uint8_t *
 pm_strpbrk_multi_byte(pm_parser_t *parser, const uint8_t *source, const uint8_t *charset, size_t index, size_t maximum, bool validate) {
@@ -333,6 +336,23 @@ pm_strpbrk_multi_byte(pm_parser_t *parser, const uint8_t *source, const uint8_t
 
         if (source[index] < 0x80) {
             index++;
+            continue;
+        }
+
+        size_t run = pm_encoding_double_byte_length(encoding, source + index, maximum - index);
+
+        if (run > 0) {
+            // Every character in the run is valid, so only the first one can
+            // change the explicit encoding.
+            if (validate) pm_strpbrk_explicit_encoding_set(parser, (uint32_t) (source - parser->start), 2);
+            index += run;
+
+            size_t ascii;
+            if (scan_strpbrk_ascii(parser, source + index, maximum - index, charset, &ascii)) {
+                return source + index + ascii;
+            }
+
+            index += ascii;
         } else {
             size_t width = encoding->char_width(source + index, (ptrdiff_t) (maximum - index));
             if (validate) pm_strpbrk_explicit_encoding_set(parser, (uint32_t) (source - parser->start), (uint32_t) width);
@@ -425,7 +445,12 @@ pm_strpbrk(pm_parser_t *parser, const uint8_t *source, const uint8_t *charset, p
 
     size_t maximum = (size_t) length;
     size_t index = 0;
-    if (scan_strpbrk_ascii(parser, source, maximum, charset, &index)) return source + index;
+    PM_PARSER_STATS_INCREMENT(parser, strpbrk_calls);
+
+    if (scan_strpbrk_ascii(parser, source, maximum, charset, &index)) {
+        PM_PARSER_STATS_INCREMENT(parser, strpbrk_accelerated);
+        return source + index;
+    }
 
     if (!parser->encoding_changed) {
         return pm_strpbrk_utf8(parser, source, charset, index, maximum, validate);
@@ -0,0 +1,36 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class DiagnosticMessagesTest < TestCase
+    def test_errors
+      errors = Prism.parse("def foo(a, a)\n  1 +\nend\nfoo(&)\n").errors
+
+      assert_diagnostic [:parameter_name_duplicated, :syntax, 1, 11, 1, "duplicated argument name"], errors[0]
+      assert_diagnostic [:expect_expression_after_operator, :syntax, 3, 0, 3, "unexpected 'end'; expected an expression after the operator"], errors[1]
+      assert_diagnostic [:unexpected_token_close_context, :syntax, 3, 0, 3, "unexpected 'end', assuming it is closing the parent method definition"], errors[2]
+      assert_diagnostic [:argument_no_forwarding_ampersand, :syntax, 4, 4, 1, "unexpected `&`; no anonymous block parameter"], errors[3]
+      assert_equal 4, errors.length
+    end
+
+    def test_warnings
+      warnings = Prism.parse("a = 1\n").warnings
+
+      assert_diagnostic [:unused_local_variable, :verbose, 1, 0, 1, "assigned but unused variable - a"], warnings[0]
+      assert_equal 1, warnings.length
+    end
+
+    private
+
+    # When prism is built with PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES, diagnostics
+    # carry their name in place of their message, but everything else about
+    # them is unchanged.
+    def assert_diagnostic(expected, diagnostic)
+      type, level, line, column, length, message = expected
+      message = type.to_s if ENV["PRISM_EXCLUDE_DIAGNOSTIC_MESSAGES"]
+
+      assert_equal [type, level, line, column, length, message], [diagnostic.type, diagnostic.level, diagnostic.location.start_line, diagnostic.location.start_column, diagnostic.location.length, diagnostic.message]
+    end
+  end
+end
@@ -26,6 +26,16 @@ module Prism
       assert_equal_nodes ast2, ast3
     end
 
+    def test_dump_source_strings
+      source = File.read(__FILE__, binmode: true, external_encoding: Encoding::UTF_8)
+
+      dumped = Prism.dump(source)
+      sliced = Prism.dump(source, source_strings: true)
+
+      assert_operator sliced.bytesize, :<, dumped.bytesize
+      assert_equal_nodes Prism.load(source, dumped).value, Prism.load(source, sliced).value
+    end
+
     def test_dump_file
       assert_nothing_raised do
         Prism.dump_file(__FILE__)
@@ -42,8 +52,26 @@ module Prism
       end
     end
 
+    def test_dump_errors
+      source = "def foo(\n  1 +\nend\nclass\n<<~A\n  x\n[1, 2\nfoo(\"bar\n"
+      errors = Prism.parse(source, line: 3).errors.map { |error| [error.type, error.level, error.location.start_line, error.location.start_column, error.location.length] }
+
+      assert_equal errors, load_errors(Prism.dump_errors(source, line: 3))
+      assert_equal errors.first(2), load_errors(Prism.dump_errors(source, line: 3, error_limit: 2))
+      assert_equal [], load_errors(Prism.dump_errors("foo(<<~A)\n  bar\nA\n"))
+      assert_raise(ArgumentError) { Prism.dump_errors(source, error_limit: -1) }
+
+      loaded = Prism.load_errors(Prism.dump_errors(source), true)
+      assert_predicate loaded, :frozen?
+      assert loaded.all?(&:frozen?)
+    end
+
     private
 
+    def load_errors(dumped)
+      Prism.load_errors(dumped).map { |error| [error.type, error.level, error.line, error.column, error.length] }
+    end
+
     def assert_dump(fixture)
       source = fixture.read
 
@@ -51,6 +79,9 @@ module Prism
       dumped = Prism.dump(source, filepath: fixture.path)
 
       assert_equal_nodes(result.value, Prism.load(source, dumped).value)
+
+      sliced = Prism.dump(source, filepath: fixture.path, source_strings: true)
+      assert_equal_nodes(result.value, Prism.load(source, sliced).value)
     end
   end
 end
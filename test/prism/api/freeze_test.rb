@@ -11,6 +11,10 @@ module Prism
     def test_offsets_usable
       node = Prism.parse_statement("1 + 2", freeze: true)
       assert_equal(1, node.start_line)
+
+      source = Prism.parse("1\n2\n", freeze: true).source
+      assert_equal([0, 2, 4], source.offsets)
+      assert_same(source.offsets, source.offsets)
     end
 
     def test_lex
@@ -0,0 +1,204 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class IncrementalParserTest < TestCase
+    SOURCE = <<~RUBY
+      # frozen_string_literal: true
+
+      require "set"
+
+      module Foo
+        class Bar < Baz
+          # Comment before qux.
+          def qux(a, b = 1)
+            a + b # trailing
+          end
+
+          def self.quux
+            [1, 2, 3].map do |x|
+              x * 2
+            end
+          end
+
+          class << self
+            def corge = :corge
+          end
+        end
+      end
+
+      Foo::Bar.new.qux(1)
+    RUBY
+
+    def test_reparse_method
+      assert_reparses_enclosing("a + b # trailing", "a - b * 2 # trailing", DefNode)
+    end
+
+    def test_reparse_class
+      assert_reparses_enclosing("    def corge = :corge\n", "    def corge = :corge\n    def grault; end\n", SingletonClassNode)
+    end
+
+    def test_reparse_lines
+      parser = IncrementalParser.new(SOURCE)
+      assert_reparse(parser, "    x * 2\n", "    x *\n\n 2\n")
+      assert_reparse(parser, "# Comment before qux.\n", "")
+      assert_reparse(parser, "a + b", "a + b # changed\n  # more\n  b")
+    end
+
+    def test_reparse_diagnostics
+      parser = IncrementalParser.new(SOURCE + "def a\n  x = 1\nend\nfoo(1,)\n")
+      assert_reparse(parser, "a + b # trailing", "c = a + b")
+      assert_reparse(parser, "c = a + b", "a + b")
+      assert_reparse(parser, "  x = 1\n", "  x = 1\n  y = 2\n")
+    end
+
+    def test_reparse_unreachable
+      parser = IncrementalParser.new("def a\n  return 1\n  def b\n    1\n  end\nend\n")
+      assert_reparse(parser, "1\n  end", "21\n  end")
+      assert_equal [[:unreachable_statement, 19, 18]], parser.result.warnings.map { |warning| [warning.type, warning.location.start_offset, warning.location.length] }
+
+      assert_reparse(parser, "21\n  end", "1\n  end")
+      assert_equal [[:unreachable_statement, 19, 17]], parser.result.warnings.map { |warning| [warning.type, warning.location.start_offset, warning.location.length] }
+    end
+
+    def test_reparse_multiple_edits
+      parser = IncrementalParser.new(SOURCE)
+      start = SOURCE.index("a + b")
+
+      source = SOURCE.dup
+      source[start, 1] = "aa"
+      source[start + 6, 0] = " + 3"
+      source[start, 2] = "a"
+
+      range = parser.reparse(source, [[start, 1, 2], [start + 6, 0, 4], [start, 2, 1]])
+      assert_equal source, parser.source
+      assert_equal_results Prism.parse(source), parser.result
+      assert_operator range.size, :<, source.bytesize if BACKEND == :CEXT
+    end
+
+    def test_reparse_typing
+      parser = IncrementalParser.new(SOURCE)
+      source = SOURCE
+      start = source.index("x * 2") + 5
+
+      " + foo(x, [1, 2], { a: 3 }) if x > 1".each_char.with_index do |char, index|
+        source = source.byteslice(0, start + index) + char + source.byteslice((start + index)..)
+        parser.reparse(source, [[start + index, 0, 1]])
+        assert_equal_results Prism.parse(source), parser.result
+      end
+    end
+
+    def test_reparse_keeps_node_ids
+      parser = IncrementalParser.new(SOURCE)
+      before = parser.result.value
+      node_ids = before.statements.body.map(&:node_id)
+      quux = find(before, DefNode) { |node| node.name == :quux }.node_id
+
+      assert_reparse(parser, "a + b", "b + a")
+      after = parser.result.value
+
+      if BACKEND == :CEXT
+        assert_equal node_ids, after.statements.body.map(&:node_id)
+        assert_equal quux, find(after, DefNode) { |node| node.name == :quux }.node_id
+        assert_empty ids(before) & ids(find(after, DefNode) { |node| node.name == :qux })
+      end
+    end
+
+    def test_reparse_falls_back
+      assert_falls_back("require \"set\"", "require \"json\"")
+      assert_falls_back("a + b # trailing", "a + b +")
+      assert_falls_back("a + b # trailing", "a + b\n  end\n\n  def extra")
+      assert_falls_back("    x * 2\n", "    x * 2\n<<~A\n")
+      assert_falls_back("a + b # trailing", "a + b\n# warn_indent: false\n")
+    end
+
+    def test_reparse_enclosing
+      assert_reparses_enclosing("class Bar < Baz", "class Bar < baz", ModuleNode)
+      assert_reparses_enclosing("def self.quux", "def quux.quux", ClassNode)
+      assert_reparses_enclosing("def qux(a, b = 1)", "def qux(a, b = c)", ClassNode)
+    end
+
+    def test_reparse_after_errors
+      parser = IncrementalParser.new(SOURCE)
+      assert_reparse(parser, "a + b # trailing", "a + ")
+      assert_reparse(parser, "a + ", "a + b")
+      assert_reparse(parser, "x * 2", "x * 3")
+    end
+
+    def test_reparse_data
+      parser = IncrementalParser.new(SOURCE + "__END__\ndata\n")
+      assert_reparse(parser, "a + b", "a + b + c")
+      assert_equal "data\n", parser.result.data_loc.slice.delete_prefix("__END__\n")
+    end
+
+    def test_reparse_encoding
+      parser = IncrementalParser.new(SOURCE)
+      assert_reparse(parser, "x * 2", "x * \"\u00e9\"")
+      assert_reparse(parser, "a + b", "a + \"\xff\"")
+      assert_reparse(parser, "a + \"\xff\"", "a + b")
+      assert_reparse(parser, "x * \"\u00e9\"", "x * 2")
+    end
+
+    def test_reparse_mark_newlines
+      parser = IncrementalParser.new(SOURCE, mark_newlines: true)
+      assert_reparse(parser, "    x * 2\n", "    y = x; x * 2\n", mark_newlines: true)
+      assert_reparse(parser, "def qux(a, b = 1)\n", "def qux(a, b = 1) a\n", mark_newlines: true)
+    end
+
+    def test_reparse_invalid_edits
+      parser = IncrementalParser.new(SOURCE)
+      source = SOURCE.sub("a + b", "a")
+
+      assert_equal 0...source.bytesize, parser.reparse(source, [[0, 0, 0]])
+      assert_equal_results Prism.parse(source), parser.result
+    end
+
+    private
+
+    def assert_reparse(parser, before, after, **options)
+      start = parser.source.b.index(before.b)
+      source = parser.source.byteslice(0, start) + after + parser.source.byteslice((start + before.bytesize)..)
+
+      range = parser.reparse(source, [[start, before.bytesize, after.bytesize]])
+      assert_equal_results Prism.parse(source, **options), parser.result
+      range
+    end
+
+    def assert_falls_back(before, after)
+      parser = IncrementalParser.new(SOURCE)
+      range = assert_reparse(parser, before, after)
+      assert_equal 0...parser.source.bytesize, range
+    end
+
+    def assert_reparses_enclosing(before, after, type)
+      parser = IncrementalParser.new(SOURCE)
+      range = assert_reparse(parser, before, after)
+      return if BACKEND != :CEXT
+
+      definition = find(parser.result.value, type)
+      assert_equal definition.location.start_offset...definition.location.end_offset, range
+    end
+
+    def assert_equal_results(expected, actual)
+      assert_equal expected.value.inspect, actual.value.inspect
+      assert_equal expected.comments.map(&:inspect), actual.comments.map(&:inspect)
+      assert_equal expected.magic_comments.map(&:inspect), actual.magic_comments.map(&:inspect)
+      assert_equal expected.errors.map(&:inspect).sort, actual.errors.map(&:inspect).sort
+      assert_equal expected.warnings.map(&:inspect).sort, actual.warnings.map(&:inspect).sort
+      assert_equal expected.source.offsets, actual.source.offsets
+      assert_equal expected.source.class, actual.source.class
+      assert_equal expected.source.source.valid_encoding?, actual.source.source.valid_encoding?
+      assert_equal expected.data_loc&.slice, actual.data_loc&.slice
+      assert_equal expected.continuable?, actual.continuable?
+    end
+
+    def find(node, type, &block)
+      node.breadth_first_search { |child| child.is_a?(type) && (!block || block.call(child)) }
+    end
+
+    def ids(node)
+      [node.node_id, *node.compact_child_nodes.flat_map { |child| ids(child) }]
+    end
+  end
+end
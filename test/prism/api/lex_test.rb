@@ -19,5 +19,15 @@ module Prism
       result = Prism.parse_lex_file(__FILE__)
       assert_kind_of ParseLexResult, result
     end
+
+    def test_token_offsets
+      [false, true].each do |freeze|
+        tokens = Prism.lex("foo + barbaz", freeze: freeze).value.map(&:first)
+
+        assert_equal [0, 4, 6, 12], tokens.map(&:start_offset)
+        assert_equal [3, 5, 12, 12], tokens.map(&:end_offset)
+        assert_equal tokens.map { |token| token.location.end_offset }, tokens.map(&:end_offset)
+      end
+    end
   end
 end
@@ -0,0 +1,26 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+return unless Prism.respond_to?(:node_stats)
+
+module Prism
+  class NodeStatsTest < TestCase
+    def test_node_stats
+      stats = Prism.node_stats("foo(1, 2)")
+
+      assert_equal 1, stats[:PM_CALL_NODE][:count]
+      assert_equal 2, stats[:PM_INTEGER_NODE][:count]
+      assert_operator stats[:PM_ARGUMENTS_NODE][:list_bytes], :>, 0
+    end
+
+    def test_node_stats_compact
+      stats = Prism.node_stats(File.read(__FILE__))
+
+      current = stats.each_value.sum { |entry| entry[:bytes] + entry[:list_bytes] }
+      compact = stats.each_value.sum { |entry| entry[:compact_bytes] }
+
+      assert_operator compact, :<, current
+    end
+  end
+end
@@ -20,6 +20,18 @@ module Prism
       assert_equal 1, comments.length
     end
 
+    def test_discard_comments
+      source = "# frozen_string_literal: true\n=begin\ndoc\n=end\nfoo # bar\n\"baz\""
+      result = Prism.parse(source, discard_comments: true)
+
+      assert_empty result.comments
+      assert_equal ["frozen_string_literal"], result.magic_comments.map(&:key)
+      assert_predicate result.value.statements.body.last, :frozen?
+      assert_equal Prism.parse(source).value.inspect, result.value.inspect
+
+      assert_equal 3, Prism.parse(source, discard_comments: true, attach_comments: true).comments.length
+    end
+
     def test_parse_file_comments_error
       error = assert_raise Errno::ENOENT do
         Prism.parse_file_comments("idontexist.rb")
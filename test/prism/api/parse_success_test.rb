@@ -12,5 +12,37 @@ module Prism
     def test_parse_file_success?
       assert Prism.parse_file_success?(__FILE__)
     end
+
+    def test_syntax_check
+      source = <<~RUBY
+        def foo
+          1
+          @a
+          return
+          bar
+        end
+        while foo
+          break
+          baz
+        end
+        [1].each { it; 2 }
+        "a\\n"
+        ?\\n
+        foo(
+      RUBY
+
+      expected = Prism.parse(source)
+      actual = Prism.parse(source, syntax_check: true)
+
+      assert_equal diagnostics(expected.errors), diagnostics(actual.errors)
+      assert_equal diagnostics(expected.warnings), diagnostics(actual.warnings)
+      assert_equal [:a, :d], Prism.parse("a\nb\nc\nd", syntax_check: true).value.statements.body.map(&:name)
+    end
+
+    private
+
+    def diagnostics(diagnostics)
+      diagnostics.map { |diagnostic| [diagnostic.type, diagnostic.location.start_offset] }.sort
+    end
   end
 end
@@ -104,6 +104,20 @@ module Prism
       assert Prism.parse_success?("yield", partial_script: true)
     end
 
+    def test_error_limit
+      source = "def foo(\n  1 +\nend\nclass\n<<~A\n  x\n[1, 2\nfoo(\"bar\n"
+      errors = Prism.parse(source).errors.map(&:type)
+
+      (1..3).each do |error_limit|
+        result = Prism.parse(source, error_limit: error_limit)
+        assert_equal errors.first(error_limit), result.errors.map(&:type)
+      end
+
+      assert_equal errors, Prism.parse(source, error_limit: 0).errors.map(&:type)
+      assert Prism.parse_success?("foo(<<~A)\n  bar\nA\n", error_limit: 1)
+      assert_raise(ArgumentError) { Prism.parse(source, error_limit: -1) }
+    end
+
     def test_version
       assert Prism.parse_success?("1 + 1", version: "3.3")
       assert Prism.parse_success?("1 + 1", version: "3.3.0")
@@ -176,6 +190,25 @@ module Prism
       assert Prism.parse_success?("foo(...)", scopes: [Prism.scope(forwarding: [:"..."])])
     end
 
+    def test_source_ascii_only
+      assert_kind_of ASCIISource, Prism.parse("foo").source
+      assert_kind_of ASCIISource, Prism.parse("# encoding: binary\nfoo").source
+      refute_kind_of ASCIISource, Prism.parse("'\u00e9'").source
+      refute_kind_of ASCIISource, Prism.parse("# encoding: binary\n'\u00e9'").source
+
+      if !ENV["PRISM_BUILD_MINIMAL"]
+        source = "'\u00e9'"
+        assert_equal Prism.parse(source).source.class, Prism.load(source, Prism.dump(source)).source.class
+      end
+    end
+
+    def test_source_valid_encoding
+      assert_predicate Prism.parse("'\u00e9'").source.source, :valid_encoding?
+      refute_predicate Prism.parse("# \xff\nfoo").source.source, :valid_encoding?
+      refute_predicate Prism.parse("# \xed\xa0\x80\nfoo").source.source, :valid_encoding?
+      refute_predicate Prism.parse("# encoding: us-ascii\n# \xc3\xa9\nfoo").source.source, :valid_encoding?
+    end
+
     private
 
     def find_source_file_node(program)
@@ -0,0 +1,40 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+return unless Prism.respond_to?(:parser_stats)
+
+module Prism
+  class ParserStatsTest < TestCase
+    def test_parser_stats
+      stats = Prism.parser_stats("foo = 1\nfoo + foo\n")
+
+      assert_equal 3, stats[:tokens][:IDENTIFIER]
+      assert_equal 1, stats[:tokens][:EOF]
+      assert_operator stats[:constant_inserts], :>=, 3
+      assert_operator stats[:ast_arena_bytes], :>, 0
+      assert_equal 0, stats[:errors]
+      assert_equal 0, stats[:recoveries]
+      assert_operator stats[:lex_time], :<=, stats[:parse_time]
+    end
+
+    def test_parser_stats_heredocs
+      stats = Prism.parser_stats("<<~A + <<~B\n  a\nA\n  b\nB\n")
+
+      assert_equal 2, stats[:heredocs]
+      assert_operator stats[:lex_mode_pushes], :>=, 2
+    end
+
+    def test_parser_stats_errors
+      stats = Prism.parser_stats("1 +")
+
+      assert_operator stats[:errors], :>, 0
+      assert_equal 1, stats[:error_recovery_nodes]
+      assert_equal 1, stats[:recoveries]
+    end
+
+    def test_parser_stats_regexp
+      assert_equal 1, Prism.parser_stats("/foo/")[:regexp_validations]
+    end
+  end
+end
@@ -0,0 +1,66 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class ScanTest < TestCase
+    QUERIES = [
+      "CallNode",
+      "CallNode[receiver: nil, name: :foo]",
+      "CallNode[name: :+, receiver: IntegerNode, arguments: [IntegerNode]]",
+      "ConstantReadNode | IntegerNode",
+      "StatementsNode[body: [CallNode, CallNode]]",
+      "StringNode[unescaped: \"foo\"]",
+      "{ name: /^[[:punct:]]$/ }",
+      "{ locals: [:a] }",
+      "{ opening: \"(\" }",
+      "{ receiver: nil, block: Node }",
+      "[nil]"
+    ]
+
+    Fixture.each do |fixture|
+      define_method(fixture.test_name) { assert_scan(fixture.read) }
+    end
+
+    def test_scan_pattern
+      assert_equal %w[Foo Bar], Prism.scan("Foo + Bar + 1", Pattern.new("ConstantReadNode")).map(&:slice)
+    end
+
+    def test_scan_shares_nodes
+      calls = Prism.scan("foo(bar(baz))", "CallNode")
+
+      assert_equal %i[foo bar baz], calls.map(&:name)
+      assert_same calls[1], calls[0].arguments.arguments.first
+      assert_same calls[2], calls[1].arguments.arguments.first
+    end
+
+    def test_scan_non_ascii
+      assert_equal ["\"é\""], Prism.scan("\"é\"; \"e\"", "StringNode[unescaped: \"é\"]").map(&:slice)
+      assert_equal ["@é"], Prism.scan("@é; @e", "{ name: :@é }").map(&:slice)
+    end
+
+    def test_scan_freeze
+      result = Prism.scan("foo.bar", "CallNode[name: :bar]", freeze: true)
+
+      assert_predicate result, :frozen?
+      assert_predicate result.first, :frozen?
+    end
+
+    def test_scan_invalid
+      assert_raise(Pattern::CompilationError) { Prism.scan("", "Foo") }
+      assert_raise(Pattern::CompilationError) { Prism.scan("", "[*foo]") }
+      assert_raise(TypeError) { Prism.scan("", 1) }
+    end
+
+    private
+
+    def assert_scan(source)
+      root = Prism.parse(source).value
+
+      QUERIES.each do |query|
+        expected = Pattern.new(query).scan(root).map(&:node_id)
+        assert_equal expected, Prism.scan(source, query).map(&:node_id), query
+      end
+    end
+  end
+end
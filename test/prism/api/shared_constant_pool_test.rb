@@ -0,0 +1,47 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class SharedConstantPoolTest < TestCase
+    def test_shared_constant_pool
+      pool = SharedConstantPool.new([:foo, "bar", :foo])
+
+      assert_equal [:foo, :bar], pool.symbols
+      assert_equal 2, pool.size
+      assert_predicate pool, :frozen?
+    end
+
+    def test_parse
+      pool = SharedConstantPool.new(%i[foo bar each])
+
+      [
+        "foo = 1; bar = foo; baz = bar",
+        "[1, 2].each { |foo, qux| foo + qux }",
+        "def bar(foo, *, **, &) = qux(*, **, &)",
+        "é = 1; foo = é",
+        "# encoding: binary\nfoo = 1; bar = 2"
+      ].each do |source|
+        assert_equal Prism.parse(source).value.inspect, Prism.parse(source, constant_pool: pool).value.inspect
+      end
+    end
+
+    def test_parse_non_ascii
+      pool = SharedConstantPool.new(["é", :foo])
+
+      assert_equal [:é, :foo], Prism.parse("é = 1; foo = é", constant_pool: pool).value.locals
+      assert_equal ["\xC3\xA9".b.to_sym], Prism.parse("# encoding: binary\n\xC3\xA9 = 1", constant_pool: pool).value.locals
+    end
+
+    def test_dump
+      pool = SharedConstantPool.new(%i[foo bar])
+      source = "foo = 1; baz = foo"
+
+      assert_equal [:foo, :baz], Prism.load(source, Prism.dump(source, constant_pool: pool)).value.locals
+    end
+
+    def test_invalid
+      assert_raise(TypeError) { Prism.parse("", constant_pool: Object.new) }
+    end
+  end
+end
@@ -0,0 +1,61 @@
+# frozen_string_literal: true
+
+require_relative "test_helper"
+
+module Prism
+  # These tests exercise inputs that took time quadratic in their size to
+  # parse, most of them found by the complexity fuzzer. Each one parses a unit
+  # of source repeated at two sizes, and checks that the time spent per byte
+  # does not grow with the size of the input.
+  class ComplexityTest < TestCase
+    # The number of times the unit is repeated in the smaller input, unless a
+    # snippet asks for more to bring out a smaller quadratic term.
+    COUNT = 500
+
+    # How many times larger the larger input is than the smaller one.
+    SCALE = 8
+
+    # How many times higher the time per byte of the larger input may be than
+    # that of the smaller one. Quadratic inputs land well above this.
+    THRESHOLD = 3
+
+    # Define a test that repeats the given unit between the prefix and suffix.
+    # If a block is given, it is called with the index of each repetition to
+    # produce the unit instead.
+    def self.snippet(name, unit = nil, prefix: "", suffix: "", count: COUNT, &block)
+      block ||= ->(_) { unit }
+      define_method(:"test_complexity_#{name}") { assert_linear(prefix, suffix, count, &block) }
+    end
+
+    snippet "and chain", "a && "
+    snippet "or chain", "a || "
+    snippet "unary minus chain", "-"
+    snippet "not chain", "!"
+    snippet "lambda nesting", "->{"
+    snippet "brace lambda nesting", "-> {", suffix: "}"
+    snippet "block nesting", "a { "
+    snippet "it block nesting", "a { it; "
+    snippet "nested heredoc interpolation", "<<~A\n\#{<<~B}\n"
+    snippet("array pattern captures", prefix: "case a\nin [", suffix: "]\nend", count: 2000) { |index| "b#{index}, " }
+    snippet("hash pattern captures", prefix: "case a\nin {", suffix: "}\nend", count: 2000) { |index| "b#{index}:, " }
+    snippet("named capture groups", prefix: "/", suffix: "/ =~ a", count: 2000) { |index| "(?<b#{index}>.)" }
+
+    private
+
+    def assert_linear(prefix, suffix, count, &block)
+      small = "#{prefix}#{Array.new(count, &block).join}#{suffix}"
+      large = "#{prefix}#{Array.new(count * SCALE, &block).join}#{suffix}"
+
+      ratio = (measure(large) / large.bytesize) / (measure(small) / small.bytesize)
+      assert_operator ratio, :<, THRESHOLD
+    end
+
+    def measure(source)
+      Array.new(5) do
+        start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+        Prism.profile(source)
+        Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+      end.min
+    end
+  end
+end
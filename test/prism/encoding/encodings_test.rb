@@ -28,6 +28,30 @@ module Prism
       end
     end
 
+    # Identifiers with multibyte characters in them are validated in blocks of
+    # bytes, so check characters that cross from one block into the next.
+    def test_utf_8_long_identifiers
+      ["ユーザー名の一覧", "é" * 20, "😀_" * 10, "名前#{"_" * 15}名前"].each do |name|
+        (0..16).each do |offset|
+          identifier = "#{"a" * offset}#{name}"
+          assert_equal [identifier.to_sym], Prism.parse("#{identifier} = 1").value.locals
+        end
+      end
+    end
+
+    # An invalid byte ends the identifier at the last complete character before
+    # it, wherever it falls in the block.
+    def test_utf_8_long_identifiers_invalid
+      ["\xE3\x81", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xC0\x80", "\x80"].each do |invalid|
+        (0..16).each do |offset|
+          identifier = "#{"a" * offset}#{"名前" * 6}"
+          token, = Prism.lex("#{identifier}#{invalid}#{"b" * 16}".b.force_encoding(Encoding::UTF_8)).value.first
+
+          assert_equal [:IDENTIFIER, identifier], [token.type, token.value]
+        end
+      end
+    end
+
     private
 
     def assert_encoding_constant(name, character)
@@ -66,6 +66,26 @@ module Prism
         )
       end
 
+      # Runs of two-byte characters are skipped many bytes at a time, so check
+      # that trailing bytes that look like delimiters or escapes are still
+      # skipped when they fall in the middle of a long run.
+      def test_strpbrk_multibyte_run
+        {
+          "Shift_JIS" => "\x81\x5c\x81\x5d\x95\x7c\x83\x5b",
+          "EUC-JP" => "\xA4\xA2\xB4\xC1\xBB\xFA\xA1\xA3",
+          "GBK" => "\x81\x5c\x81\x5d\x95\x7c\xD6\xD0",
+          "Big5" => "\xA5\x5c\xB3\x5c\xA4\x5d\xA4\xA4"
+        }.each do |name, bytes|
+          content = bytes.dup.force_encoding(name) * 8
+          assert_predicate content, :valid_encoding?
+
+          result = Prism.parse("# encoding: #{name}\n%w[#{content.b}] + \"#{content.b}\"".b)
+
+          assert_empty result.errors
+          assert_equal [content, content], [result.statement.receiver.elements.first.unescaped, result.statement.arguments.arguments.first.unescaped]
+        end
+      end
+
       def test_slice_encoding
         slice = Prism.parse("# encoding: Shift_JIS\nア").value.slice
         assert_equal (+"ア").force_encoding(Encoding::SHIFT_JIS), slice
@@ -81,6 +81,18 @@ module Prism
       assert_magic_encoding(Encoding::Windows_31J, "# vim: filetype=ruby, fileencoding=windows-31j, tabsize=3, shiftwidth=3")
     end
 
+    # Comments are scanned in blocks of bytes for the characters that magic
+    # comments need, so move them across the blocks.
+    def test_padded
+      (0..40).each do |padding|
+        assert_magic_encoding(Encoding::US_ASCII, "##{" " * padding}encoding: ascii")
+        assert_magic_encoding(Encoding::US_ASCII, "##{" " * padding}-*- encoding: ascii -*-")
+
+        result = Prism.parse("x = 1##{" " * padding}frozen_string_literal: true\n# #{"a" * padding}\n")
+        assert_equal [["frozen_string_literal", "true"]], result.magic_comments.map { |comment| [comment.key, comment.value] }
+      end
+    end
+
     private
 
     def assert_magic_encoding(expected, line)
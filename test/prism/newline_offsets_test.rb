@@ -29,8 +29,33 @@ module Prism
       assert_newline_offsets_for("\"\\C-\r\n\"", "\\C- with \\r\\n")
     end
 
+    def test_line_offsets
+      sources = ["", "\n", "a", "a\n", "a\nb", "a\r\nb\r\n", "a\rb", "\r", "a\r\rb\n\r"]
+
+      [15, 16, 17, 31, 32, 33].each do |length|
+        sources << "\n" * length
+        sources << "#{"a" * (length - 1)}\n"
+        sources << "\n#{"a" * (length - 1)}"
+        sources << "#{"a" * (length - 2)}\r\n"
+        sources << "#{"a" * 15}\n#{"a" * [length - 16, 0].max}"
+        sources << "#{"a" * (length - 1)}\n#{"a" * length}\n"
+      end
+
+      # Large enough for the parser to count line feeds before it lexes.
+      sources << "a = 1\n" * 12_000 + "\r\nb"
+
+      sources.each { |source| assert_line_offsets_for(source) }
+    end
+
     private
 
+    def assert_line_offsets_for(source)
+      expected = Prism.parse(source).source.offsets
+
+      assert_equal expected.length - 1, Source.send(:newline_count, source), source.inspect
+      assert_equal expected, Source.send(:line_offsets, source).unpack("L*"), source.inspect
+    end
+
     def assert_newline_offsets(fixture)
       assert_newline_offsets_for(fixture.read)
     end
@@ -40,7 +40,7 @@ module Prism
       source = File.read(filepath, binmode: true, external_encoding: Encoding::UTF_8)
       expected = rubyvm_lines(source)
 
-      result = Prism.parse_file(filepath)
+      result = Prism.parse_file(filepath, mark_newlines: true)
       assert_empty result.errors
       actual = prism_lines(result)
 
@@ -87,14 +87,12 @@ module Prism
     end
 
     def prism_lines(result)
-      result.mark_newlines!
-
       queue = [result.value]
       newlines = []
 
       while node = queue.shift
         queue.concat(node.compact_child_nodes)
-        newlines << result.source.line(node.location.start_offset) if node&.newline_flag?
+        newlines << result.source.line(node.location.start_offset) if node&.newline?
       end
 
       newlines.sort
@@ -0,0 +1,76 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class AttachCommentsTest < TestCase
+    Fixture.each do |fixture|
+      define_method(fixture.test_name) { assert_attach_comments(fixture.read) }
+    end
+
+    def test_comment_attachments
+      result = Prism.parse("# leading\nfoo # trailing\n", attach_comments: true)
+      node = result.value.statements.body.first
+
+      assert_equal [node.node_id, 0, 0, node.node_id, 0, 1], result.comment_attachments
+      assert_nil Prism.parse("# comment\n").comment_attachments
+    end
+
+    if !ENV["PRISM_BUILD_MINIMAL"]
+      def test_comment_attachments_dump
+        source = "# leading\nfoo # trailing\n"
+        result = Prism.load(source, Prism.dump(source, attach_comments: true))
+
+        assert_equal Prism.parse(source, attach_comments: true).comment_attachments, result.comment_attachments
+      end
+    end
+
+    def test_comment_attachments_location
+      result = Prism.parse("def foo # comment\nend\n", attach_comments: true)
+      node = result.value.statements.body.first
+      result.attach_comments!
+
+      assert_equal ["# comment"], node.name_loc.trailing_comments.map { |comment| comment.location.slice }
+    end
+
+    def test_comment_attachments_freeze
+      result = Prism.parse("foo # comment\n", attach_comments: true, freeze: true)
+      assert_predicate result.comment_attachments, :frozen?
+    end
+
+    private
+
+    def assert_attach_comments(source)
+      expected = Prism.parse(source)
+      actual = Prism.parse(source, attach_comments: true)
+
+      assert_equal expected.comments.length * 3, actual.comment_attachments&.length || 0
+
+      expected.attach_comments!
+      actual.attach_comments!
+
+      assert_equal attached_comments(expected), attached_comments(actual)
+    end
+
+    def attached_comments(result)
+      queue = [result.value]
+      attached = []
+
+      while (node = queue.shift)
+        attached << [node.node_id, 0, *comment_offsets(node.location)]
+
+        node.comment_targets.each_with_index do |target, index|
+          attached << [node.node_id, index + 1, *comment_offsets(target)] if target.is_a?(Location)
+        end
+
+        queue.concat(node.compact_child_nodes)
+      end
+
+      attached
+    end
+
+    def comment_offsets(location)
+      [location.leading_comments.map { |comment| comment.location.start_offset }, location.trailing_comments.map { |comment| comment.location.start_offset }]
+    end
+  end
+end
@@ -30,6 +30,14 @@ module Prism
       assert_integer_parse(num, "0o#{num.to_s(8)}")
       assert_integer_parse(num, "0d#{num.to_s(10)}")
       assert_integer_parse(num, "0x#{num.to_s(16)}")
+
+      num = 7 ** 20000
+      assert_integer_parse(num)
+      assert_integer_parse(-num, "-#{num}")
+      assert_integer_parse(num, "0b#{num.to_s(2)}")
+      assert_integer_parse(num, "0x#{num.to_s(16)}")
+      assert_integer_parse(10 ** 20000)
+      assert_integer_parse(2 ** 66432)
     end
 
     private
@@ -0,0 +1,40 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Prism
+  class MarkNewlinesTest < TestCase
+    def test_mark_newlines_block
+      result = Prism.parse("foo; bar { baz }\n", mark_newlines: true)
+      call = result.value.statements.body.last
+      block_statement = call.block.body.body.first
+
+      assert_predicate result.value.statements.body.first, :newline?
+      refute_predicate call, :newline?
+      assert_predicate block_statement, :newline?
+    end
+
+    if !ENV["PRISM_BUILD_MINIMAL"]
+      def test_mark_newlines_dump
+        source = "foo; bar\nif baz then qux end\n"
+        expected = newlines(Prism.parse(source, mark_newlines: true).value)
+
+        assert_equal expected, newlines(Prism.load(source, Prism.dump(source, mark_newlines: true)).value)
+      end
+    end
+
+    private
+
+    def newlines(node)
+      queue = [node]
+      node_ids = []
+
+      while (node = queue.shift)
+        queue.concat(node.compact_child_nodes)
+        node_ids << node.node_id if node.newline?
+      end
+
+      node_ids
+    end
+  end
+end
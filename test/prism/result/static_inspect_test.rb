@@ -30,6 +30,7 @@ module Prism
     def test_integer
       assert_equal "1000", static_inspect("1_0_0_0")
       assert_equal "10000000000000000000000000000", static_inspect("1_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0_0")
+      assert_equal (7 ** 20000).to_s, static_inspect("0x#{(7 ** 20000).to_s(16)}")
     end
 
     def test_nil
@@ -19,6 +19,21 @@ module Prism
       assert_predicate node.unescaped, :frozen?
     end
 
+    def test_string_node_unescaped_interned
+      source = "# frozen_string_literal: true\n[\"foo\", 'foo', \"f\\x6fo\", \"\", '']"
+
+      [Prism.parse(source), Prism.load(source, Prism.dump(source, source_strings: true))].each do |result|
+        foo1, foo2, foo3, empty1, empty2 = result.value.statements.body.first.elements.map(&:unescaped)
+
+        assert_same foo1, foo2
+        assert_same foo1, foo3
+        assert_same empty1, empty2
+      end
+
+      foo1, foo2 = Prism.parse_statement("[\"foo\", \"foo\"]").elements.map(&:unescaped)
+      refute_same foo1, foo2
+    end
+
     def test_symbol_node_unescaped_frozen
       node = Prism.parse_statement(":foo")
       assert_predicate node.unescaped, :frozen?
@@ -51,5 +51,52 @@ module Prism
         assert_equal([:on_call_node_enter, :on_call_node_leave], listener.events_received)
       end
     end
+
+    def test_dispatching_source
+      listener = TestListener.new
+      dispatcher = Dispatcher.new
+      dispatcher.register_public_methods(listener)
+
+      dispatcher.dispatch_source(<<~RUBY)
+        def foo
+          something(1, 2, 3)
+        end
+      RUBY
+
+      assert_equal([:on_call_node_enter, :on_integer_node_enter, :on_integer_node_enter, :on_integer_node_enter, :on_call_node_leave], listener.events_received)
+    end
+
+    def test_dispatching_source_nodes
+      source = "foo(bar(1), baz { 2 })"
+      expected = NodeListener.new
+      actual = NodeListener.new
+
+      dispatcher = Dispatcher.new
+      dispatcher.register(expected, :on_call_node_enter, :on_integer_node_leave)
+      dispatcher.dispatch(Prism.parse(source).value)
+
+      dispatcher = Dispatcher.new
+      dispatcher.register(actual, :on_call_node_enter, :on_integer_node_leave)
+      dispatcher.dispatch_source(source)
+
+      assert_equal expected.nodes.map(&:node_id), actual.nodes.map(&:node_id)
+      assert_same actual.nodes[1], actual.nodes[0].arguments.arguments.first
+    end
+
+    class NodeListener
+      attr_reader :nodes
+
+      def initialize
+        @nodes = []
+      end
+
+      def on_call_node_enter(node)
+        nodes << node
+      end
+
+      def on_integer_node_leave(node)
+        nodes << node
+      end
+    end
   end
 end
@@ -47,5 +47,58 @@ module Prism
       error = assert_raise(ArgumentError) { source.byte_offset(9, 0) }
       assert_equal "line 9 is out of range", error.message
     end
+
+    def test_line_lookup
+      [false, true].each do |freeze|
+        source = Prism.parse("ab\ncd\n\nef", freeze: freeze).source
+
+        assert_equal [1, 1, 1, 2, 2, 2, 3, 4, 4, 4], (0..9).map { |offset| source.line(offset) }
+        assert_equal [0, 0, 0, 3, 3, 3, 6, 7, 7, 7], (0..9).map { |offset| source.line_start(offset) }
+        assert_equal [3, 3, 3, 6, 6, 6, 7, 9, 9, 9], (0..9).map { |offset| source.line_end(offset) }
+        assert_equal [0, 1, 2, 0, 1, 2, 0, 0, 1, 2], (0..9).map { |offset| source.column(offset) }
+        assert_equal [0, 3, 6, 7], source.offsets
+      end
+    end
+
+    def test_character_offsets
+      assert_equal [0, 1, 1, 2, 3, 3, 3, 3, 4], Source.character_offsets("aé\n😀")
+      assert_equal [0, 1, 2, 2, 3], Source.character_offsets("a\xFF\xC3\xA9")
+      assert_equal [0], Source.character_offsets("")
+    end
+
+    def test_line_column
+      source = Prism.parse("ab\ncd\n\nef").source
+      assert_equal [(1 << 32) | 2, (3 << 32) | 1], [source.line_column(5), source.line_column(8)]
+
+      # Once the offsets are unpacked, callers search them instead.
+      source.offsets
+      assert_nil source.line_column(5)
+    end
+
+    def test_packed_offsets
+      return if BACKEND != :CEXT
+
+      assert_raise(ArgumentError) { Source.find_line("\0\0\0", 0) }
+      assert_raise(ArgumentError) { Source.line_offset([0, 3].pack("L*") + "\0", 1) }
+      assert_raise(ArgumentError) { Source.code_units_table("ab\ncd", "\0" * 5, nil) }
+    end
+
+    def test_code_units
+      [false, true].each do |freeze|
+        source = Prism.parse("\"é\"\n\"😀\" + 1", freeze: freeze).source
+        offset = "\"é\"\n\"😀\"".bytesize
+
+        assert_equal 7, source.character_offset(offset)
+        assert_equal 3, source.character_column(offset)
+        assert_equal 8, source.code_units_offset(offset, Encoding::UTF_16LE)
+        assert_equal 4, source.code_units_column(offset, Encoding::UTF_16LE)
+        assert_equal 7, source.code_units_offset(offset, Encoding::UTF_32LE)
+        assert_equal 8, source.code_units_cache(Encoding::UTF_16LE)[offset]
+
+        # Offsets that do not fall on a character boundary fall back to
+        # transcoding with replacement characters.
+        assert_equal 6, source.code_units_offset(offset - 2, Encoding::UTF_16LE)
+      end
+    end
   end
 end